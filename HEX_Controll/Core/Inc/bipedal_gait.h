@@ -20,6 +20,9 @@
  *   3●────●6    ← Para 1,2
  * ```
  *
+ * Pary wyznaczane z liczby nóg (robot_description.h): para p to nogi
+ * p+1 i p+1+N/2, stance shift = step_length / (N/2).
+ *
  * **Sekwencja ruchu (2-fazowa):**
  * 1. **SWING Phase**: Para X robi krok (obecna pozycja → pozycja przednia)
  * 2. **STANCE SHIFT Phase**: WSZYSTKIE nogi przesuwają się o 1/3 step_length do tyłu
@@ -195,6 +198,18 @@ typedef struct
     float step_height_base;    ///< Bazowa wysokość stania [cm] - pozycja Z w stance
 } BipedalConfig_t;
 
+/**
+ * @brief Konfiguracja w RAM (wartości domyślne, zmieniana przez setBipedalConfig())
+ */
+extern BipedalConfig_t bipedal_config;
+
+/**
+ * @brief Konfiguracja używana przez chód (RAM lub rekord z config_store)
+ *
+ * setBipedalConfig() kopiuje aktywne wartości do RAM i przełącza wskaźnik na kopię.
+ */
+extern const BipedalConfig_t *bipedal_cfg;
+
 /** @} */ // end of Bipedal_Types
 
 /**
@@ -458,16 +473,16 @@ void printBipedalConfig(void);
  * typedef struct {
  *     uint8_t base_channel;  // Bazowy kanał PCA9685 (0, 3, 6)
  *     float hip_offset_deg;  // Offset biodra z URDF [stopnie]
- *     bool is_left_side;     // true = I2C1, false = I2C2
+ *     uint8_t device;        // Kontroler servo_bus: 0 = I2C1, 1 = I2C2
  * } LegMapping_t;
  *
  * static const LegMapping_t leg_mapping[6] = {
- *     {0, 37.5f, true},   // Noga 1: I2C1[0-2], +37.5°
- *     {0, -37.5f, false}, // Noga 2: I2C2[0-2], -37.5°
- *     {3, 0.0f, true},    // Noga 3: I2C1[3-5], 0°
- *     {3, 0.0f, false},   // Noga 4: I2C2[3-5], 0°
- *     {6, -37.5f, true},  // Noga 5: I2C1[6-8], -37.5°
- *     {6, 37.5f, false}   // Noga 6: I2C2[6-8], +37.5°
+ *     {0, 37.5f, 0},  // Noga 1: I2C1[0-2], +37.5°
+ *     {0, -37.5f, 1}, // Noga 2: I2C2[0-2], -37.5°
+ *     {3, 0.0f, 0},   // Noga 3: I2C1[3-5], 0°
+ *     {3, 0.0f, 1},   // Noga 4: I2C2[3-5], 0°
+ *     {6, -37.5f, 0}, // Noga 5: I2C1[6-8], -37.5°
+ *     {6, 37.5f, 1}   // Noga 6: I2C2[6-8], +37.5°
  * };
  * ```
  *
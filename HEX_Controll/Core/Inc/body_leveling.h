@@ -0,0 +1,103 @@
+/**
+ * @file body_leveling.h
+ * @brief Poziomowanie korpusu na podstawie czujnika inercyjnego
+ *
+ * @details
+ * Pętla o stałej częstotliwości (body_leveling_config.period_ms, domyślnie
+ * 100 Hz), wywoływana między ramkami chodu przez control_frame.c:
+ *
+ * 1. **Estymacja** - filtr komplementarny: kąt z akcelerometru
+ *    (wolny, bez dryftu) + całka z żyroskopu (szybka):
+ *    ```
+ *    roll_acc  = atan2(ax, az)              // > 0 = lewa strona wyżej
+ *    pitch_acc = atan2(ay, sqrt(ax² + az²)) // > 0 = tył wyżej
+ *    est = a * (est + rate * dt) + (1 - a) * acc,  a = τ / (τ + dt)
+ *    ```
+ * 2. **Regulator PI** - korekta u rośnie, dopóki korpus jest przechylony:
+ *    `u = kp * est + ki * ∫est dt`, ograniczona do ±max_tilt_deg
+ *    (anti-windup przez obcięcie całki).
+ * 3. **Korekta pozy** - bodyLevelingApply() obraca zadane pozycje stóp
+ *    wokół środka korpusu o u. Stopy po stronie uniesionej idą w górę
+ *    względem korpusu, więc korpus opada do poziomu:
+ *    ```
+ *    z' = z·cos(u_roll) + x·sin(u_roll),   x' = x·cos(u_roll) - z·sin(u_roll)
+ *    z''= z'·cos(u_pitch) + y·sin(u_pitch), y' = y·cos(u_pitch) - z'·sin(u_pitch)
+ *    ```
+ *
+ * Moduł nie zależy od HAL - działa na hoście ze źródłem imuSimRead().
+ */
+
+#ifndef BODY_LEVELING_H
+#define BODY_LEVELING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "imu.h"
+
+/**
+ * @brief Parametry pętli poziomowania
+ */
+typedef struct
+{
+    uint32_t period_ms; ///< Okres pętli [ms] (10 = 100 Hz, zgodnie z próbkowaniem MPU-6050)
+    float filter_tau_s; ///< Stała czasowa filtru komplementarnego [s]
+    float kp;           ///< Wzmocnienie proporcjonalne [°/°]
+    float ki;           ///< Wzmocnienie całkujące [1/s]
+    float max_tilt_deg; ///< Maksymalna korekta [°] - ogranicza zasięg IK
+} BodyLevelingConfig_t;
+
+/**
+ * @brief Stan pętli (do raportu)
+ */
+typedef struct
+{
+    bool enabled;         ///< Korekta stosowana do pozycji stóp
+    float roll_deg;       ///< Estymowany przechył (lewa strona wyżej > 0)
+    float pitch_deg;      ///< Estymowane pochylenie (tył wyżej > 0)
+    float corr_roll_deg;  ///< Bieżąca korekta przechyłu
+    float corr_pitch_deg; ///< Bieżąca korekta pochylenia
+} BodyLevelingState_t;
+
+/**
+ * @brief Aktywna konfiguracja (zmieniana w runtime)
+ */
+extern BodyLevelingConfig_t body_leveling_config;
+
+/**
+ * @brief Wyzeruj estymatę, całki i korektę
+ */
+void bodyLevelingReset(void);
+
+/**
+ * @brief Włącz/wyłącz korektę (wyłączenie zeruje stan)
+ */
+void bodyLevelingEnable(bool enable);
+
+/**
+ * @brief Czy korekta jest włączona
+ */
+bool bodyLevelingEnabled(void);
+
+/**
+ * @brief Jeden krok pętli: estymacja + regulator
+ *
+ * @param[in] sample Próbka czujnika
+ * @param[in] dt Czas od poprzedniego kroku [s]
+ */
+void bodyLevelingUpdate(const ImuSample_t *sample, float dt);
+
+/**
+ * @brief Obróć zadaną pozycję stopy o bieżącą korektę
+ *
+ * Bez zmian, gdy poziomowanie wyłączone.
+ *
+ * @param[in,out] x, y, z Pozycja stopy w układzie korpusu [cm]
+ */
+void bodyLevelingApply(float *x, float *y, float *z);
+
+/**
+ * @brief Odczytaj stan pętli
+ */
+void bodyLevelingGetState(BodyLevelingState_t *state);
+
+#endif // BODY_LEVELING_H
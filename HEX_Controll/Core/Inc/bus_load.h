@@ -0,0 +1,123 @@
+/**
+ * @file bus_load.h
+ * @brief Obciążenie magistral I2C w każdej fazie chodu dla danego okablowania nóg
+ *
+ * @details
+ * Podział lewe nogi = I2C1, prawe = I2C2 daje nierówne magistrale
+ * w fazach, na których zależy: w fazie A tripodu (swing 1, 4, 5) stance
+ * to 3 na I2C1 i 2, 6 na I2C2 - w dodatku 2 i 6 na kanałach 0 i 6,
+ * czyli dwie transakcje zamiast jednej. Okablowanie (LegMapping_t::device
+ * i base_channel w leg_config) jest konfigurowalne; ten moduł liczy, ile
+ * kosztuje wybrane:
+ *
+ * ```
+ * faza chodu -> nogi swing (tripod: grupa, bipedal: para, wave: noga)
+ *   swing:  zapis od razu, noga po nodze - swing_us (niezależne od magistral)
+ *   stance: servoBusFlushFrame() - na każdym kontrolerze ciągłe serie
+ *           kanałów = transakcje, magistrale równolegle
+ *           bus_us[b] = suma transakcji kontrolerów magistrali b
+ *           flush_us  = max(bus_us) - najwolniejsza magistrala
+ * ```
+ * Koszt transakcji: (adres + rejestr + 4 B na kanał) x 9 bitów przy
+ * BUS_LOAD_SCL_HZ + BUS_LOAD_TX_OVERHEAD_US obsługi (start, przerwania).
+ * Model do porównywania okablowań - zmierzone czasy: `bus` (servo_bus.h).
+ *
+ * Najlepsze okablowanie szuka Tools/bus_balance (przegląd wszystkich
+ * przypisań nóg do kontrolerów i kanałów), w firmware `bus load` liczy
+ * aktywne *leg_config, `bus wire` zmienia przypisanie nogi i zapisuje.
+ *
+ * Moduł nie zależy od HAL - używają go też narzędzia hosta (Tools/).
+ */
+
+#ifndef BUS_LOAD_H
+#define BUS_LOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "robot_description.h"
+#include "leg_config.h"
+
+/**
+ * @brief Parametry modelu czasu transakcji
+ */
+///@{
+#define BUS_LOAD_SCL_HZ 400000U        ///< Zegar I2C (hi2cx.Init.ClockSpeed)
+#define BUS_LOAD_TX_OVERHEAD_US 15U    ///< Start transakcji i przerwania [us]
+#define BUS_LOAD_MAX_BUSES LEG_CONFIG_MAX_DEVICES
+///@}
+
+/**
+ * @brief Chody z fazami swing
+ */
+typedef enum
+{
+    BUS_LOAD_TRIPOD = 0, ///< 2 fazy: grupa A, grupa B
+    BUS_LOAD_BIPEDAL,    ///< N/2 faz: para (i, i + N/2)
+    BUS_LOAD_WAVE,       ///< N faz: jedna noga
+    BUS_LOAD_GAITS
+} BusLoadGait_t;
+
+/**
+ * @brief Obciążenie w jednej fazie
+ */
+typedef struct
+{
+    LegMask_t swing;                              ///< Nogi swing
+    uint8_t swing_legs[BUS_LOAD_MAX_BUSES];       ///< Nogi swing na magistrali
+    uint8_t transactions[BUS_LOAD_MAX_BUSES];     ///< Transakcje stance w flush
+    uint32_t bus_us[BUS_LOAD_MAX_BUSES];          ///< Zajętość magistrali w flush [us]
+    uint32_t swing_us;                            ///< Zapisy swing po kolei [us]
+    uint32_t flush_us;                            ///< Najwolniejsza magistrala [us]
+} BusLoadPhase_t;
+
+/**
+ * @brief Obciążenie we wszystkich fazach chodu
+ */
+typedef struct
+{
+    BusLoadGait_t gait;
+    uint8_t buses;                        ///< Magistrale w użyciu (najwyższy indeks + 1)
+    uint8_t phases;
+    BusLoadPhase_t phase[HEX_LEG_COUNT];
+    uint32_t worst_flush_us;              ///< Najgorsza faza - wyznacza ramkę
+    uint32_t sum_flush_us;                ///< Suma po fazach (rozstrzyga remisy)
+} BusLoadResult_t;
+
+/**
+ * @brief Nazwy chodów (tripod, bipedal, wave)
+ */
+extern const char *const bus_load_gait_names[BUS_LOAD_GAITS];
+
+/**
+ * @brief Liczba faz chodu
+ */
+uint8_t busLoadPhaseCount(BusLoadGait_t gait);
+
+/**
+ * @brief Nogi swing w fazie (jak w tripod_gait.c, bipedal_gait.c, wave_gait.c)
+ */
+LegMask_t busLoadSwingLegs(BusLoadGait_t gait, uint8_t phase);
+
+/**
+ * @brief Czas jednej transakcji @p channels kanałów [us]
+ */
+uint32_t busLoadTransactionUs(uint8_t channels);
+
+/**
+ * @brief Policz obciążenie magistral we wszystkich fazach chodu
+ *
+ * @param[in] config Okablowanie nóg
+ * @param[in] device_bus Magistrala każdego kontrolera (LEG_CONFIG_MAX_DEVICES
+ *                       pozycji), NULL = kontroler d na magistrali d
+ * @param[in] gait Chód
+ * @param[out] result Wynik
+ */
+void busLoadAnalyse(const LegConfig_t *config, const uint8_t *device_bus, BusLoadGait_t gait,
+                    BusLoadResult_t *result);
+
+/**
+ * @brief Wypisz tabelę faz (`bus load`, Tools/bus_balance)
+ */
+void busLoadPrint(const BusLoadResult_t *result);
+
+#endif // BUS_LOAD_H
@@ -0,0 +1,102 @@
+/**
+ * @file cadence_tune.h
+ * @brief Dobór kadencji tripodu na robocie (czas fazy i punkty interpolacji)
+ *
+ * @details
+ * Za krótki swing_duration_ms albo za dużo punktów na fazę - ramki nie
+ * mieszczą się w okresie; za ostrożne wartości - robot chodzi wolniej,
+ * niż może. Autotuner przechodzi krótki wzorzec (cykle do przodu,
+ * potem tyle samo do tyłu - robot wraca w miejsce startu) dla kolejnych,
+ * coraz szybszych kadencji:
+ *
+ * ```
+ * czas fazy: start_phase_ms, -step_ms, ... do min_phase_ms
+ *   punkty:  points_max, -points_step, ... do points_min
+ *     próba: przekroczenia terminu == 0 && błędy magistrali == 0 -> OK
+ * ```
+ *
+ * Dla każdego czasu fazy brane są możliwie najliczniejsze punkty (płynność),
+ * które zdają próbę. Gdy żadna liczba punktów nie zdaje, szybsze czasy też
+ * nie zdadzą - przeszukiwanie kończy się, wynikiem jest ostatnia zdana próba.
+ *
+ * **Kryteria (z control_frame.h i metrics.h):**
+ * - przekroczenia terminu ramki (ControlFrameStats_t::deadline_misses),
+ * - przyrost servo_bus_err (nieudane zapisy PWM).
+ * ik_fail nie jest kryterium - zależy od toru, nie od kadencji.
+ *
+ * Wynik trafia do konfiguracji tripodu (setTripodConfig()), opcjonalnie
+ * do flash (configParamsSave(CONFIG_TYPE_TRIPOD)). Strojenie włącza
+ * kadencję z konfiguracji (tripodSetPaced()); zapisany wynik działa po
+ * restarcie tylko w buildzie z HEX_TRIPOD_PACED=1.
+ *
+ * **Kompilacja:**
+ * HEX_CADENCE_TUNE=1 uruchamia strojenie w main.c po inicjalizacji
+ * (HEX_CADENCE_TUNE_SAVE=1 - zapis wyniku). Przy 0 moduł jest pusty.
+ *
+ * @warning Robot chodzi podczas strojenia - potrzebuje ~1 m wolnego
+ *          miejsca przed sobą i pozycji stojącej na starcie.
+ */
+
+#ifndef CADENCE_TUNE_H
+#define CADENCE_TUNE_H
+
+#include "pca9685.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef HEX_CADENCE_TUNE
+#define HEX_CADENCE_TUNE 0
+#endif
+
+#ifndef HEX_CADENCE_TUNE_SAVE
+#define HEX_CADENCE_TUNE_SAVE 0
+#endif
+
+/**
+ * @brief Zakres przeszukiwania
+ */
+typedef struct
+{
+    uint32_t start_phase_ms; ///< Pierwszy (najwolniejszy) czas fazy
+    uint32_t min_phase_ms;   ///< Najkrótszy sprawdzany czas fazy
+    uint32_t step_ms;        ///< Skrócenie fazy na krok
+    uint8_t points_max;      ///< Najwięcej punktów na fazę
+    uint8_t points_min;      ///< Najmniej punktów na fazę (płynność)
+    uint8_t points_step;     ///< Zmniejszenie liczby punktów na próbę
+    uint8_t cycles;          ///< Cykle próby w każdą stronę
+    bool quiet;              ///< Próby bez linii kątów w ramce (tripodSetVerbose(false))
+} CadenceTuneConfig_t;
+
+/**
+ * @brief Wynik strojenia
+ */
+typedef struct
+{
+    bool found;            ///< Co najmniej jedna próba zdana
+    uint32_t phase_ms;     ///< Najkrótszy zdany czas fazy
+    int points;            ///< Punkty na fazę dla phase_ms
+    uint32_t frame_us_max; ///< Najdłuższa ramka w zdanej próbie
+    uint8_t trials;        ///< Liczba prób
+    bool saved;            ///< Zapisano do flash
+} CadenceTuneResult_t;
+
+extern CadenceTuneConfig_t cadence_tune_config;
+
+/**
+ * @brief Przeprowadź strojenie i ustaw wynik w konfiguracji tripodu
+ *
+ * Bez zdanej próby konfiguracja i tripodSetPaced() wracają do stanu
+ * sprzed strojenia.
+ * Przy quiet = true i znalezionym wyniku wypisywanie kątów zostaje
+ * wyłączone - kadencja jest zmierzona bez niego.
+ *
+ * @param[in] pca1 PCA9685 lewej strony (I2C1)
+ * @param[in] pca2 PCA9685 prawej strony (I2C2)
+ * @param[in] persist Zapisz wynik do flash
+ * @param[out] result Wynik (może być NULL)
+ * @return true gdy znaleziono kadencję
+ */
+bool cadenceTuneRun(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool persist,
+                    CadenceTuneResult_t *result);
+
+#endif // CADENCE_TUNE_H
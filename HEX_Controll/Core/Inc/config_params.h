@@ -0,0 +1,77 @@
+/**
+ * @file config_params.h
+ * @brief Podpięcie rekordów config_store pod parametry robota
+ *
+ * @details
+ * Każdy strojony parametr ma wskaźnik `const T *`, z którego czyta kod:
+ *
+ * | Typ rekordu                | Wskaźnik        | Struktura        |
+ * |----------------------------|-----------------|------------------|
+ * | CONFIG_TYPE_GEOMETRY       | robot_geometry  | RobotGeometry_t  |
+ * | CONFIG_TYPE_LEG_CONFIG     | leg_config      | LegConfig_t      |
+ * | CONFIG_TYPE_TRIPOD         | tripod_cfg      | TripodConfig_t   |
+ * | CONFIG_TYPE_BIPEDAL        | bipedal_cfg     | BipedalConfig_t  |
+ * | CONFIG_TYPE_WAVE           | wave_cfg        | WaveConfig_t     |
+ *
+ * configParamsLoad() przy starcie przestawia wskaźnik na dane rekordu we
+ * flash, jeśli wersja i rozmiar zgadzają się z bieżącą strukturą -
+ * bez parsowania i kopiowania. W przeciwnym razie zostają wartości
+ * domyślne skompilowane w programie. Wyjątek: geometria jest kopiowana
+ * do robot_geometry_default w SRAM (gorąca ścieżka IK, hot_path.h).
+ *
+ * @warning Zapis może wywołać kompaktowanie magazynu (rekordy zmieniają
+ *          adres), dlatego configParamsSave() ponownie podpina wszystkie
+ *          wskaźniki. Nie trzymać własnych kopii tych wskaźników.
+ */
+
+#ifndef CONFIG_PARAMS_H
+#define CONFIG_PARAMS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Typy rekordów w config_store (wartości zapisane we flash - nie zmieniać)
+ */
+typedef enum
+{
+    CONFIG_TYPE_GEOMETRY = 1,   ///< RobotGeometry_t
+    CONFIG_TYPE_LEG_CONFIG = 2, ///< LegConfig_t (mapowanie, offsety, PWM)
+    CONFIG_TYPE_TRIPOD = 3,     ///< TripodConfig_t
+    CONFIG_TYPE_BIPEDAL = 4,    ///< BipedalConfig_t
+    CONFIG_TYPE_WAVE = 5        ///< WaveConfig_t
+} ConfigType_t;
+
+/**
+ * @brief Wersje układu struktur chodów (geometria i nogi mają własne)
+ */
+///@{
+#define TRIPOD_CONFIG_VERSION 1
+#define BIPEDAL_CONFIG_VERSION 1
+#define WAVE_CONFIG_VERSION 1
+///@}
+
+/**
+ * @brief Podepnij rekordy z magazynu i wypisz podsumowanie
+ *
+ * Wymaga wcześniejszego configStoreInit(). Wołać przed pierwszym użyciem
+ * IK i chodów.
+ */
+void configParamsLoad(void);
+
+/**
+ * @brief Zapisz parametr do magazynu i podepnij go
+ *
+ * @param[in] type Typ rekordu
+ * @param[in] data Nowe wartości lub NULL = bieżące wartości (*wskaźnik)
+ *
+ * @return true Zapisano i wskaźnik wskazuje na nowy rekord
+ */
+bool configParamsSave(ConfigType_t type, const void *data);
+
+/**
+ * @brief Usuń zapisany parametr - powrót do wartości domyślnych
+ */
+bool configParamsReset(ConfigType_t type);
+
+#endif // CONFIG_PARAMS_H
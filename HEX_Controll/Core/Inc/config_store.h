@@ -0,0 +1,126 @@
+/**
+ * @file config_store.h
+ * @brief Trwały magazyn rekordów konfiguracji we flash (wear levelling, CRC)
+ *
+ * @details
+ * Dwa sektory po 128 KB na końcu flash (sektor 6: 0x08040000,
+ * sektor 7: 0x08060000) pracują jako dziennik z podwójnym buforowaniem:
+ *
+ * ```
+ * sektor aktywny:  [nagłówek sektora][rekord][rekord][rekord]...[0xFF...]
+ *                                                                ^ zapis tutaj
+ * rekord:          [length][type|version][seq][crc32][magic][dane, wyrównane do 4]
+ * ```
+ *
+ * - **Zapis** dopisuje nowy rekord na koniec - stara wersja zostaje,
+ *   obowiązuje rekord danego typu o najwyższym seq. Sektor kasowany jest
+ *   dopiero, gdy się zapełni, więc każdy zapis nie oznacza kasowania.
+ * - **Kompaktowanie**: gdy brak miejsca, najnowsze rekordy każdego typu
+ *   są kopiowane do drugiego sektora, który staje się aktywny (wyższa
+ *   generacja w nagłówku). Sektory zużywają się naprzemiennie.
+ * - **Odporność na zanik zasilania**: słowo magic rekordu i nagłówka
+ *   sektora programowane jest na końcu. Rekord bez magic lub ze złym CRC
+ *   jest pomijany, obowiązuje poprzednia wersja.
+ *
+ * **Odczyt bez kopiowania:**
+ * configStoreInit() raz przegląda aktywny sektor i sprawdza CRC.
+ * configStoreFind() zwraca wskaźnik bezpośrednio do danych we flash -
+ * moduły trzymają `const T *` i czytają konfigurację w miejscu.
+ *
+ * @warning F446 ma jeden bank flash - podczas programowania i kasowania
+ *          (do ~2 s na sektor 128 KB) CPU stoi przy każdym pobraniu
+ *          instrukcji z flash. Zapisywać tylko poza chodem.
+ *
+ * @note Obszar jest wyłączony z regionu FLASH w STM32F446XX_FLASH.ld
+ *       (kod ma do dyspozycji 256 KB).
+ */
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Adresy i sektory magazynu (zgodne z regionem CONFIG w linker script)
+ */
+///@{
+#define CONFIG_STORE_ADDR_A 0x08040000U  ///< Sektor 6
+#define CONFIG_STORE_ADDR_B 0x08060000U  ///< Sektor 7
+#define CONFIG_STORE_SECTOR_SIZE 0x20000U ///< 128 KB
+///@}
+
+/**
+ * @brief Maksymalna liczba typów rekordów (indeks w RAM: 4 B na typ)
+ */
+#define CONFIG_STORE_MAX_TYPES 16
+
+/**
+ * @brief Nagłówek rekordu (20 bajtów, dane zaczynają się zaraz za nim)
+ */
+typedef struct
+{
+    uint32_t length;  ///< Długość danych [B] (0 = usunięcie typu)
+    uint16_t type;    ///< Typ rekordu (1..CONFIG_STORE_MAX_TYPES-1)
+    uint16_t version; ///< Wersja układu danych - zmiana struktury = nowa wersja
+    uint32_t seq;     ///< Numer kolejny zapisu (rośnie globalnie)
+    uint32_t crc32;   ///< CRC-32 pól length/type/version/seq + danych
+    uint32_t magic;   ///< CONFIG_RECORD_MAGIC - programowane na końcu
+} ConfigRecordHeader_t;
+
+/**
+ * @brief Statystyki magazynu (do raportu i diagnostyki zużycia)
+ */
+typedef struct
+{
+    uint32_t active_addr; ///< Adres aktywnego sektora
+    uint32_t generation;  ///< Generacja aktywnego sektora
+    uint32_t erase_count; ///< Ile razy aktywny sektor był kasowany
+    uint32_t used_bytes;  ///< Zajęte bajty w aktywnym sektorze
+    uint32_t free_bytes;  ///< Wolne bajty do kompaktowania
+    uint32_t records;     ///< Poprawne rekordy (wszystkie wersje)
+    uint32_t corrupted;   ///< Rekordy pominięte (przerwany zapis / zły CRC)
+} ConfigStoreStats_t;
+
+/**
+ * @brief Otwórz magazyn: wybierz aktywny sektor, zbuduj indeks rekordów
+ *
+ * Przy pierwszym uruchomieniu (brak poprawnego sektora) formatuje sektor 6.
+ *
+ * @return true Magazyn gotowy
+ * @return false Błąd kasowania/programowania flash
+ */
+bool configStoreInit(void);
+
+/**
+ * @brief Znajdź najnowszy rekord danego typu
+ *
+ * @param[in] type Typ rekordu
+ * @param[out] version Wersja zapisanego rekordu (może być NULL)
+ * @param[out] length Długość danych (może być NULL)
+ * @return Wskaźnik do danych we flash lub NULL (brak / usunięty)
+ */
+const void *configStoreFind(uint16_t type, uint16_t *version, uint32_t *length);
+
+/**
+ * @brief Zapisz nowy rekord (dopisanie, w razie potrzeby kompaktowanie)
+ *
+ * @param[in] type Typ rekordu
+ * @param[in] version Wersja układu danych
+ * @param[in] data Dane (mogą wskazywać na flash, np. poprzedni rekord)
+ * @param[in] length Długość danych [B]
+ * @return true Rekord zapisany i widoczny w configStoreFind()
+ */
+bool configStoreWrite(uint16_t type, uint16_t version, const void *data, uint32_t length);
+
+/**
+ * @brief Usuń typ (zapisuje rekord o długości 0 - powrót do domyślnych)
+ */
+bool configStoreDelete(uint16_t type);
+
+/**
+ * @brief Odczytaj statystyki magazynu
+ */
+void configStoreGetStats(ConfigStoreStats_t *stats);
+
+#endif // CONFIG_STORE_H
@@ -0,0 +1,104 @@
+/**
+ * @file control_frame.h
+ * @brief Granice ramek chodu i zadania wykonywane między nimi
+ *
+ * @details
+ * Chody wołają controlFrameBegin() na początku każdego punktu interpolacji
+ * i controlFrameEnd() po ustawieniu wszystkich nóg:
+ *
+ * ```
+ * | Begin | IK + zapis serw 6 nóg |  End: [odczyt IMU + PI]  [czekanie idle_ms] |
+ *         ^--- czas ramki -------^        ^ tylko gdy minął okres pętli
+ * ```
+ *
+ * Odczyt czujnika (I2C1, wspólna z PCA9685 #1) odbywa się wyłącznie po
+ * zakończeniu zapisów ramki, więc nie rozciąga sekwencji ustawiania nóg.
+ * W chodach z pauzą (wave: idle_ms > 0) odczyt mieści się w pauzie -
+ * czekanie liczone jest od końca zapisów, nie od końca odczytu.
+ *
+ * **Pomiary (controlFrameReport()):**
+ * - rzeczywista częstotliwość pętli poziomowania vs zadana,
+ * - czas odczytu IMU,
+ * - opóźnienie próbka -> pierwsza ramka z nową korektą,
+ * - czas części zapisów ramki.
+ */
+
+#ifndef CONTROL_FRAME_H
+#define CONTROL_FRAME_H
+
+#include "stm32f4xx_hal.h"
+#include "imu.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Statystyki ramek i pętli poziomowania (czasy w µs)
+ */
+typedef struct
+{
+    uint32_t frames;          ///< Liczba ramek
+    uint32_t frame_us_avg;    ///< Średni czas zapisów ramki
+    uint32_t frame_us_max;    ///< Maksymalny czas zapisów ramki
+    uint32_t level_updates;   ///< Kroki pętli poziomowania
+    uint32_t imu_errors;      ///< Nieudane odczyty czujnika
+    float level_rate_hz;      ///< Zmierzona częstotliwość pętli
+    uint32_t read_us_avg;     ///< Średni czas odczytu IMU
+    uint32_t read_us_max;     ///< Maksymalny czas odczytu IMU
+    uint32_t latency_us_avg;  ///< Średnie opóźnienie próbka -> korekta w ramce
+    uint32_t latency_us_max;  ///< Maksymalne opóźnienie próbka -> korekta
+    uint32_t period_us;       ///< Okres ramki (0 = bez terminu)
+    uint32_t deadline_misses; ///< Ramki dłuższe niż okres
+    uint32_t overrun_us_max;  ///< Największe przekroczenie okresu
+} ControlFrameStats_t;
+
+/**
+ * @brief Inicjalizacja: licznik DWT i źródło IMU
+ *
+ * Dla IMU_SOURCE_MPU6050 sprawdza obecność czujnika na magistrali -
+ * przy braku przechodzi na IMU_SOURCE_NONE (poziomowanie wyłączone).
+ * Poziomowanie włącza się automatycznie, gdy źródło jest dostępne.
+ *
+ * @param[in] imu_bus Magistrala czujnika (I2C1) lub NULL dla SIM/NONE
+ * @param[in] source Żądane źródło
+ * @return Aktywne źródło
+ */
+ImuSource_t controlFrameInit(I2C_HandleTypeDef *imu_bus, ImuSource_t source);
+
+/**
+ * @brief Początek ramki (przed pierwszą nogą)
+ */
+void controlFrameBegin(void);
+
+/**
+ * @brief Koniec ramki: zadania między ramkami i pauza
+ *
+ * @param[in] idle_ms Pauza ramki [ms] liczona od końca zapisów (0 = bez pauzy)
+ */
+void controlFrameEnd(uint32_t idle_ms);
+
+/**
+ * @brief Ustaw okres ramki (termin) [µs], 0 = bez terminu
+ *
+ * Przy okresie > 0 controlFrameEnd() czeka do początku ramki + okres
+ * (ramki w równych odstępach). Ramka, której zapisy i zadania między
+ * ramkami trwają dłużej niż okres, liczy się jako przekroczenie terminu
+ * (statystyki, metryka frame_miss, FLIGHT_FLAG_DEADLINE) i nie czeka.
+ */
+void controlFrameSetPeriod(uint32_t period_us);
+
+/**
+ * @brief Odczytaj statystyki
+ */
+void controlFrameGetStats(ControlFrameStats_t *stats);
+
+/**
+ * @brief Wyzeruj statystyki (np. przed pomiarem jednego chodu)
+ */
+void controlFrameResetStats(void);
+
+/**
+ * @brief Wypisz raport ramek i pętli poziomowania
+ */
+void controlFrameReport(void);
+
+#endif // CONTROL_FRAME_H
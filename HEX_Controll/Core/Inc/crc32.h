@@ -0,0 +1,34 @@
+/**
+ * @file crc32.h
+ * @brief Programowe CRC-32 (IEEE 802.3, jak zlib/Python binascii.crc32)
+ *
+ * @details
+ * Wielomian 0x04C11DB7 w postaci odbitej (0xEDB88320), wartość początkowa
+ * i końcowy XOR 0xFFFFFFFF. Tablica 1 KB we flash, ~8 cykli/bajt.
+ *
+ * Sprzętowy moduł CRC w STM32F4 liczy inny wariant (bez odbicia, słowami),
+ * więc jego wyniku nie da się sprawdzić zwykłym crc32 na hoście.
+ *
+ * @code{.c}
+ * uint32_t crc = crc32Update(0, header, sizeof(header));
+ * crc = crc32Update(crc, payload, length);  // kontynuacja
+ * @endcode
+ */
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Dolicz kolejny fragment danych do CRC-32
+ *
+ * @param[in] crc Wynik poprzedniego wywołania (0 dla pierwszego fragmentu)
+ * @param[in] data Dane
+ * @param[in] length Liczba bajtów
+ * @return CRC-32 wszystkich dotychczasowych danych
+ */
+uint32_t crc32Update(uint32_t crc, const void *data, size_t length);
+
+#endif // CRC32_H
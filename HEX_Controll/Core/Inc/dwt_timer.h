@@ -0,0 +1,52 @@
+/**
+ * @file dwt_timer.h
+ * @brief Licznik cykli rdzenia (DWT CYCCNT) do pomiarów czasu
+ *
+ * @details
+ * Cortex-M4 ma 32-bitowy licznik cykli w jednostce DWT. Przy 180 MHz
+ * rozdzielczość to ~5.6 ns, a licznik przepełnia się co ~23.8 s.
+ * Różnice liczone jako (uint32_t)(b - a) są poprawne przez przepełnienie.
+ *
+ * Odczyt to pojedynczy load z rejestru - bez wywołań HAL, bez przerwań,
+ * więc nadaje się do pomiarów w pętlach sterowania i w ISR.
+ *
+ * @code{.c}
+ * dwtTimerInit();
+ * uint32_t t0 = dwtCycles();
+ * computeLegIK(1, 18.0f, -15.0f, -24.0f, &q1, &q2, &q3);
+ * printf("IK: %lu us\n", dwtCyclesToUs(dwtCycles() - t0));
+ * @endcode
+ */
+
+#ifndef DWT_TIMER_H
+#define DWT_TIMER_H
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+
+/**
+ * @brief Włącz licznik cykli DWT (idempotentne)
+ */
+static inline void dwtTimerInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief Aktualna wartość licznika cykli
+ */
+static inline uint32_t dwtCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Konwersja cykli na mikrosekundy (dla aktualnego SystemCoreClock)
+ */
+static inline uint32_t dwtCyclesToUs(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000U);
+}
+
+#endif // DWT_TIMER_H
@@ -0,0 +1,144 @@
+/**
+ * @file flight_rec.h
+ * @brief Rejestrator ostatnich ramek chodu (flight recorder)
+ *
+ * @details
+ * Bufor kołowy FLIGHT_REC_FRAMES ostatnich ramek w RAM, zawsze włączony:
+ *
+ * ```
+ *  legOutputMoveFoot() -> flightRecFoot()   \
+ *  legOutputSetJoints() -> flightRecJoints() > ramka robocza (kilka zapisów/noga)
+ *  controlFrameEnd()   -> flightRecCommit()  -> memcpy do ring[head++]
+ * ```
+ * W ramce sterowania PWM nóg nie jest kopiowane przy każdym zapisie:
+ * flightRecCommit() bierze dzierżawę ostatniej ramki serw
+ * (servoFrameLeaseLatest()) i przepisuje PWM nóg zapisanych w tej ramce.
+ * flightRecJoints() zostaje dla zapisów poza ramką.
+ *
+ * **Ramka:** cel stopy po poziomowaniu (wejście IK, 0.01 cm), PWM trzech
+ * serw każdej nogi, czas zapisów i zadań między ramkami, maski nóg
+ * (błąd IK, błąd I2C, stopa na ziemi) i flagi ramki.
+ *
+ * **Po awarii:** bufor leży w sekcji .noinit (STM32F446XX_FLASH.ld) -
+ * startup go nie zeruje. HardFault_Handler woła flightRecFault(): zapis
+ * rejestrów błędu, zamrożenie bufora, reset. flightRecInit() po starcie
+ * widzi zamrożony bufor z poprawnym nagłówkiem i wypisuje go przez UART
+ * przed wyczyszczeniem. Na żądanie: komenda `rec` (serial_cmd.h).
+ *
+ * Koszt w ramce: ~6 zapisów na nogę + jeden memcpy sizeof(FlightFrame_t).
+ */
+
+#ifndef FLIGHT_REC_H
+#define FLIGHT_REC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "robot_description.h"
+
+/**
+ * @brief Liczba zapamiętanych ramek (~88 B każda)
+ */
+#ifndef FLIGHT_REC_FRAMES
+#define FLIGHT_REC_FRAMES 64
+#endif
+
+/**
+ * @brief Flagi ramki
+ */
+#define FLIGHT_FLAG_LEVELING 0x01U ///< Korekta poziomowania aktywna
+#define FLIGHT_FLAG_IMU_READ 0x02U ///< Odczyt IMU po tej ramce
+#define FLIGHT_FLAG_IMU_ERR 0x04U  ///< Odczyt IMU nieudany
+#define FLIGHT_FLAG_DEADLINE 0x08U ///< Ramka dłuższa niż okres (controlFrameSetPeriod())
+
+/**
+ * @brief Jedna ramka chodu
+ */
+typedef struct
+{
+    uint32_t seq;              ///< Numer ramki od startu
+    uint32_t tick_ms;          ///< HAL_GetTick() na końcu ramki
+    uint16_t write_us;         ///< Czas IK + zapisów serw
+    uint16_t service_us;       ///< Czas zadań między ramkami (IMU + PI)
+    uint8_t ik_fail_mask;      ///< Bit (noga - 1): brak rozwiązania IK
+    uint8_t bus_err_mask;      ///< Bit (noga - 1): nieudany zapis PWM
+    uint8_t contact_mask;      ///< Bit (noga - 1): przyziemienie w swingu
+    uint8_t flags;             ///< FLIGHT_FLAG_*
+    int16_t foot_cmm[HEX_LEG_COUNT][3]; ///< Cel stopy x, y, z [0.01 cm]
+    uint16_t pwm[HEX_LEG_COUNT][3];     ///< Wysłane PWM biodro, kolano, kostka
+} FlightFrame_t;
+
+// Maski nóg w ramce są 8-bitowe - ramka zostaje mała (FLIGHT_REC_FRAMES w RAM)
+_Static_assert(HEX_LEG_COUNT <= 8, "flight_rec: maski nóg uint8_t");
+
+/**
+ * @brief Ramka robocza wypełniana w trakcie ramki chodu
+ */
+extern FlightFrame_t flight_rec_current;
+
+/**
+ * @brief Po starcie: wypisz bufor zamrożony przez awarię, potem wyczyść
+ *
+ * @return true gdy poprzednie uruchomienie zakończyło się awarią
+ */
+bool flightRecInit(void);
+
+/**
+ * @brief Zamknij ramkę roboczą: czasy i flagi, kopia do bufora
+ */
+void flightRecCommit(uint32_t write_us, uint32_t service_us, uint8_t flags);
+
+/**
+ * @brief Wypisz zapamiętane ramki (najstarsza pierwsza)
+ */
+void flightRecDump(void);
+
+/**
+ * @brief Zapis z HardFault_Handler: rejestry błędu, zamrożenie, reset
+ *
+ * Nie wraca.
+ */
+void flightRecFault(void);
+
+static inline int16_t flightRecCentiCm(float cm)
+{
+    float v = cm * 100.0f;
+    if (v > 32767.0f)
+        return 32767;
+    if (v < -32768.0f)
+        return -32768;
+    return (int16_t)v;
+}
+
+/**
+ * @brief Cel stopy (wejście IK) w ramce roboczej
+ */
+static inline void flightRecFoot(int leg_number, float x, float y, float z)
+{
+    int16_t *f = flight_rec_current.foot_cmm[leg_number - 1];
+    f[0] = flightRecCentiCm(x);
+    f[1] = flightRecCentiCm(y);
+    f[2] = flightRecCentiCm(z);
+}
+
+/**
+ * @brief Brak rozwiązania IK dla nogi
+ */
+static inline void flightRecIkFail(int leg_number)
+{
+    flight_rec_current.ik_fail_mask |= (uint8_t)(1U << (leg_number - 1));
+}
+
+/**
+ * @brief PWM wysłane do nogi i wynik zapisu (zapis poza ramką sterowania)
+ */
+static inline void flightRecJoints(int leg_number, const uint16_t pwm[3], bool ok)
+{
+    uint16_t *p = flight_rec_current.pwm[leg_number - 1];
+    p[0] = pwm[0];
+    p[1] = pwm[1];
+    p[2] = pwm[2];
+    if (!ok)
+        flight_rec_current.bus_err_mask |= (uint8_t)(1U << (leg_number - 1));
+}
+
+#endif // FLIGHT_REC_H
@@ -0,0 +1,182 @@
+/**
+ * @file foot_contact.h
+ * @brief Czujniki kontaktu stóp: wcześniejsze przyziemienie i wysokość podłoża
+ *
+ * @details
+ * Swing bez czujników kończy się zawsze na base_z - na nierównym podłożu
+ * noga albo wbija się w podłoże, albo ląduje za późno. Z czujnikiem:
+ *
+ * ```
+ *  z ^   start (ground_z z poprzedniego kroku)
+ *    |    \          .-''-.
+ *    |     \       /       \      <- łuk lift_height
+ *    |      '-----'         x     <- kontakt: z stoi, ground_z = z stopy
+ *    |                       '.   <- reszta łuku (pominięta)
+ *    |                         '- base_z
+ *    +---------------------------------> t
+ *                     t >= min_swing_t: kontakt liczony tylko przy opadaniu
+ * ```
+ *
+ * - **Swing** - footSwingBegin() na początku, footSwingUpdate() w każdej
+ *   ramce. Po wykryciu kontaktu stopa przestaje schodzić w dół (z zostaje
+ *   na wysokości kontaktu), po potwierdzeniu (debounce_frames ramek)
+ *   wysokość trafia do stanu nogi.
+ * - **Stance** - chody biorą wysokość z footGroundZ() zamiast base_z,
+ *   a kolejny swing startuje z tej wysokości.
+ * - **Kadencja** - bipedal i wave kończą fazę swing, gdy wszystkie nogi
+ *   swing są na ziemi (footSwingDown()). W tripodzie faza swing jest
+ *   sprzężona ze stance drugiej grupy - stopa kończy ruch x/y po podłożu.
+ *
+ * **Źródła:**
+ * - FOOT_CONTACT_SOURCE_GPIO - krańcówki w stopach (foot_contact_gpio.c),
+ * - FOOT_CONTACT_SOURCE_SIM - podłoże na zadanej wysokości dla każdej nogi
+ *   (footContactSimSetGround()), do testów na hoście i na płytce bez
+ *   krańcówek (test: `make -C Tools check`, Tools/contact_check.c),
+ * - FOOT_CONTACT_SOURCE_NONE - zachowanie jak dotąd (footGroundZ() zwraca
+ *   base_z, swing zawsze do końca).
+ *
+ * Odczyt odnosi się do pozycji wysłanej w poprzedniej ramce - czujnik
+ * widzi stopę tam, gdzie serwa już ją ustawiły, nie tam, dokąd ma iść.
+ *
+ * Moduł nie zależy od HAL - źródło GPIO podłącza footContactGpioInit().
+ */
+
+#ifndef FOOT_CONTACT_H
+#define FOOT_CONTACT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Źródło sygnału kontaktu
+ */
+typedef enum
+{
+    FOOT_CONTACT_SOURCE_NONE = 0, ///< Brak czujników - swing do base_z
+    FOOT_CONTACT_SOURCE_GPIO,     ///< Krańcówki w stopach (foot_contact_gpio.c)
+    FOOT_CONTACT_SOURCE_SIM       ///< Symulowane podłoże (footContactSimSetGround())
+} FootContactSource_t;
+
+/**
+ * @brief Odczyt kontaktu jednej nogi
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] foot_z Wysokość stopy wysłana w poprzedniej ramce [cm]
+ * @return true gdy stopa dotyka podłoża
+ */
+typedef bool (*FootContactReadFn)(int leg_number, float foot_z);
+
+/**
+ * @brief Parametry wykrywania przyziemienia
+ */
+typedef struct
+{
+    float min_swing_t;      ///< Faza swingu, od której kontakt jest liczony (0.5 = opadanie)
+    uint8_t debounce_frames; ///< Kolejne ramki z kontaktem do potwierdzenia
+} FootContactConfig_t;
+
+/**
+ * @brief Stan stopy (do raportu)
+ */
+typedef struct
+{
+    bool ground_valid;          ///< ground_z pochodzi z przyziemienia
+    bool touched_down;          ///< Przyziemienie w bieżącym/ostatnim swingu
+    float ground_z;             ///< Wysokość stopy przy ostatnim przyziemieniu [cm]
+    float touchdown_t;          ///< Faza swingu w chwili przyziemienia
+    uint32_t swings;            ///< Liczba swingów
+    uint32_t early_touchdowns;  ///< Przyziemienia przed końcem łuku
+    uint32_t missed_touchdowns; ///< Swingi zakończone bez kontaktu
+} FootState_t;
+
+extern FootContactConfig_t foot_contact_config;
+
+/**
+ * @brief Wybierz źródło kontaktu i wyzeruj stan stóp
+ *
+ * @param[in] source Źródło
+ * @param[in] read Funkcja odczytu dla GPIO (dla SIM/NONE ignorowana)
+ */
+void footContactSetSource(FootContactSource_t source, FootContactReadFn read);
+
+/**
+ * @brief Aktywne źródło
+ */
+FootContactSource_t footContactGetSource(void);
+
+/**
+ * @brief Zapomnij wysokości podłoża (np. po ustawieniu pozycji stojącej)
+ */
+void footContactReset(void);
+
+/**
+ * @brief Początek swingu nogi
+ */
+void footSwingBegin(int leg_number);
+
+/**
+ * @brief Krok swingu: sprawdź kontakt przed wysłaniem nowej pozycji
+ *
+ * Po wykryciu kontaktu wysokość jest zamieniana na wysokość stopy
+ * z chwili kontaktu - x/y mogą dalej iść do celu po podłożu.
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] t Faza swingu 0..1
+ * @param[in,out] z Wysokość, którą chód chce wysłać w tej ramce [cm];
+ *                  przy kontakcie - wysokość podłoża
+ * @return true gdy stopa jest na ziemi (lub kontakt w trakcie potwierdzania)
+ */
+bool footSwingUpdate(int leg_number, float t, float *z);
+
+/**
+ * @brief Czy swing nogi zakończył się potwierdzonym przyziemieniem
+ */
+bool footSwingDown(int leg_number);
+
+/**
+ * @brief Wysokość startu bieżącego swingu [cm]
+ *
+ * @param[in] fallback Wartość, gdy wysokość podłoża nie jest znana (base_z)
+ */
+float footSwingStartZ(int leg_number, float fallback);
+
+/**
+ * @brief Wysokość podłoża pod nogą dla fazy stance [cm]
+ *
+ * @param[in] fallback Wartość, gdy wysokość podłoża nie jest znana (base_z)
+ */
+float footGroundZ(int leg_number, float fallback);
+
+/**
+ * @brief Odczytaj stan stopy
+ */
+void footContactGetState(int leg_number, FootState_t *state);
+
+/**
+ * @brief Ustaw podłoże symulowane pod nogą
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] ground_z Wysokość podłoża w układzie chodu [cm] - kontakt, gdy
+ *                     opadająca stopa dojdzie do niej (kierunek opadania
+ *                     wynika z trajektorii łuku)
+ */
+void footContactSimSetGround(int leg_number, float ground_z);
+
+/**
+ * @brief Usuń podłoże symulowane - swingi nogi bez kontaktu
+ */
+void footContactSimClear(void);
+
+/**
+ * @brief Wypisz stan stóp i liczniki przyziemień
+ */
+void footContactReport(void);
+
+/**
+ * @brief Skonfiguruj wejścia krańcówek (PC0..PC5) i wybierz źródło GPIO
+ *
+ * Zdefiniowana w foot_contact_gpio.c (HAL).
+ */
+void footContactGpioInit(void);
+
+#endif // FOOT_CONTACT_H
@@ -1,6 +1,6 @@
 /**
  * @file hexapod_kinematics.h
- * @brief Kinematyka odwrotna dla 6-nożnego robota hexapod
+ * @brief Kinematyka odwrotna nóg robota kroczącego (domyślnie hexapod)
  *
  * @details
  * System kinematyki odwrotnej (Inverse Kinematics) dla hexapoda bazujący
@@ -110,6 +110,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <math.h>
+#include "robot_description.h"
 
 /**
  * @defgroup Kinematics_Constants Stałe kinematyczne
@@ -135,6 +136,24 @@
 #define L3 15.5f ///< Długość podudzia [cm] - od osi kostki do końca stopy
 ///@}
 
+/**
+ * @brief Szczegółowe logi computeLegIK() przez printf()
+ *
+ * @details
+ * Domyślnie włączone (1) - zachowanie jak dotychczas. Narzędzia hosta
+ * (np. Tools/workspace_map) i pętle wydajnościowe kompilują z
+ * -DHEXAPOD_IK_VERBOSE=0, bo każde wywołanie IK drukuje kilka linii.
+ */
+#ifndef HEXAPOD_IK_VERBOSE
+#define HEXAPOD_IK_VERBOSE 1
+#endif
+
+#if HEXAPOD_IK_VERBOSE
+#define IK_LOG(...) printf(__VA_ARGS__)
+#else
+#define IK_LOG(...) ((void)0)
+#endif
+
 /** @} */ // end of Kinematics_Constants
 
 /**
@@ -182,16 +201,39 @@ typedef struct
     float ankle; ///< Kąt kostki [radiany]
 } JointAngles_t;
 
+/**
+ * @brief Wersja układu RobotGeometry_t w config_store - zmiana struktury = +1
+ */
+#define ROBOT_GEOMETRY_VERSION 1
+
+/**
+ * @brief Geometria robota: długości segmentów i pozycje origin nóg
+ *
+ * @details
+ * Rekord CONFIG_TYPE_GEOMETRY w config_store. Domyślne wartości to
+ * L1/L2/L3 i tabela origin z URDF.
+ */
+typedef struct
+{
+    float l1;                           ///< Długość biodra [cm]
+    float l2;                           ///< Długość uda [cm]
+    float l3;                           ///< Długość podudzia [cm]
+    LegOrigin_t origins[HEX_LEG_COUNT]; ///< Indeks = numer_nogi - 1
+} RobotGeometry_t;
+
 /**
  * @defgroup Kinematics_Data Dane konfiguracyjne
  * @{
  */
 
 /**
- * @brief Tablica pozycji origin wszystkich 6 nóg
+ * @brief Geometria w SRAM (pozycje origin wszystkich nóg i L1/L2/L3)
  *
  * @details
- * Indeks tablicy = numer_nogi - 1 (nogi numerowane 1-6).
+ * Indeks origins = numer_nogi - 1 (nogi numerowane 1..HEX_LEG_COUNT).
+ * Na starcie wartości z ROBOT_LEG_TABLE (robot_description.h);
+ * configParamsLoad() kopiuje tu poprawny rekord z flash, więc IK czyta
+ * geometrię zawsze z SRAM (HOT_CONST), nie z sektora config_store.
  *
  * **Układ nóg (widok z góry):**
  * ```
@@ -203,10 +245,24 @@ typedef struct
  * ```
  *
  * **Konwencja inwersji:**
- * - **Lewe nogi (1,3,5)**: invert_hip=false, invert_knee=false
- * - **Prawe nogi (2,4,6)**: invert_hip=true, invert_knee=true
+ * - **Lewe nogi (nieparzyste: 1,3,5)**: invert_hip=false, invert_knee=false
+ * - **Prawe nogi (parzyste: 2,4,6)**: invert_hip=true, invert_knee=true
+ */
+extern RobotGeometry_t robot_geometry_default;
+
+/**
+ * @brief Geometria z URDF we flash - źródło przy powrocie do wartości domyślnych
  */
-extern const LegOrigin_t leg_origins[6];
+extern const RobotGeometry_t robot_geometry_urdf;
+
+/**
+ * @brief Aktywna geometria używana przez IK/FK/jakobian
+ *
+ * @details
+ * Zawsze &robot_geometry_default - rekord z flash jest kopiowany, nie
+ * podpinany (inaczej niż pozostałe parametry config_params.h).
+ */
+extern const RobotGeometry_t *robot_geometry;
 
 /** @} */ // end of Kinematics_Data
 
@@ -240,7 +296,7 @@ extern const LegOrigin_t leg_origins[6];
  * - Automatyczne uwzględnienie w obliczeniach
  * - Bazuje na flagach invert_hip i invert_knee
  *
- * @param[in] leg_number Numer nogi (1-6)
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
  * @param[in] x Pozycja X końcówki nogi [cm]
  * @param[in] y Pozycja Y końcówki nogi [cm]
  * @param[in] z Pozycja Z końcówki nogi [cm]
@@ -264,11 +320,60 @@ extern const LegOrigin_t leg_origins[6];
  * @endcode
  *
  * @see debugLegIK() dla szczegółowej analizy obliczeń
- * @see leg_origins tablica pozycji origin nóg
+ * @see robot_geometry aktywna geometria nóg
  */
 bool computeLegIK(int leg_number, float x, float y, float z,
                   float *q1, float *q2, float *q3);
 
+/**
+ * @brief Wejście i wyjście IK kilku nóg naraz (struktura tablic)
+ *
+ * @details
+ * Wpis i: noga leg[i], cel (x[i], y[i], z[i]) -> kąty q1[i], q2[i], q3[i].
+ * Bit i maski ok = wpis w zasięgu (kąty wpisów poza zasięgiem są
+ * nieokreślone i nie wolno ich wysyłać do serw).
+ */
+typedef struct
+{
+    uint8_t count;              ///< Liczba wpisów (<= HEX_LEG_COUNT)
+    uint8_t leg[HEX_LEG_COUNT]; ///< Numery nóg
+    float x[HEX_LEG_COUNT];     ///< Cele stóp [cm]
+    float y[HEX_LEG_COUNT];
+    float z[HEX_LEG_COUNT];
+    float q1[HEX_LEG_COUNT]; ///< Wynik: biodro [rad]
+    float q2[HEX_LEG_COUNT]; ///< Wynik: kolano [rad]
+    float q3[HEX_LEG_COUNT]; ///< Wynik: kostka [rad]
+    LegMask_t ok;            ///< Wynik: bit i = wpis i rozwiązany
+} LegIKBatch_t;
+
+/**
+ * @brief Kinematyka odwrotna wszystkich wpisów partii
+ *
+ * @details
+ * Te same wzory co computeLegIK(), ale etapami po wszystkich nogach
+ * (najpierw biodra i zasięgi, potem kolana i kostki) zamiast całej IK
+ * noga po nodze. Inwersja prawej strony to wybór wartości, a nie osobna
+ * gałąź kodu, więc pętla jest taka sama dla każdej nogi i każdej liczby
+ * nóg. Bez logów IK_LOG - to ścieżka chodu, do diagnostyki debugLegIK().
+ *
+ * @param[in,out] batch Wpisy (leg, x, y, z) -> q1, q2, q3, ok
+ * @return true gdy wszystkie wpisy w zasięgu; false dla NULL, count za
+ *         duże, złego numeru nogi (ok = 0) albo gdy któryś wpis jest poza
+ *         zasięgiem (patrz ok)
+ */
+bool computeLegIKBatch(LegIKBatch_t *batch);
+
+#if HEX_PERF_BENCHMARK
+/**
+ * @brief Kopia computeLegIK() wykonywana z flash (tylko do pomiarów)
+ *
+ * computeLegIK() jest w SRAM (HOT_FUNC, hot_path.h), ta kopia zostaje
+ * we flash - perfBenchmarkRun() porównuje obie przy różnych ustawieniach ART.
+ */
+bool computeLegIKFlash(int leg_number, float x, float y, float z,
+                       float *q1, float *q2, float *q3);
+#endif
+
 /**
  * @brief Szczegółowa analiza kinematyki odwrotnej z debugiem
  *
@@ -289,7 +394,7 @@ bool computeLegIK(int leg_number, float x, float y, float z,
  * - "Za blisko" - punkt w martwej strefie centralnej
  * - Problemy numeryczne w acos()
  *
- * @param[in] leg_number Numer nogi (1-6)
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
  * @param[in] x Pozycja X końcówki nogi [cm]
  * @param[in] y Pozycja Y końcówki nogi [cm]
  * @param[in] z Pozycja Z końcówki nogi [cm]
@@ -315,7 +420,7 @@ bool debugLegIK(int leg_number, float x, float y, float z);
  * @brief Test wszystkich pozycji bazowych oraz z krokami
  *
  * @details
- * Kompleksowa funkcja testująca kinematykę dla wszystkich 6 nóg
+ * Kompleksowa funkcja testująca kinematykę dla wszystkich nóg
  * w trzech scenariuszach:
  * 1. **Pozycja bazowa** - standardowa pozycja stojąca
  * 2. **Krok do przodu** - pozycja + 4cm w kierunku Y-
@@ -347,5 +452,61 @@ bool debugLegIK(int leg_number, float x, float y, float z);
  */
 void testAllBasePositions(void);
 
+/**
+ * @brief Kinematyka prosta - pozycja stopy z kątów stawów
+ *
+ * @details
+ * Odwrotność computeLegIK() dla tej samej konwencji kątów
+ * (konfiguracja "kolano w górę", q3 = γ - π). Dla kątów zwróconych przez
+ * computeLegIK() odtwarza pozycję wejściową z dokładnością float.
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] q1 Kąt biodra [radiany]
+ * @param[in] q2 Kąt kolana [radiany]
+ * @param[in] q3 Kąt kostki [radiany]
+ * @param[out] x Pozycja X stopy [cm]
+ * @param[out] y Pozycja Y stopy [cm]
+ * @param[out] z Pozycja Z stopy [cm]
+ *
+ * @return false dla nieprawidłowego numeru nogi lub wskaźnika NULL
+ */
+bool computeLegFK(int leg_number, float q1, float q2, float q3,
+                  float *x, float *y, float *z);
+
+/**
+ * @brief Jakobian nogi d(x,y,z)/d(q1,q2,q3) [cm/rad]
+ *
+ * @details
+ * Analityczna pochodna computeLegFK(). Wiersze: x, y, z; kolumny: q1, q2, q3.
+ * Kolumna biodra jest pozioma i prostopadła do płaszczyzny nogi, więc
+ * wartości szczególne to |ρ| (odległość stopy od osi biodra) oraz dwie
+ * wartości szczególne płaskiego jakobianu 2x2 kolano/kostka.
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] q1 Kąt biodra [radiany]
+ * @param[in] q2 Kąt kolana [radiany]
+ * @param[in] q3 Kąt kostki [radiany]
+ * @param[out] J Macierz 3x3
+ *
+ * @return false dla nieprawidłowego numeru nogi lub wskaźnika NULL
+ *
+ * @see legJacobianCondition() - uwarunkowanie (bliskość osobliwości)
+ */
+bool computeLegJacobian(int leg_number, float q1, float q2, float q3,
+                        float J[3][3]);
+
+/**
+ * @brief Współczynnik uwarunkowania jakobianu nogi (σmax / σmin)
+ *
+ * @details
+ * 1.0 = idealnie izotropowo, rośnie przy zbliżaniu się do osobliwości
+ * (noga wyprostowana D → L2+L3, złożona D → |L2-L3| lub stopa nad osią
+ * biodra ρ → 0). Duże wartości oznaczają, że mały ruch stopy wymaga
+ * dużych prędkości serw.
+ *
+ * @return Współczynnik uwarunkowania lub INFINITY dla osobliwości
+ */
+float legJacobianCondition(int leg_number, float q1, float q2, float q3);
+
 /** @} */ // end of Kinematics_Functions
 #endif    // HEXAPOD_KINEMATICS_H
\ No newline at end of file
@@ -0,0 +1,60 @@
+/**
+ * @file hot_path.h
+ * @brief Umieszczanie gorących funkcji i tablic w SRAM
+ *
+ * @details
+ * Przy 180 MHz flash pracuje z 5 cyklami oczekiwania (FLASH_LATENCY_5),
+ * ukrytymi przez akcelerator ART (prefetch + 1 KB I-cache + 128 B D-cache).
+ * Pętle IK i trajektorii konkurują o ten cache z kodem HAL i printf,
+ * więc ich czas zależy od tego, co wykonało się wcześniej.
+ *
+ * Funkcje oznaczone HOT_FUNC trafiają do sekcji .RamFunc, a tablice
+ * HOT_CONST do .RamConst. Obie sekcje leżą w .data (STM32F446XX_FLASH.ld),
+ * więc startup kopiuje je z flash do SRAM razem z danymi - bez dodatkowego
+ * kodu. Wywołania flash <-> SRAM (odległość > 16 MB) linker obsługuje
+ * automatycznie przez veneery, tak jak __RAM_FUNC z HAL.
+ *
+ * Linker przenosi też do SRAM atan2f/acosf/sqrtf z libm (używane przez IK).
+ *
+ * **Który wariant wygrywa:**
+ * Nie zawsze SRAM - kod z SRAM1 i dane idą wtedy tą samą magistralą S.
+ * perfBenchmarkRun() (build Performance) mierzy IK z flash i z SRAM
+ * przy różnych ustawieniach ART. Jeśli flash wygrywa, zbuduj z
+ * HEX_HOT_IN_RAM=0 - makra staną się puste.
+ *
+ * @code{.c}
+ * HOT_CONST const float table[4] = {...};
+ * HOT_FUNC bool computeLegIK(...) { ... }
+ * @endcode
+ */
+
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+#ifndef HEX_HOT_IN_RAM
+#if defined(__arm__)
+#define HEX_HOT_IN_RAM 1
+#else
+#define HEX_HOT_IN_RAM 0 // Narzędzia hosta - zwykłe sekcje
+#endif
+#endif
+
+#if HEX_HOT_IN_RAM
+#define HOT_FUNC __attribute__((section(".RamFunc"), noinline))
+#define HOT_CONST __attribute__((section(".RamConst")))
+#else
+#define HOT_FUNC
+#define HOT_CONST
+#endif
+
+/**
+ * @brief Wypisz konfigurację akceleratora flash i rozmiar kodu w SRAM
+ *
+ * @details
+ * Pokazuje FLASH->ACR (latency, prefetch, I-cache, D-cache), rozmiar
+ * sekcji .RamFunc/.RamConst oraz adres computeLegIK() (flash czy SRAM).
+ * Wywoływane raz przy starcie, po inicjalizacji UART.
+ */
+void hotPathReport(void);
+
+#endif // HOT_PATH_H
@@ -0,0 +1,65 @@
+/**
+ * @file imu.h
+ * @brief Próbka czujnika inercyjnego i źródło symulowane
+ *
+ * @details
+ * Wspólny format danych dla poziomowania korpusu (body_leveling.h),
+ * niezależny od HAL. Dane pochodzą z:
+ * - MPU-6050 na I2C1 (mpu6050.h),
+ * - źródła symulowanego (imuSimRead()) - zadane przechylenie korpusu
+ *   plus szum, do uruchomienia pętli poziomowania na hoście i na płytce
+ *   bez czujnika. Test pętli zamkniętej: `make -C Tools check`
+ *   (Tools/leveling_check.c).
+ *
+ * **Osie:** zgodne z układem chodów - X w lewo (lewe nogi mają x > 0),
+ * Y do tyłu (przednie nogi y < 0), Z w górę. Czujnik montowany tak,
+ * żeby jego osie pokrywały się z tym układem.
+ */
+
+#ifndef IMU_H
+#define IMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Źródło danych inercyjnych
+ */
+typedef enum
+{
+    IMU_SOURCE_NONE = 0, ///< Brak czujnika - poziomowanie wyłączone
+    IMU_SOURCE_MPU6050,  ///< MPU-6050 na I2C (mpu6050.h)
+    IMU_SOURCE_SIM       ///< Symulacja (imuSimRead())
+} ImuSource_t;
+
+/**
+ * @brief Jedna próbka czujnika w układzie korpusu
+ */
+typedef struct
+{
+    float accel_g[3];  ///< Siła właściwa [g] (w spoczynku Z = +1)
+    float gyro_dps[3]; ///< Prędkość kątowa [°/s] wokół X, Y, Z
+} ImuSample_t;
+
+/**
+ * @brief Ustaw przechylenie korpusu widziane przez symulowany czujnik
+ *
+ * @param[in] roll_deg Przechył boczny [°], > 0 = lewa strona wyżej
+ * @param[in] pitch_deg Pochylenie [°], > 0 = tył wyżej
+ */
+void imuSimSetTilt(float roll_deg, float pitch_deg);
+
+/**
+ * @brief Amplituda szumu symulowanego czujnika (0 = bez szumu)
+ */
+void imuSimSetNoise(float accel_g, float gyro_dps);
+
+/**
+ * @brief Wygeneruj próbkę symulowaną
+ *
+ * @param[out] sample Próbka
+ * @param[in] dt Czas od poprzedniej próbki [s] - do prędkości kątowej
+ */
+void imuSimRead(ImuSample_t *sample, float dt);
+
+#endif // IMU_H
@@ -0,0 +1,120 @@
+/**
+ * @file joint_interp.h
+ * @brief Interpolacja kątów stawów między keyframe'ami IK (multi-rate)
+ *
+ * @details
+ * Tor stopy w fazie chodu jest gładki, więc IK w każdym punkcie wyjścia
+ * jest zbędne. Tor nogi liczony jest co `stride` punktów (keyframe),
+ * a kąty pomiędzy nimi z kubicznego Hermite'a:
+ * ```
+ * q(u) = h00(u)·q_k + h10(u)·h·m_k + h01(u)·q_k+1 + h11(u)·h·m_k+1
+ * m_k  = (q_k+1 - q_k-1) / (p_k+1 - p_k-1)     (różnice skończone)
+ * ```
+ * gdzie p_k to indeks punktu keyframe'a, h = p_k+1 - p_k, u ∈ [0, 1].
+ * Na końcach toru pochodna jednostronna.
+ *
+ * Keyframe'y rozwiązywane są leniwie w oknie 4 kluczy (q_k-1..q_k+2),
+ * więc koszt IK rozkłada się równo: jedno IK nogi na `stride` ramek
+ * zamiast jednego na ramkę. Próbki muszą iść w kolejności rosnącej.
+ *
+ * **Ograniczenie błędu:** jointInterpPlanStride() dobiera największy
+ * stride (<= joint_interp_config.stride), dla którego pozycja stopy z FK
+ * interpolowanych kątów odbiega od toru o najwyżej max_error_cm we
+ * wszystkich punktach. Wynik warto zapamiętać - planowanie to pełne IK + FK
+ * w każdym punkcie dla każdego sprawdzanego stride.
+ *
+ * Tor musi być deterministyczny (funkcja t) - poziomowanie korpusu
+ * i kontakt stóp zmieniają cel w trakcie fazy, wtedy chód wraca do IK
+ * w każdym punkcie.
+ *
+ * Moduł nie zależy od HAL.
+ */
+
+#ifndef JOINT_INTERP_H
+#define JOINT_INTERP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Liczba keyframe'ów trzymanych jednocześnie (q_k-1..q_k+2)
+ */
+#define JOINT_INTERP_WINDOW 4
+
+/**
+ * @brief Pozycja stopy na torze fazy
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] t Postęp fazy 0..1 (liniowy, jak w pętli chodu)
+ * @param[out] foot Pozycja stopy [cm] (x, y, z)
+ */
+typedef void (*JointPathFn)(int leg_number, float t, float foot[3]);
+
+/**
+ * @brief Parametry interpolacji
+ */
+typedef struct
+{
+    bool enabled;       ///< false = IK w każdym punkcie
+    uint8_t stride;     ///< Największy odstęp keyframe'ów [punkty]
+    float max_error_cm; ///< Dopuszczalny błąd pozycji stopy względem pełnego IK [cm]
+} JointInterpConfig_t;
+
+/**
+ * @brief Tor jednej nogi w bieżącej fazie
+ */
+typedef struct
+{
+    JointPathFn path;
+    uint16_t points;   ///< Punkty wyjścia 0..points
+    uint16_t last_key; ///< Indeks ostatniego keyframe'a
+    int16_t solved;    ///< Ostatni rozwiązany keyframe (-1 = żaden)
+    uint8_t leg_number;
+    uint8_t stride;
+    bool valid; ///< false - tor pusty, IK nie powiodło się albo próbka spoza okna
+    float q[JOINT_INTERP_WINDOW][3];
+} JointTrack_t;
+
+extern JointInterpConfig_t joint_interp_config;
+
+/**
+ * @brief Rozpocznij tor fazy (bez liczenia IK)
+ *
+ * @param[out] track Tor
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] path Tor stopy
+ * @param[in] points Liczba odcinków fazy (próbki 0..points)
+ * @param[in] stride Odstęp keyframe'ów [punkty], >= 1
+ */
+void jointTrackBegin(JointTrack_t *track, int leg_number, JointPathFn path,
+                     uint16_t points, uint8_t stride);
+
+/**
+ * @brief Kąty stawów w punkcie i (rosnąco w obrębie fazy)
+ *
+ * @param[in,out] track Tor
+ * @param[in] i Indeks punktu 0..points
+ * @param[out] q Kąty biodro, kolano, kostka [rad]
+ * @return false gdy tor nieważny - wywołujący liczy pełne IK
+ */
+bool jointTrackSample(JointTrack_t *track, uint16_t i, float q[3]);
+
+/**
+ * @brief Największy błąd pozycji stopy dla danego stride
+ *
+ * @return Błąd [cm], INFINITY gdy IK toru się nie powiodło
+ */
+float jointTrackMaxError(int leg_number, JointPathFn path, uint16_t points, uint8_t stride);
+
+/**
+ * @brief Największy stride w granicy błędu z joint_interp_config
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] path Tor stopy
+ * @param[in] points Liczba odcinków fazy
+ * @param[out] max_error Błąd dla wybranego stride [cm] (może być NULL)
+ * @return Stride; 1 = IK w każdym punkcie (także gdy interpolacja wyłączona)
+ */
+uint8_t jointInterpPlanStride(int leg_number, JointPathFn path, uint16_t points, float *max_error);
+
+#endif // JOINT_INTERP_H
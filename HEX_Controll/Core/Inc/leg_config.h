@@ -0,0 +1,102 @@
+/**
+ * @file leg_config.h
+ * @brief Mapowanie nóg na kanały PCA9685, offsety bioder i limity PWM serw
+ *
+ * @details
+ * Wcześniej każdy chód miał własną kopię tablicy `leg_mapping`, a limity
+ * PWM były stałymi SERVO_PWM_MIN/MAX w pca9685.h. Teraz jedna struktura
+ * LegConfig_t, czytana przez wskaźnik leg_config:
+ *
+ * - domyślnie wskazuje na leg_config_default (flash, wartości z URDF),
+ * - po configParamsLoad() może wskazywać bezpośrednio na rekord
+ *   w config_store (kalibracja zapisana bez ponownego flashowania).
+ *
+ * Kontroler nogi to indeks urządzenia servo_bus (kolejność
+ * servoBusAddDevice() w main.c), nie strona korpusu - nogi można
+ * rozłożyć na więcej kontrolerów i magistral.
+ *
+ * Moduł nie zależy od HAL - używają go też narzędzia hosta (Tools/).
+ */
+
+#ifndef LEG_CONFIG_H
+#define LEG_CONFIG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "robot_description.h"
+
+/**
+ * @brief Wersja układu LegConfig_t w magazynie - zmiana struktury = +1
+ */
+#define LEG_CONFIG_VERSION 2
+
+/**
+ * @brief Najwięcej kontrolerów PCA9685 (adresy 0x40..0x47 na magistrali)
+ */
+#define LEG_CONFIG_MAX_DEVICES 8
+
+/**
+ * @brief Domyślne limity PWM serwa (0° i 180°), jak SERVO_PWM_MIN/MAX
+ */
+///@{
+#define LEG_CONFIG_PWM_MIN_DEFAULT 110
+#define LEG_CONFIG_PWM_MAX_DEFAULT 500
+///@}
+
+/**
+ * @brief Mapowanie nogi na kontroler i kanały
+ */
+typedef struct
+{
+    uint8_t base_channel; ///< Bazowy kanał (hip = base, knee = base+1, ankle = base+2)
+    float hip_offset_deg; ///< Offset biodra [stopnie] - z URDF joint limits
+    uint8_t device;       ///< Kontroler w servo_bus (servoBusAddDevice(): 0 = I2C1, 1 = I2C2)
+} LegMapping_t;
+
+/**
+ * @brief Zakres PWM pojedynczego serwa (wartości licznika PCA9685 dla 0° i 180°)
+ */
+typedef struct
+{
+    uint16_t pwm_min; ///< PWM dla 0°
+    uint16_t pwm_max; ///< PWM dla 180°
+} ServoPwmLimits_t;
+
+/**
+ * @brief Pełna konfiguracja wyjść nóg (rekord CONFIG_TYPE_LEG_CONFIG)
+ */
+typedef struct
+{
+    LegMapping_t legs[HEX_LEG_COUNT];         ///< Indeks = numer_nogi - 1
+    ServoPwmLimits_t servo[HEX_LEG_COUNT][3]; ///< [noga][hip, knee, ankle]
+} LegConfig_t;
+
+/**
+ * @brief Wartości domyślne (kompilowane do flash, z ROBOT_LEG_TABLE)
+ */
+extern const LegConfig_t leg_config_default;
+
+/**
+ * @brief Aktywna konfiguracja - domyślna lub rekord z config_store
+ */
+extern const LegConfig_t *leg_config;
+
+/**
+ * @brief Kąt serwa [0..180°] -> wartość PWM dla danego zakresu
+ *
+ * @param[in] limits Zakres PWM serwa
+ * @param[in] angle Kąt serwa [stopnie], przycinany do 0..180
+ * @return Wartość PWM dla PCA9685_SetPWM()
+ */
+uint16_t legConfigAngleToPwm(const ServoPwmLimits_t *limits, float angle);
+
+/**
+ * @brief Sprawdź spójność konfiguracji (kanały bez nakładania, zakresy PWM, offsety)
+ *
+ * Używane przed podpięciem rekordu z flash - błędny rekord nie jest używany.
+ *
+ * @return true Konfiguracja poprawna
+ */
+bool legConfigValidate(const LegConfig_t *config);
+
+#endif // LEG_CONFIG_H
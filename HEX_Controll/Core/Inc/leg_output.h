@@ -0,0 +1,177 @@
+/**
+ * @file leg_output.h
+ * @brief Wspólne wyjście kątów IK na serwa nogi
+ *
+ * @details
+ * Zastępuje trzy kopie setLegJointsWithOffset() z chodów tripod, bipedal
+ * i wave. Przeliczenie dla każdego stawu:
+ * ```
+ * servo = 90° + q [°] (+ offset biodra)  ->  przycięcie 0..180°
+ * pwm   = pwm_min + servo/180 * (pwm_max - pwm_min)
+ * ```
+ * Mapowanie kanałów, offsety i zakresy PWM pochodzą z *leg_config
+ * (domyślne lub skalibrowane w config_store). Kontroler nogi to
+ * urządzenie servo_bus (LegMapping_t::device); pca1/pca2 z argumentów
+ * tylko dopóki servo_bus jest pusty. Trzy kanały nogi idą jedną
+ * transakcją (PCA9685_SetPWMMulti()).
+ *
+ * **Kolejność zapisów w ramce (leg_output_order):**
+ * Swing ma najciaśniejszy czas - oderwanie i przyziemienie muszą wypaść
+ * w swojej ramce, stance zniesie kilka ms opóźnienia. Między
+ * controlFrameBegin() a controlFrameEnd():
+ * - LEG_ORDER_SWING_FIRST - noga oznaczona legOutputMarkSwing() zapisywana
+ *   od razu, nogi stance buforowane i wysyłane w controlFrameEnd()
+ *   (legOutputFlush()) - servoBusFlushFrame(), wszystkie magistrale równolegle,
+ * - LEG_ORDER_CALL - zapis w chwili wywołania, w kolejności chodu.
+ * Poza ramką zapis zawsze od razu.
+ *
+ * **Ramka PWM (servo_frame.h):** w ramce PWM nogi jest liczone od razu
+ * do ServoFrame_t z puli - swing wysyłany z niej, stance czytany z niej
+ * przez servo_bus w flush, flight_rec przepisuje z niej po publikacji.
+ * Pusta pula - nogi zapisywane od razu, jak poza ramką.
+ *
+ * **Stop awaryjny (servo_estop.h):** przy aktywnym zatrzasku zapisy nóg
+ * są odrzucane (false), buforowane nogi stance porzucane w flush.
+ *
+ * **Pomiar:** dla każdego trybu czas od początku ramki do końca zapisu
+ * nogi - osobno w ramce oderwania (pierwsza ramka swing), przyziemienia
+ * (ostatnia ramka swing), wszystkich ramek swing i stance
+ * (legOutputReport(), komenda `order`).
+ */
+
+#ifndef LEG_OUTPUT_H
+#define LEG_OUTPUT_H
+
+#include <stdbool.h>
+#include "pca9685.h"
+#include "leg_config.h"
+#include "hexapod_kinematics.h"
+
+/**
+ * @brief Kolejność zapisów nóg w ramce
+ */
+typedef enum
+{
+    LEG_ORDER_CALL = 0,   ///< Jak wywołuje chód (zapis od razu)
+    LEG_ORDER_SWING_FIRST ///< Swing od razu, stance na koniec ramki
+} LegOutputOrder_t;
+
+/**
+ * @brief Czas od początku ramki do końca zapisu nogi [µs]
+ */
+typedef struct
+{
+    uint32_t count;
+    uint32_t sum_us;
+    uint32_t max_us;
+} LegLatency_t;
+
+/**
+ * @brief Statystyki czasu zapisów dla jednego trybu kolejności
+ */
+typedef struct
+{
+    LegLatency_t lift_off;  ///< Ramka oderwania (pierwsza swing)
+    LegLatency_t touchdown; ///< Ramka przyziemienia (ostatnia swing)
+    LegLatency_t swing;     ///< Wszystkie ramki swing
+    LegLatency_t stance;    ///< Wszystkie ramki stance
+} LegOutputTiming_t;
+
+extern LegOutputOrder_t leg_output_order;
+
+/**
+ * @brief Zarejestruj metryki wyjścia (ik_fail, servo_bus_err)
+ */
+void legOutputInit(void);
+
+/**
+ * @brief Początek ramki - wołane przez controlFrameBegin()
+ */
+void legOutputFrameBegin(void);
+
+/**
+ * @brief Oznacz nogę jako swing w bieżącej ramce (przed jej zapisem)
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ */
+void legOutputMarkSwing(int leg_number);
+
+/**
+ * @brief Wyślij buforowane nogi stance i zamknij pomiar ramki
+ *
+ * Wołane przez controlFrameEnd() przed pomiarem czasu ramki.
+ */
+void legOutputFlush(void);
+
+/**
+ * @brief Odczytaj statystyki czasu zapisów
+ *
+ * @param[in] order Tryb kolejności
+ * @param[out] timing Statystyki
+ */
+void legOutputGetTiming(LegOutputOrder_t order, LegOutputTiming_t *timing);
+
+/**
+ * @brief Wyzeruj statystyki obu trybów
+ */
+void legOutputResetTiming(void);
+
+/**
+ * @brief Wypisz porównanie czasów zapisów obu trybów
+ */
+void legOutputReport(void);
+
+/**
+ * @brief Ustaw trzy serwa nogi z kątów IK
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] q1 Kąt biodra [radiany]
+ * @param[in] q2 Kąt kolana [radiany]
+ * @param[in] q3 Kąt kostki [radiany]
+ * @param[in] pca1 Kontroler urządzenia 0, gdy servo_bus pusty (I2C1)
+ * @param[in] pca2 Kontroler urządzenia 1, gdy servo_bus pusty (I2C2)
+ * @param[in] verbose Wypisz linię z kątami IK i serw (jak dotąd tripod)
+ *
+ * @return false dla złego numeru nogi lub niedostępnego PCA
+ *         (nogi buforowanej - wynik zapisu w flight_rec i servo_bus_err)
+ */
+bool legOutputSetJoints(int leg_number, float q1, float q2, float q3,
+                        PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool verbose);
+
+/**
+ * @brief Ustaw stopę w zadanym punkcie: korekta pozy, IK, serwa
+ *
+ * @details
+ * Pozycja jest najpierw obracana o korektę poziomowania korpusu
+ * (bodyLevelingApply(), bez zmian gdy wyłączone), potem computeLegIK()
+ * i legOutputSetJoints(). Punkt poza zasięgiem IK - serwa bez zmian.
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] x, y, z Pozycja stopy w układzie korpusu [cm]
+ * @param[in] pca1, pca2 Jak w legOutputSetJoints()
+ * @param[in] verbose Jak w legOutputSetJoints()
+ *
+ * @return false gdy IK nie ma rozwiązania lub zapis się nie udał
+ */
+bool legOutputMoveFoot(int leg_number, float x, float y, float z,
+                       PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool verbose);
+
+/**
+ * @brief Ustaw stopy kilku nóg naraz: korekta pozy, IK partii, serwa
+ *
+ * @details
+ * Jak legOutputMoveFoot() dla każdego wpisu, ale kinematyka jednym
+ * computeLegIKBatch() dla wszystkich nóg. Wpis poza zasięgiem IK nie
+ * zatrzymuje pozostałych - jego serwa zostają bez zmian.
+ *
+ * @param[in,out] batch Wpisy (leg, x, y, z); po powrocie cele po korekcie
+ *                      pozy i kąty IK
+ * @param[in] pca1, pca2 Jak w legOutputSetJoints()
+ * @param[in] verbose Jak w legOutputSetJoints()
+ *
+ * @return false gdy któryś wpis nie ma rozwiązania IK lub zapis się nie udał
+ */
+bool legOutputMoveFeet(LegIKBatch_t *batch,
+                       PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool verbose);
+
+#endif // LEG_OUTPUT_H
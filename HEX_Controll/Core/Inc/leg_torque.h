@@ -0,0 +1,126 @@
+/**
+ * @file leg_torque.h
+ * @brief Statyczne momenty w stawach nóg podporowych i budżet serw
+ *
+ * @details
+ * W tripodzie korpus stoi na trzech stopach - to one, nie długość kroku
+ * "na oko", ograniczają krok i wysokość stania. Dla punktu fazy stance:
+ *
+ * 1. **Rozkład ciężaru** - równowaga sił i momentów dla trzech stóp
+ *    (środek masy w początku układu, obciążenie tylko pionowe):
+ *    ```
+ *    | 1  1  1  |   | f1 |   | W |
+ *    | x1 x2 x3 | * | f2 | = | 0 |     W = m·g·dynamic_factor
+ *    | y1 y2 y3 |   | f3 |   | 0 |
+ *    ```
+ *    f_i < 0 oznacza środek masy poza trójkątem podparcia (supported = false).
+ *    Dla innej liczby stóp - równy podział.
+ * 2. **Momenty** - τ = Jᵀ·F, J z computeLegJacobian() [cm/rad],
+ *    F = (0, 0, f_i) [N] (reakcja podłoża w górę):
+ *    `τ_j = J[2][j] · 0.01 · f_i` [N·m]. Biodro przy sile pionowej nie
+ *    jest obciążane (kolumna biodra pozioma).
+ * 3. **Budżet** - `stall_torque_nm · budget_fraction`; wykorzystanie =
+ *    szczytowy |τ| / budżet. MG996R: ~0.92 N·m przy 4.8 V (9.4 kg·cm),
+ *    ~1.08 N·m przy 6 V; serwa zasilane z 5 V.
+ *
+ * Planowanie cyklu (tripod_gait.c) próbkuje tor stance obu grup nóg;
+ * przy przekroczeniu polityka LEG_TORQUE_SCALE zmniejsza krok cyklu
+ * (bisekcja), LEG_TORQUE_FLAG (domyślna) tylko ostrzega. Dominuje moment kolana
+ * w pozycji bazowej - gdy już ona przekracza budżet, krótszy krok nie
+ * pomoże (trzeba zmienić step_height_base albo masę) i krok zostaje.
+ *
+ * Moduł nie zależy od HAL.
+ */
+
+#ifndef LEG_TORQUE_H
+#define LEG_TORQUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Reakcja na przekroczenie budżetu
+ */
+typedef enum
+{
+    LEG_TORQUE_OFF = 0, ///< Bez sprawdzania
+    LEG_TORQUE_FLAG,    ///< Ostrzeżenie, krok bez zmian
+    LEG_TORQUE_SCALE    ///< Krok cyklu zmniejszony do budżetu
+} LegTorquePolicy_t;
+
+/**
+ * @brief Parametry modelu obciążenia
+ */
+typedef struct
+{
+    float body_mass_kg;      ///< Masa robota [kg]
+    float stall_torque_nm;   ///< Moment utyku serwa [N·m]
+    float budget_fraction;   ///< Część momentu utyku dostępna w stance
+    float dynamic_factor;    ///< Zapas na przyspieszenia przy zmianie faz
+    uint8_t samples;         ///< Punkty próbkowania toru stance
+    LegTorquePolicy_t policy; ///< Reakcja na przekroczenie
+} LegTorqueConfig_t;
+
+/**
+ * @brief Wynik oceny (szczyty po wszystkich próbkach i nogach)
+ */
+typedef struct
+{
+    float peak_nm[3];     ///< Szczytowy |τ| biodro, kolano, kostka [N·m]
+    uint8_t peak_leg[3];  ///< Noga ze szczytem dla każdego stawu
+    float max_load_n;     ///< Największe obciążenie stopy [N]
+    float budget_nm;      ///< Budżet momentu [N·m]
+    float utilization;    ///< max(peak_nm) / budget_nm
+    bool supported;       ///< Środek masy w trójkącie podparcia we wszystkich próbkach
+    bool reachable;       ///< IK rozwiązane we wszystkich próbkach
+} LegTorqueReport_t;
+
+extern LegTorqueConfig_t leg_torque_config;
+
+/**
+ * @brief Rozkład ciężaru na stopy podporowe
+ *
+ * @param[in] feet Pozycje stóp [cm] (x, y, z)
+ * @param[in] n Liczba stóp
+ * @param[out] loads_n Obciążenia stóp [N]
+ * @return false gdy środek masy poza podparciem lub stopy współliniowe
+ */
+bool legTorqueSupportLoads(const float feet[][3], int n, float loads_n[]);
+
+/**
+ * @brief Momenty w stawach nogi od pionowej reakcji podłoża
+ *
+ * @param[in] leg_number Numer nogi (1..HEX_LEG_COUNT)
+ * @param[in] foot Pozycja stopy [cm]
+ * @param[in] load_n Reakcja podłoża [N]
+ * @param[out] tau_nm Momenty biodro, kolano, kostka [N·m] (ze znakiem)
+ * @return false gdy IK nie ma rozwiązania
+ */
+bool legTorqueJoint(int leg_number, const float foot[3], float load_n, float tau_nm[3]);
+
+/**
+ * @brief Wyzeruj wynik przed oceną cyklu
+ */
+void legTorqueReportInit(LegTorqueReport_t *report);
+
+/**
+ * @brief Dodaj jedną próbkę fazy stance (stopy podporowe w jednej chwili)
+ *
+ * @param[in,out] report Wynik
+ * @param[in] legs Numery nóg podporowych
+ * @param[in] feet Pozycje ich stóp [cm]
+ * @param[in] n Liczba nóg
+ */
+void legTorqueAccumulate(LegTorqueReport_t *report, const int legs[], const float feet[][3], int n);
+
+/**
+ * @brief Czy wynik mieści się w budżecie (i robot jest podparty)
+ */
+bool legTorqueWithinBudget(const LegTorqueReport_t *report);
+
+/**
+ * @brief Wypisz wynik
+ */
+void legTorquePrint(const LegTorqueReport_t *report);
+
+#endif // LEG_TORQUE_H
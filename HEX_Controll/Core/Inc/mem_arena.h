@@ -0,0 +1,187 @@
+/**
+ * @file mem_arena.h
+ * @brief Statyczne areny i pule o stałym rozmiarze bloku zamiast sterty
+ *
+ * @details
+ * Linker daje stercie tylko _Min_Heap_Size = 0x200 (mem_monitor.h), a
+ * malloc() z newlib na 128 KB SRAM fragmentuje i nie ma górnej granicy
+ * czasu. Tablice torów, kolejki i bufory ramek biorą więc pamięć z
+ * obszarów zarezerwowanych w .bss w czasie kompilacji:
+ *
+ * - **arena** (MemArena_t) - alokacja przesunięciem wskaźnika, zwalnianie
+ *   tylko całości (memArenaReset()); O(1), bez fragmentacji,
+ * - **pula** (MemPool_t) - bloki jednego typu na liście wolnych wewnątrz
+ *   samych bloków; memPoolAlloc()/memPoolFree() O(1), w dowolnej kolejności.
+ *
+ * ```c
+ * MEM_POOL_DEFINE(frame_pool, "frames", ServoFrame_t, 4);
+ * ServoFrame_t *f = MEM_POOL_NEW(&frame_pool, ServoFrame_t);
+ * memPoolFree(&frame_pool, f);
+ * ```
+ *
+ * **Arena chodu (gait_scratch):** stan, który żyje tyle co aktywny chód
+ * (tory stawów tripodu, pozycje nóg bipedal/wave). memScratchGet() daje
+ * blok właściciela; gdy pyta inny chód, arena jest zerowana i oddana
+ * nowemu właścicielowi - zmiana chodu zwalnia wszystko naraz, a stan
+ * poprzedniego chodu i tak był nieaktualny (nogi stoją gdzie indziej).
+ *
+ * **Statystyki:** bieżące i szczytowe zajęcie, liczba alokacji i odmów
+ * (brak miejsca), resety areny. Arena/pula rejestruje się przy pierwszej
+ * alokacji; memArenaReport() lub komenda `mem` na UART.
+ *
+ * Moduł nie zależy od HAL; nie jest bezpieczny dla przerwań - alokować
+ * z pętli głównej.
+ */
+
+#ifndef MEM_ARENA_H
+#define MEM_ARENA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Wyrównanie każdej alokacji [B] (double/uint64_t na Cortex-M4)
+ */
+#define MEM_ARENA_ALIGN 8U
+
+/**
+ * @brief Rozmiar areny chodu [B]
+ *
+ * Tripod: HEX_LEG_COUNT torów JointTrack_t (~64 B każdy).
+ */
+#ifndef MEM_SCRATCH_SIZE
+#define MEM_SCRATCH_SIZE 1024U
+#endif
+
+/**
+ * @brief Maksymalna liczba aren i pul w raporcie
+ */
+#ifndef MEM_ARENA_REGISTRY_MAX
+#define MEM_ARENA_REGISTRY_MAX 8
+#endif
+
+/**
+ * @brief Arena - alokacja przesunięciem, zwalnianie całości
+ */
+typedef struct
+{
+    const char *name;    ///< Nazwa do raportu (literał)
+    uint8_t *base;       ///< Początek obszaru (wyrównany do MEM_ARENA_ALIGN)
+    uint32_t size;       ///< Rozmiar obszaru [B]
+    uint32_t used;       ///< Bieżące zajęcie [B]
+    uint32_t peak;       ///< Szczytowe zajęcie od resetu MCU [B]
+    uint32_t allocs;     ///< Udane alokacje
+    uint32_t fails;      ///< Odmowy (brak miejsca)
+    uint32_t resets;     ///< Wywołania memArenaReset()
+    const void *owner;   ///< Właściciel (arena chodu), NULL = wolna
+    bool registered;
+} MemArena_t;
+
+/**
+ * @brief Pula bloków o stałym rozmiarze
+ */
+typedef struct
+{
+    const char *name;    ///< Nazwa do raportu (literał)
+    uint8_t *base;       ///< Pierwszy blok
+    uint32_t block_size; ///< Rozmiar bloku [B], wielokrotność MEM_ARENA_ALIGN
+    uint16_t blocks;     ///< Liczba bloków
+    uint16_t used;       ///< Bloki wydane
+    uint16_t peak;       ///< Szczyt wydanych bloków
+    uint32_t fails;      ///< Odmowy (pula pusta)
+    void *free_list;     ///< Pierwszy wolny blok (następny w jego pierwszym słowie)
+    bool ready;          ///< Lista wolnych zbudowana (przy pierwszej alokacji)
+} MemPool_t;
+
+/// @cond
+#define MEM_ARENA_ROUND(bytes) (((bytes) + MEM_ARENA_ALIGN - 1U) & ~(MEM_ARENA_ALIGN - 1U))
+/// @endcond
+
+/**
+ * @brief Zdefiniuj arenę (zmienna statyczna pliku) z obszarem w .bss
+ *
+ * @param var Nazwa zmiennej MemArena_t
+ * @param label Nazwa do raportu
+ * @param bytes Rozmiar [B]
+ */
+#define MEM_ARENA_DEFINE(var, label, bytes)                                                       \
+    static uint8_t var##_storage[MEM_ARENA_ROUND(bytes)] __attribute__((aligned(MEM_ARENA_ALIGN))); \
+    static MemArena_t var = {.name = (label), .base = var##_storage, .size = sizeof(var##_storage)}
+
+/**
+ * @brief Zdefiniuj pulę bloków typu @p type (zmienna statyczna pliku) z obszarem w .bss
+ *
+ * @param var Nazwa zmiennej MemPool_t
+ * @param label Nazwa do raportu
+ * @param type Typ bloku
+ * @param count Liczba bloków
+ */
+#define MEM_POOL_DEFINE(var, label, type, count)                                                          \
+    static uint8_t var##_storage[(count) * MEM_ARENA_ROUND(sizeof(type))]                                 \
+        __attribute__((aligned(MEM_ARENA_ALIGN)));                                                        \
+    static MemPool_t var = {.name = (label), .base = var##_storage,                                      \
+                            .block_size = MEM_ARENA_ROUND(sizeof(type)), .blocks = (count)}
+
+/**
+ * @brief Tablica @p count elementów typu @p type z areny (NULL gdy brak miejsca)
+ */
+#define MEM_ARENA_NEW(arena, type, count) ((type *)memArenaAlloc((arena), sizeof(type) * (count)))
+
+/**
+ * @brief Blok typu @p type z puli (NULL gdy pusta)
+ */
+#define MEM_POOL_NEW(pool, type) ((type *)memPoolAlloc((pool)))
+
+/**
+ * @brief Arena chodu - patrz memScratchGet()
+ */
+extern MemArena_t gait_scratch;
+
+/**
+ * @brief Zaalokuj @p size bajtów (wyrównanie MEM_ARENA_ALIGN)
+ *
+ * @return Wskaźnik lub NULL gdy brak miejsca (licznik fails)
+ */
+void *memArenaAlloc(MemArena_t *arena, size_t size);
+
+/**
+ * @brief Zwolnij wszystkie alokacje areny naraz
+ */
+void memArenaReset(MemArena_t *arena);
+
+/**
+ * @brief Weź blok z puli
+ *
+ * @return Blok (niezerowany) lub NULL gdy pula pusta (licznik fails)
+ */
+void *memPoolAlloc(MemPool_t *pool);
+
+/**
+ * @brief Oddaj blok do puli
+ *
+ * @return false gdy @p block nie jest blokiem tej puli (nic nie zmienione)
+ */
+bool memPoolFree(MemPool_t *pool, void *block);
+
+/**
+ * @brief Blok stanu chodu w gait_scratch
+ *
+ * @details
+ * Ten sam @p owner dostaje ten sam blok (stan przeżywa cykle chodu).
+ * Inny właściciel - arena jest resetowana i nowy blok wyzerowany.
+ *
+ * @param[in] owner Adres identyfikujący chód (np. jego zmienna statyczna)
+ * @param[in] size Rozmiar stanu [B] - stały dla danego właściciela
+ * @param[out] fresh true gdy blok jest nowy (wyzerowany), może być NULL
+ *
+ * @return Blok lub NULL gdy size > MEM_SCRATCH_SIZE
+ */
+void *memScratchGet(const void *owner, size_t size, bool *fresh);
+
+/**
+ * @brief Wypisz zajęcie wszystkich użytych aren i pul
+ */
+void memArenaReport(void);
+
+#endif // MEM_ARENA_H
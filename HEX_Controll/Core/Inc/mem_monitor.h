@@ -0,0 +1,94 @@
+/**
+ * @file mem_monitor.h
+ * @brief Pomiar zużycia stosu i sterty (high-water mark)
+ *
+ * @details
+ * Układ RAM (STM32F446XX_FLASH.ld):
+ * ```
+ * | .data | .bss | sterta newlib -> ...wolne... <- stos MSP | _estack
+ *                ^ _end                          ^ _estack - _Min_Stack_Size
+ * ```
+ * Linker rezerwuje tylko _Min_Heap_Size = 0x200 i _Min_Stack_Size = 0x400,
+ * a printf z floatami wołany z IK i pętli chodu potrafi zejść głęboko.
+ *
+ * **Metoda:**
+ * - memMonitorPaintStack() na początku main() wypełnia wolny RAM między
+ *   stertą a bieżącym SP wzorcem MEM_PAINT_PATTERN,
+ * - memMonitorSample() szuka od dołu pierwszego nadpisanego słowa - to
+ *   najgłębszy punkt, do którego kiedykolwiek zszedł stos,
+ * - stertę śledzi _sbrk() w sysmem.c (bieżący i maksymalny koniec).
+ *
+ * **Zapasy i ostrzeżenia:**
+ * - stack_margin: rezerwa _Min_Stack_Size minus szczyt stosu,
+ * - heap_margin: _Min_Heap_Size minus szczyt sterty,
+ * - gap: najmniejsza odległość między szczytem sterty a dnem stosu -
+ *   rzeczywisty zapas RAM, gdy rezerwy są przekroczone.
+ *
+ * memMonitorCheck() wypisuje ostrzeżenie, gdy któryś zapas spadnie
+ * poniżej MEM_MONITOR_WARN_BYTES (raz na każde nowe minimum).
+ *
+ * @note Skan kosztuje ~1 cykl/bajt wolnego RAM - wołać między cyklami
+ *       chodu, nie w pętli interpolacji.
+ */
+
+#ifndef MEM_MONITOR_H
+#define MEM_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Wzorzec wypełnienia wolnego RAM
+ */
+#define MEM_PAINT_PATTERN 0xC5A5C5A5U
+
+/**
+ * @brief Próg ostrzeżenia dla zapasów stosu, sterty i luki [B]
+ */
+#ifndef MEM_MONITOR_WARN_BYTES
+#define MEM_MONITOR_WARN_BYTES 256
+#endif
+
+/**
+ * @brief Stan pamięci (wartości w bajtach)
+ */
+typedef struct
+{
+    uint32_t stack_reserved; ///< _Min_Stack_Size
+    uint32_t stack_peak;     ///< Najgłębsze zejście stosu od resetu
+    int32_t stack_margin;    ///< stack_reserved - stack_peak (ujemne = przekroczone)
+    uint32_t heap_reserved;  ///< _Min_Heap_Size
+    uint32_t heap_used;      ///< Bieżący rozmiar sterty (_sbrk)
+    uint32_t heap_peak;      ///< Maksymalny rozmiar sterty od resetu
+    int32_t heap_margin;     ///< heap_reserved - heap_peak (ujemne = przekroczone)
+    uint32_t gap;            ///< Najmniejsza odległość sterta <-> stos
+} MemStats_t;
+
+/**
+ * @brief Wypełnij wolny RAM wzorcem (pierwsza instrukcja w main())
+ *
+ * Maluje obszar od końca sterty do SP minus mały margines na własną ramkę.
+ */
+void memMonitorPaintStack(void);
+
+/**
+ * @brief Odczytaj bieżący stan stosu i sterty
+ *
+ * @param[out] stats Wynik pomiaru
+ */
+void memMonitorSample(MemStats_t *stats);
+
+/**
+ * @brief Sprawdź zapasy i ostrzeż przez printf, jeśli spadły poniżej progu
+ *
+ * @return true  Wszystkie zapasy >= MEM_MONITOR_WARN_BYTES
+ * @return false Któryś zapas poniżej progu (ostrzeżenie wypisane przy nowym minimum)
+ */
+bool memMonitorCheck(void);
+
+/**
+ * @brief Wypisz pełny raport pamięci
+ */
+void memMonitorReport(void);
+
+#endif // MEM_MONITOR_H
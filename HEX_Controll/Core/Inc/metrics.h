@@ -0,0 +1,151 @@
+/**
+ * @file metrics.h
+ * @brief Rejestr nazwanych metryk: liczniki, wskaźniki, histogramy
+ *
+ * @details
+ * Zamiast jednorazowych printf ("Faza 1 wykonana w ... ms") moduły
+ * rejestrują metryki raz, przy inicjalizacji, i aktualizują je przez
+ * zwrócony wskaźnik:
+ *
+ * ```c
+ * static Metric_t *m_ik_fail;
+ * m_ik_fail = metricsRegisterCounter("ik_fail", NULL);   // init
+ * metricInc(m_ik_fail);                                   // hot path: 1 inkrementacja
+ * ```
+ *
+ * **Typy:**
+ * - licznik - uint32_t, tylko rośnie (błędy, zdarzenia),
+ * - wskaźnik - float, ostatnia wartość (częstotliwość ramek, % bezczynności),
+ * - histogram - stałe kubełki `<= bounds[i]` + ostatni `> bounds[n-1]`,
+ *   do tego liczba, suma i maksimum (czasy cykli i ramek).
+ *
+ * **Koszt:** metricInc()/metricAdd()/metricSet() są inline - jedna
+ * instrukcja plus test NULL (rejestr pełny -> metryka po prostu nie
+ * działa). metricObserve() przechodzi po max METRIC_HIST_BUCKETS - 1
+ * granicach. Rejestr jest statyczny (METRICS_MAX wpisów), bez sterty.
+ *
+ * Rejestracja istniejącej nazwy zwraca ten sam wpis. Zrzut: metricsDump()
+ * lub komenda `metrics` na UART (serial_cmd.h).
+ *
+ * Moduł nie zależy od HAL.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Maksymalna liczba metryk w rejestrze
+ */
+#ifndef METRICS_MAX
+#define METRICS_MAX 32
+#endif
+
+/**
+ * @brief Maksymalna liczba kubełków histogramu (granice + 1)
+ */
+#define METRIC_HIST_BUCKETS 8
+
+/**
+ * @brief Typ metryki
+ */
+typedef enum
+{
+    METRIC_COUNTER = 0, ///< Licznik zdarzeń
+    METRIC_GAUGE,       ///< Ostatnia wartość
+    METRIC_HISTOGRAM    ///< Rozkład wartości w stałych kubełkach
+} MetricType_t;
+
+/**
+ * @brief Wpis rejestru
+ */
+typedef struct
+{
+    const char *name;       ///< Nazwa (literał - rejestr trzyma wskaźnik)
+    const char *unit;       ///< Jednostka do zrzutu lub NULL
+    MetricType_t type;      ///< Typ
+    uint8_t n_bounds;       ///< Liczba granic histogramu
+    const uint32_t *bounds; ///< Rosnące górne granice kubełków (histogram)
+    uint32_t count;         ///< Licznik / liczba próbek histogramu
+    float gauge;            ///< Wartość wskaźnika
+    uint32_t sum;           ///< Suma próbek histogramu
+    uint32_t max;           ///< Maksimum próbek histogramu
+    uint32_t buckets[METRIC_HIST_BUCKETS]; ///< Liczności kubełków
+} Metric_t;
+
+/**
+ * @brief Zarejestruj licznik
+ *
+ * @param[in] name Nazwa (literał)
+ * @param[in] unit Jednostka lub NULL
+ * @return Wpis lub NULL gdy rejestr pełny / nazwa zajęta przez inny typ
+ */
+Metric_t *metricsRegisterCounter(const char *name, const char *unit);
+
+/**
+ * @brief Zarejestruj wskaźnik
+ */
+Metric_t *metricsRegisterGauge(const char *name, const char *unit);
+
+/**
+ * @brief Zarejestruj histogram
+ *
+ * @param[in] name Nazwa (literał)
+ * @param[in] unit Jednostka lub NULL
+ * @param[in] bounds Rosnące górne granice kubełków (tablica stała)
+ * @param[in] n_bounds Liczba granic (1..METRIC_HIST_BUCKETS - 1)
+ */
+Metric_t *metricsRegisterHistogram(const char *name, const char *unit,
+                                   const uint32_t *bounds, uint8_t n_bounds);
+
+/**
+ * @brief Znajdź metrykę po nazwie
+ */
+Metric_t *metricsFind(const char *name);
+
+/**
+ * @brief Dodaj próbkę do histogramu
+ */
+void metricObserve(Metric_t *metric, uint32_t value);
+
+/**
+ * @brief Wyzeruj wartości wszystkich metryk (rejestracje zostają)
+ */
+void metricsReset(void);
+
+/**
+ * @brief Wypisz wszystkie metryki
+ */
+void metricsDump(void);
+
+/**
+ * @brief Zwiększ licznik o 1
+ */
+static inline void metricInc(Metric_t *metric)
+{
+    if (metric != NULL)
+        metric->count++;
+}
+
+/**
+ * @brief Zwiększ licznik o n
+ */
+static inline void metricAdd(Metric_t *metric, uint32_t n)
+{
+    if (metric != NULL)
+        metric->count += n;
+}
+
+/**
+ * @brief Ustaw wartość wskaźnika
+ */
+static inline void metricSet(Metric_t *metric, float value)
+{
+    if (metric != NULL)
+        metric->gauge = value;
+}
+
+#endif // METRICS_H
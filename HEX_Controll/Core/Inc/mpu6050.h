@@ -0,0 +1,83 @@
+/**
+ * @file mpu6050.h
+ * @brief Sterownik MPU-6050 (akcelerometr + żyroskop) dla STM32 HAL
+ *
+ * @details
+ * Minimalny sterownik dla poziomowania korpusu: wybudzenie, zakresy
+ * i filtr, odczyt wszystkich osi jednym transferem.
+ *
+ * **Połączenie:** I2C1 razem z PCA9685 #1 (lewe nogi), adres 0x68
+ * (AD0 = GND) - nie koliduje z 0x40 ani z adresem ALL_CALL 0x70.
+ *
+ * **Konfiguracja:**
+ * | Rejestr | Wartość | Znaczenie |
+ * |---------|---------|-----------|
+ * | PWR_MGMT_1 | 0x01 | wybudzenie, zegar z PLL żyroskopu X |
+ * | CONFIG | 0x03 | DLPF 44 Hz (akcelerometr i żyroskop) |
+ * | SMPLRT_DIV | 0x09 | próbkowanie 100 Hz (1 kHz / 10) |
+ * | GYRO_CONFIG | 0x08 | ±500 °/s, 65.5 LSB/(°/s) |
+ * | ACCEL_CONFIG | 0x00 | ±2 g, 16384 LSB/g |
+ *
+ * Odczyt: 14 bajtów od ACCEL_XOUT_H (akcelerometr, temperatura,
+ * żyroskop) - ~0.4 ms przy 400 kHz, blokujący.
+ *
+ * @warning Transfer zajmuje I2C1 - wołać między zapisami ramek serw
+ *          (control_frame.h), nie w trakcie ustawiania nóg.
+ */
+
+#ifndef MPU6050_H
+#define MPU6050_H
+
+#include "stm32f4xx_hal.h"
+#include "imu.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Adres I2C (7-bit, AD0 = GND)
+ */
+#define MPU6050_ADDRESS 0x68
+
+/**
+ * @brief Rejestry MPU-6050
+ */
+///@{
+#define MPU6050_SMPLRT_DIV 0x19
+#define MPU6050_CONFIG 0x1A
+#define MPU6050_GYRO_CONFIG 0x1B
+#define MPU6050_ACCEL_CONFIG 0x1C
+#define MPU6050_ACCEL_XOUT_H 0x3B
+#define MPU6050_PWR_MGMT_1 0x6B
+#define MPU6050_WHO_AM_I 0x75
+///@}
+
+#define MPU6050_WHO_AM_I_VALUE 0x68 ///< Oczekiwana wartość WHO_AM_I
+#define MPU6050_ACCEL_LSB_PER_G 16384.0f
+#define MPU6050_GYRO_LSB_PER_DPS 65.5f
+
+/**
+ * @brief Uchwyt czujnika
+ */
+typedef struct
+{
+    I2C_HandleTypeDef *hi2c; ///< Magistrala I2C
+    uint8_t address;         ///< Adres 7-bit
+    bool ready;              ///< Inicjalizacja zakończona
+} MPU6050_Handle_t;
+
+/**
+ * @brief Sprawdź WHO_AM_I i skonfiguruj czujnik
+ *
+ * @return false Brak układu lub błąd I2C
+ */
+bool MPU6050_Init(MPU6050_Handle_t *handle, I2C_HandleTypeDef *hi2c, uint8_t address);
+
+/**
+ * @brief Odczytaj akcelerometr i żyroskop (jeden transfer 14 bajtów)
+ *
+ * @param[out] sample Wartości w [g] i [°/s]
+ * @return false Błąd I2C lub czujnik niezainicjalizowany
+ */
+bool MPU6050_Read(MPU6050_Handle_t *handle, ImuSample_t *sample);
+
+#endif // MPU6050_H
@@ -8,6 +8,7 @@
  *
  * **Kluczowe funkcje:**
  * - Dual I2C support (I2C1 + I2C2)
+ * - Zapis serii kanałów w trybie przerwań - magistrale nadają równolegle (servo_bus.h)
  * - Sprawdzone wartości PWM dla MG996R
  * - Inicjalizacja bez software reset (stabilność)
  * - Precyzyjne ustawienie częstotliwości 50Hz
@@ -101,6 +102,8 @@
 #define PCA9685_MODE1 0x00	   ///< Rejestr trybu 1 (auto-increment, sleep)
 #define PCA9685_PRESCALE 0xFE  ///< Prescaler częstotliwości PWM
 #define PCA9685_LED0_ON_L 0x06 ///< Pierwszy rejestr kanału LED0 (ON_L)
+#define PCA9685_ALL_LED_OFF_H 0xFD ///< OFF_H wszystkich kanałów naraz (zapis do wszystkich LEDn_OFF_H)
+#define PCA9685_LED_FULL 0x10      ///< Bit 4 w ON_H/OFF_H: kanał całkowicie włączony/wyłączony
 ///@}
 
 /**
@@ -303,6 +306,45 @@ bool PCA9685_TestPWMRange(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pw
  */
 bool PCA9685_SetPWM(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pwm_value);
 
+/**
+ * @brief Ustawienie kilku kolejnych kanałów w jednej transakcji I2C
+ *
+ * @details
+ * Korzysta z auto-inkrementacji adresu (MODE1 = 0x20 z PCA9685_Init()):
+ * 4 rejestry na kanał, kanały first_channel..first_channel+count-1.
+ * Dla nogi (3 kanały) to 1 transakcja zamiast 3 - 14 bajtów na linii
+ * zamiast 18, mniej start/stop i adresowania.
+ *
+ * @param[in] handle Wskaźnik na zainicjalizowany handel PCA9685
+ * @param[in] first_channel Pierwszy kanał (0-15)
+ * @param[in] pwm_values Wartości PWM (0-4095, automatycznie ograniczane)
+ * @param[in] count Liczba kanałów (1-16, first_channel + count <= 16)
+ *
+ * @return false Błąd parametrów lub komunikacji I2C
+ */
+bool PCA9685_SetPWMMulti(PCA9685_Handle_t *handle, uint8_t first_channel,
+                         const uint16_t *pwm_values, uint8_t count);
+
+/**
+ * @brief Ta sama transakcja co PCA9685_SetPWMMulti(), w trybie przerwań
+ *
+ * @details
+ * Funkcja tylko startuje transfer (HAL_I2C_Mem_Write_IT()) i wraca od razu -
+ * kilka magistral może nadawać jednocześnie. Koniec zgłasza
+ * HAL_I2C_MemTxCpltCallback() albo HAL_I2C_ErrorCallback() (servo_bus.c).
+ * Wymaga włączonych przerwań EV/ER magistrali.
+ *
+ * @param[in] handle Wskaźnik na zainicjalizowany handel PCA9685
+ * @param[in] first_channel Pierwszy kanał (0-15)
+ * @param[in] pwm_values Wartości PWM (0-4095, automatycznie ograniczane)
+ * @param[in] count Liczba kanałów (1-16, first_channel + count <= 16)
+ * @param[out] tx_buffer Bufor nadawczy, 4 * count bajtów - ważny do końca transferu
+ *
+ * @return false Błąd parametrów albo magistrala zajęta (HAL_BUSY)
+ */
+bool PCA9685_SetPWMMultiIT(PCA9685_Handle_t *handle, uint8_t first_channel,
+                           const uint16_t *pwm_values, uint8_t count, uint8_t *tx_buffer);
+
 /**
  * @brief Całkowite wylączenie kanału PWM
  *
@@ -328,6 +370,50 @@ bool PCA9685_SetPWM(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pwm_valu
  */
 bool PCA9685_SetChannelOff(PCA9685_Handle_t *handle, uint8_t channel);
 
+/**
+ * @brief Wyłącz wszystkie kanały jedną krótką transakcją - także z przerwania
+ *
+ * @details
+ * Zapis PCA9685_LED_FULL do ALL_LED_OFF_H: adres + rejestr + 1 bajt
+ * (~90 us przy 100 kHz) zamiast 16 transakcji PCA9685_SetChannelOff().
+ * Serwa tracą sygnał i przestają trzymać pozycję.
+ *
+ * Nie używa HAL ani HAL_GetTick() - bezpośrednio rejestry I2C z limitem
+ * w cyklach DWT, więc działa w ISR o priorytecie wyższym niż SysTick.
+ * Trwający na magistrali transfer (servo_bus w trybie przerwań albo
+ * blokujący zapis w pętli głównej) jest przerywany warunkiem STOP, a
+ * stan handle HAL wraca do READY - przerwany zapis kończy się błędem.
+ *
+ * Każdy późniejszy zapis kanału (LEDn_OFF_H bez bitu 4) włącza go znowu -
+ * zapisy blokuje PCA9685_LockOutputs() (servo_estop.h).
+ *
+ * @param[in] handle Wskaźnik na zainicjalizowany handel PCA9685
+ * @param[in] timeout_cycles Limit całej transakcji [cykle DWT]; gdy CYCCNT
+ *                           stoi (brak dwtTimerInit()), ten sam limit
+ *                           w przebiegach pętli oczekiwania
+ *
+ * @return false Brak ACK, magistrala zablokowana lub przekroczony limit
+ */
+bool PCA9685_AllOffFromISR(PCA9685_Handle_t *handle, uint32_t timeout_cycles);
+
+/**
+ * @brief Zablokuj/odblokuj zapisy kanałów na wszystkich kontrolerach
+ *
+ * @details
+ * Przy blokadzie PCA9685_SetPWM(), PCA9685_SetPWMMulti() i
+ * PCA9685_SetPWMMultiIT() - a przez nie każdy zapis kąta - zwracają false
+ * bez transakcji I2C, więc kanały wyłączone przez PCA9685_AllOffFromISR()
+ * zostają wyłączone. Bezpieczne w ISR; ustawiane przez servo_estop.h.
+ *
+ * @param[in] locked true = odrzucaj zapisy
+ */
+void PCA9685_LockOutputs(bool locked);
+
+/**
+ * @brief Czy zapisy kanałów są zablokowane (PCA9685_LockOutputs())
+ */
+bool PCA9685_OutputsLocked(void);
+
 /** @} */ // end of PCA9685_Functions
 
 /**
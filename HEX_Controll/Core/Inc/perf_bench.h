@@ -0,0 +1,68 @@
+/**
+ * @file perf_bench.h
+ * @brief Pomiar czasu ramki chodu przy starcie (profil Performance)
+ *
+ * @details
+ * Po inicjalizacji PCA9685 mierzy licznikiem DWT koszt jednej ramki
+ * chodu trójpodporowego, rozbity na dwie części:
+ *
+ * - **obliczenia**: computeLegIK() + mapowanie kątów na PWM dla 6 nóg,
+ *   po pełnym cyklu swing/stance (te same punkty co tripodGaitCycle()),
+ * - **magistrala**: 18 transakcji po 4 bajty na rejestrach kanałów
+ *   (odczyt zamiast zapisu - serwa się nie ruszają, czas na linii
+ *   I2C jest taki sam jak dla PCA9685_SetPWM()).
+ *
+ * Dodatkowo porównuje computeLegIK() z SRAM (HOT_FUNC) z kopią we flash
+ * przy pełnym ART, samym I-cache i bez ART (patrz hot_path.h).
+ *
+ * Wynik (min/śr/max µs oraz maksymalna częstotliwość ramek) trafia
+ * na UART, więc każdy build Performance od razu pokazuje, czy zmiana
+ * flag kompilatora przyspieszyła pętlę sterowania.
+ *
+ * **Kompilacja:**
+ * HEX_PERF_BENCHMARK=1 (domyślnie w buildzie Performance) włącza pomiar
+ * w main.c. Przy 0 perf_bench.c kompiluje się do pustego modułu.
+ */
+
+#ifndef PERF_BENCH_H
+#define PERF_BENCH_H
+
+#include "pca9685.h"
+#include <stdint.h>
+
+#ifndef HEX_PERF_BENCHMARK
+#define HEX_PERF_BENCHMARK 0
+#endif
+
+/**
+ * @brief Liczba powtórzeń pełnego cyklu chodu w pomiarze obliczeń
+ */
+#ifndef PERF_BENCH_CYCLES
+#define PERF_BENCH_CYCLES 10
+#endif
+
+/**
+ * @brief Wynik pomiaru (czasy w cyklach rdzenia)
+ */
+typedef struct
+{
+    uint32_t compute_min; ///< Najkrótsza ramka - obliczenia
+    uint32_t compute_max; ///< Najdłuższa ramka - obliczenia
+    uint32_t compute_avg; ///< Średnia ramka - obliczenia
+    uint32_t bus_avg;     ///< Średni czas transakcji I2C na ramkę (obie magistrale)
+    uint32_t frames;      ///< Liczba zmierzonych ramek
+    uint32_t ik_failures; ///< Punkty, dla których IK zwróciło false
+} PerfBenchResult_t;
+
+/**
+ * @brief Zmierz czas ramki i wypisz raport przez printf
+ *
+ * @param[in] pca1 PCA9685 lewej strony (I2C1), może być NULL
+ * @param[in] pca2 PCA9685 prawej strony (I2C2), może być NULL
+ * @param[out] result Wynik pomiaru (może być NULL)
+ *
+ * @note Trwa kilkadziesiąt ms, wywoływać przed rozpoczęciem chodu
+ */
+void perfBenchmarkRun(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, PerfBenchResult_t *result);
+
+#endif // PERF_BENCH_H
@@ -0,0 +1,119 @@
+/**
+ * @file robot_description.h
+ * @brief Opis robota: liczba nóg i wszystkie dane per noga w jednej tabeli
+ *
+ * @details
+ * Wcześniej szóstka była wpisana w leg_origins[6], base_positions[6][3]
+ * każdego chodu, leg_current_y[6], wave_sequence, leg_pairs, grupy tripodu
+ * i sprawdzenia `leg_number > 6`. Teraz jedna tabela ROBOT_LEG_TABLE,
+ * z której powstają:
+ *
+ * | Dane                               | Moduł                        |
+ * |------------------------------------|------------------------------|
+ * | origin biodra, inwersje            | robot_geometry_default (IK)  |
+ * | kontroler, kanał, offset biodra    | leg_config_default           |
+ * | pozycja bazowa, grupa tripodu      | robot_description (chody)    |
+ * | HEX_LEG_COUNT                      | rozmiary tablic, pętle       |
+ *
+ * Chody wyznaczają z tabeli grupy tripodu, pary bipedal
+ * (noga i, i + N/2), kolejność wave (1..N), przód/tył przy obrocie
+ * (znak y pozycji bazowej).
+ *
+ * **Inny robot:** własny nagłówek z ROBOT_LEG_TABLE i ROBOT_STANCE_Z,
+ * podany przy kompilacji: `-DHEX_ROBOT_DESCRIPTION=\"robot_quad.h\"`.
+ * Kolejność wierszy: lewa, prawa, lewa, ...
+ *
+ * Moduł nie zależy od HAL - używają go też narzędzia hosta (Tools/).
+ */
+
+#ifndef ROBOT_DESCRIPTION_H
+#define ROBOT_DESCRIPTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef HEX_ROBOT_DESCRIPTION
+#include HEX_ROBOT_DESCRIPTION
+#else
+
+/**
+ * @brief Tabela nóg hexapoda (origin'y z URDF, pozycje bazowe z ROS)
+ *
+ * X(origin_x, origin_y, right, stance_x, stance_y, wave_x, wave_y, group, device, channel, hip_offset_deg)
+ * - origin [cm] względem centrum, right - inwersja biodra i kolana
+ * - stance - pozycja bazowa stopy tripod/bipedal [cm], wave - bliżej korpusu
+ * - group - grupa tripodu (0 = A, 1 = B)
+ * - device, channel, hip_offset_deg - jak LegMapping_t
+ */
+#define ROBOT_LEG_TABLE(X)                                                                                 \
+    X(6.8956f, -7.7136f, false, 18.0f, -15.0f, 15.0f, -12.0f, 0, 0, 0, 37.5f)   /* 1 - lewa przednia */    \
+    X(-8.6608f, -7.7136f, true, -18.0f, -15.0f, -15.0f, -12.0f, 1, 1, 0, -37.5f) /* 2 - prawa przednia */   \
+    X(10.1174f, 0.0645f, false, 22.0f, 0.0f, 18.0f, 0.0f, 1, 0, 3, 0.0f)        /* 3 - lewa środkowa */    \
+    X(-11.8826f, -0.0645f, true, -22.0f, 0.0f, -18.0f, 0.0f, 0, 1, 3, 0.0f)     /* 4 - prawa środkowa */   \
+    X(6.8956f, 7.8427f, false, 18.0f, 15.0f, 15.0f, 12.0f, 0, 0, 6, -37.5f)     /* 5 - lewa tylna */       \
+    X(-8.6608f, 7.8427f, true, -18.0f, 15.0f, -15.0f, 12.0f, 1, 1, 6, 37.5f)    /* 6 - prawa tylna */
+
+/**
+ * @brief Wysokość stania (z pozycji bazowych) [cm]
+ */
+#define ROBOT_STANCE_Z -24.0f
+
+#endif // HEX_ROBOT_DESCRIPTION
+
+#define ROBOT_LEG_COUNT_ONE(...) +1
+
+/**
+ * @brief Liczba nóg - liczba wierszy ROBOT_LEG_TABLE
+ */
+#define HEX_LEG_COUNT (0 ROBOT_LEG_TABLE(ROBOT_LEG_COUNT_ONE))
+
+/**
+ * @brief Maska nóg: bit (numer_nogi - 1)
+ */
+typedef uint32_t LegMask_t;
+
+#define LEG_BIT(leg_number) ((LegMask_t)1U << ((leg_number) - 1))
+
+_Static_assert(HEX_LEG_COUNT >= 2 && HEX_LEG_COUNT <= 32, "robot_description: 2..32 nóg (LegMask_t)");
+_Static_assert(HEX_LEG_COUNT % 2 == 0, "robot_description: nogi parami lewa/prawa");
+
+/**
+ * @brief Dane chodów per noga (struktura tablic - pętle bez kodu per noga)
+ */
+typedef struct
+{
+    float stance_x[HEX_LEG_COUNT]; ///< Pozycja bazowa stopy tripod/bipedal [cm]
+    float stance_y[HEX_LEG_COUNT];
+    float wave_x[HEX_LEG_COUNT]; ///< Pozycja bazowa wave [cm]
+    float wave_y[HEX_LEG_COUNT];
+    uint8_t group[HEX_LEG_COUNT]; ///< Grupa tripodu 0/1
+    bool right[HEX_LEG_COUNT];    ///< Prawa strona korpusu
+} RobotDescription_t;
+
+extern const RobotDescription_t robot_description;
+
+/**
+ * @brief Czy numer nogi mieści się w 1..HEX_LEG_COUNT
+ */
+static inline bool legNumberValid(int leg_number)
+{
+    return leg_number >= 1 && leg_number <= HEX_LEG_COUNT;
+}
+
+/**
+ * @brief Nogi grupy tripodu w kolejności numerów
+ *
+ * @param[in] group Grupa (0 = A, 1 = B)
+ * @param[out] legs Numery nóg (HEX_LEG_COUNT miejsc)
+ * @return Liczba nóg w grupie
+ */
+int robotGroupLegs(uint8_t group, int legs[HEX_LEG_COUNT]);
+
+/**
+ * @brief Rząd nogi wzdłuż korpusu z pozycji bazowej
+ *
+ * @return -1 = przód (y < 0), 1 = tył (y > 0), 0 = środek
+ */
+int robotLegRow(int leg_number);
+
+#endif // ROBOT_DESCRIPTION_H
@@ -0,0 +1,78 @@
+/**
+ * @file serial_cmd.h
+ * @brief Komendy tekstowe przez UART2 (ST-LINK VCP, 115200)
+ *
+ * @details
+ * Odbiór znak po znaku w przerwaniu USART2 do bufora kołowego, parsowanie
+ * linii w serialCmdPoll() - w kontekście głównej pętli, nigdy w ISR.
+ * Wypisanie odpowiedzi trwa (printf blokujący, ~87 µs/znak), więc
+ * serialCmdPoll() wołać między cyklami chodu, nie w pętli interpolacji.
+ *
+ * **Komendy wbudowane:**
+ * | Komenda         | Działanie                          |
+ * |-----------------|------------------------------------|
+ * | `help`          | lista komend                       |
+ * | `metrics`       | zrzut rejestru metryk (metrics.h)  |
+ * | `metrics reset` | wyzerowanie metryk                 |
+ * | `frame`         | raport ramek i poziomowania        |
+ * | `feet`          | stan kontaktu stóp                 |
+ * | `mem`           | stos/sterta                        |
+ * | `rec`           | rejestrator ostatnich ramek (CSV)  |
+ * | `torque`        | momenty stawów w stance tripodu    |
+ * | `order`         | kolejność zapisów nóg (call/swing) |
+ *
+ * Inne moduły dopisują komendy przez serialCmdRegister().
+ */
+
+#ifndef SERIAL_CMD_H
+#define SERIAL_CMD_H
+
+#include "stm32f4xx_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Maksymalna liczba komend
+ */
+#define SERIAL_CMD_MAX 16
+
+/**
+ * @brief Maksymalna długość linii (bez terminatora)
+ */
+#define SERIAL_CMD_LINE_MAX 48
+
+/**
+ * @brief Obsługa komendy
+ *
+ * @param[in] args Reszta linii po nazwie (bez wiodących spacji, może być "")
+ */
+typedef void (*SerialCmdHandler_t)(const char *args);
+
+/**
+ * @brief Włącz odbiór w przerwaniu i zarejestruj komendy wbudowane
+ *
+ * @param[in] huart UART konsoli (huart2)
+ */
+void serialCmdInit(UART_HandleTypeDef *huart);
+
+/**
+ * @brief Dodaj komendę
+ *
+ * @param[in] name Nazwa (literał, pierwsze słowo linii)
+ * @param[in] help Opis do `help` (literał)
+ * @param[in] handler Obsługa
+ * @return false gdy tablica pełna
+ */
+bool serialCmdRegister(const char *name, const char *help, SerialCmdHandler_t handler);
+
+/**
+ * @brief Wykonaj komendy z odebranych pełnych linii
+ */
+void serialCmdPoll(void);
+
+/**
+ * @brief Czekaj ms, obsługując komendy (zamiast HAL_Delay() w pętli głównej)
+ */
+void serialCmdWait(uint32_t ms);
+
+#endif // SERIAL_CMD_H
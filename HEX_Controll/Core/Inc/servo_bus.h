@@ -0,0 +1,154 @@
+/**
+ * @file servo_bus.h
+ * @brief Kontrolery PCA9685 na magistralach I2C i równoległy zapis ramki
+ *
+ * @details
+ * Zamiast dwóch kontrolerów na sztywno (pca1 = lewe nogi, pca2 = prawe)
+ * tablica urządzeń: każdy PCA9685 dopisany servoBusAddDevice() dostaje
+ * indeks (LegMapping_t::device), a magistralę wyznacza jego hi2c.
+ * Na jednej magistrali może być kilka kontrolerów (różne adresy).
+ *
+ * **Zapis ramki:**
+ * ```
+ * ServoFrame_t::pending[dev]  <- leg_output (servo_frame.h)
+ * servoBusFlushFrame(ramka):
+ *   każda magistrala równolegle (przerwania), na magistrali po kolei:
+ *     urządzenie -> ciągłe serie kanałów pending -> 1 transakcja na serię
+ *   czekaj na wszystkie magistrale
+ * ```
+ * PWM jest kodowane do transakcji prosto z ramki (bez kopii do bufora
+ * magistrali); servo_bus trzyma dzierżawę ramki do końca flush.
+ * Czas flush to czas najbardziej obciążonej magistrali, nie suma
+ * wszystkich serw. Sąsiednie nogi na jednym kontrolerze (kanały 0-8)
+ * idą jedną transakcją (auto-inkrementacja PCA9685).
+ *
+ * Zapis natychmiastowy (servoBusWrite()) - blokujący, jak dotąd
+ * PCA9685_SetPWMMulti(); używa go swing w LEG_ORDER_SWING_FIRST.
+ *
+ * **Przerwania:** servoBusAddDevice() włącza I2Cx_EV/ER w NVIC;
+ * handlery w stm32f4xx_it.c (I2C1, I2C2). Dla I2C3 trzeba dopisać handler.
+ */
+
+#ifndef SERVO_BUS_H
+#define SERVO_BUS_H
+
+#include "pca9685.h"
+#include "leg_config.h"
+#include "servo_frame.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Rozmiary tablic
+ */
+///@{
+#define SERVO_BUS_MAX_DEVICES LEG_CONFIG_MAX_DEVICES
+#define SERVO_BUS_MAX_BUSES 3        ///< I2C1..I2C3 na STM32F446
+#define SERVO_BUS_CHANNELS 16        ///< Kanały PCA9685
+#define SERVO_BUS_FLUSH_TIMEOUT_MS 5 ///< 16 kanałów przy 400 kHz to ~1.5 ms
+///@}
+
+/**
+ * @brief Statystyki jednej magistrali
+ */
+typedef struct
+{
+    uint32_t transfers;   ///< Transakcje w flush
+    uint32_t bytes;       ///< Bajty danych PWM
+    uint32_t errors;      ///< Błędy i przekroczenia czasu
+    uint32_t busy_us_sum; ///< Czas zajętości w flush (suma)
+    uint32_t busy_us_max; ///< Najdłuższa zajętość w jednym flush
+} ServoBusStats_t;
+
+/**
+ * @brief Statystyki flush
+ */
+typedef struct
+{
+    uint32_t flushes;          ///< Flush z co najmniej jednym kanałem
+    uint32_t wall_us_sum;      ///< Czas flush od startu do końca ostatniej magistrali
+    uint32_t wall_us_max;
+    uint32_t serial_us_sum;    ///< Suma zajętości magistral - czas zapisu po kolei
+    uint32_t timeouts;         ///< Flush przerwane po SERVO_BUS_FLUSH_TIMEOUT_MS
+    ServoBusStats_t bus[SERVO_BUS_MAX_BUSES];
+} ServoBusFlushStats_t;
+
+/**
+ * @brief Dopisz zainicjalizowany kontroler
+ *
+ * Kolejność wywołań wyznacza indeksy urządzeń w LegMapping_t::device.
+ *
+ * @param[in] pca Kontroler po PCA9685_Init() (handle musi żyć cały czas)
+ * @return Indeks urządzenia albo -1 (pełna tablica, NULL, za dużo magistral)
+ */
+int servoBusAddDevice(PCA9685_Handle_t *pca);
+
+/**
+ * @brief Kontroler o danym indeksie
+ *
+ * @return Handle albo NULL dla niedopisanego indeksu
+ */
+PCA9685_Handle_t *servoBusDevice(uint8_t device);
+
+/**
+ * @brief Liczba dopisanych kontrolerów
+ */
+uint8_t servoBusDeviceCount(void);
+
+/**
+ * @brief Magistrala kontrolera (indeks w kolejności servoBusAddDevice())
+ *
+ * @return Indeks magistrali; dla niedopisanego urządzenia 0
+ */
+uint8_t servoBusDeviceBus(uint8_t device);
+
+/**
+ * @brief Liczba różnych magistral I2C
+ */
+uint8_t servoBusCount(void);
+
+/**
+ * @brief Zapisz kanały od razu (blokująco, jedna transakcja)
+ *
+ * @param[in] device Indeks urządzenia
+ * @param[in] channel Pierwszy kanał
+ * @param[in] pwm Wartości PWM
+ * @param[in] count Liczba kanałów (channel + count <= 16)
+ * @return false - zły indeks albo błąd I2C
+ */
+bool servoBusWrite(uint8_t device, uint8_t channel, const uint16_t *pwm, uint8_t count);
+
+/**
+ * @brief Wyślij kanały pending ramki, wszystkie magistrale równolegle
+ *
+ * Wraca po zakończeniu ostatniej magistrali (albo po
+ * SERVO_BUS_FLUSH_TIMEOUT_MS). Bez kanałów pending - od razu true.
+ *
+ * @param[in] frame Ramka - czytana w miejscu, dzierżawiona na czas flush
+ * @return false gdy któraś transakcja się nie powiodła
+ */
+bool servoBusFlushFrame(const ServoFrame_t *frame);
+
+/**
+ * @brief Wynik urządzenia w ostatnim servoBusFlushFrame()
+ *
+ * @param[in] device Indeks urządzenia
+ * @param[out] done_cycles Koniec ostatniej transakcji urządzenia (DWT, może być NULL)
+ * @return true gdy wszystkie transakcje urządzenia się powiodły
+ */
+bool servoBusDeviceResult(uint8_t device, uint32_t *done_cycles);
+
+/**
+ * @brief Odczytaj / wyzeruj statystyki flush
+ */
+///@{
+void servoBusGetStats(ServoBusFlushStats_t *stats);
+void servoBusResetStats(void);
+///@}
+
+/**
+ * @brief Wypisz urządzenia, magistrale i czasy flush (komenda `bus`)
+ */
+void servoBusReport(void);
+
+#endif // SERVO_BUS_H
@@ -0,0 +1,118 @@
+/**
+ * @file servo_calib.h
+ * @brief Kalibracja zakresów PWM wszystkich serw w jednym przebiegu
+ *
+ * @details
+ * Dotąd zakres serwa szukało się PCA9685_TestPWMRange() - jeden kanał,
+ * trzy postoje po 2 s, wartości przepisywane ręcznie do leg_config.c -
+ * a calibrationTest90Degrees() ustawia tylko środek jednej nogi.
+ * servoCalibRun() przemiata naraz wszystkie kanały wszystkich
+ * kontrolerów (ramka servo_frame.h, magistrale równolegle):
+ *
+ * ```
+ * grupa wzorca:  faza MIN: center_pwm, -step_pwm co dwell_ms, ... do floor_pwm
+ *                faza MAX: center_pwm, +step_pwm co dwell_ms, ... do ceil_pwm
+ *   operator:    `calib mark ...` gdy serwo stoi na 0° (MIN) / 180° (MAX)
+ *                - bieżące PWM serwa staje się limitem, serwo się zatrzymuje
+ * ```
+ * Faza kończy się, gdy wszystkie serwa grupy są zaznaczone albo doszły
+ * do granicy przemiatania. Serwa grupy ruszają razem; pozostałe stawy
+ * kalibrowanych nóg czekają na center_pwm.
+ *
+ * **Wzorce (ServoCalibPattern_t):**
+ * - ALL - wszystkie zaznaczone stawy naraz (jedna faza MIN i MAX),
+ * - JOINT - biodra, potem kolana, potem kostki wszystkich nóg,
+ * - TRIPOD - grupa tripodu A, potem B (druga grupa podpiera korpus).
+ *
+ * **Komendy operatora (UART, w trakcie przebiegu):**
+ * - `calib mark all|<noga> [hip|knee|ankle]` - zapisz limit i zatrzymaj,
+ * - `calib back [n]` - cofnij ruchome serwa o n kroków (przestrzelone),
+ * - `calib pause` / `calib go` - wstrzymaj / wznów przemiatanie,
+ * - `calib skip` - zakończ fazę (niezaznaczone zostają przy starym limicie),
+ * - `calib abort` - przerwij bez zapisu, `calib` - stan serw.
+ *
+ * Na końcu wszystkie zaznaczone limity trafiają do kopii *leg_config
+ * i jednym configParamsSave(CONFIG_TYPE_LEG_CONFIG) do magazynu.
+ * Para z pwm_min >= pwm_max zostaje przy starych wartościach.
+ * Stop awaryjny (servo_estop.h) przerywa przebieg bez zapisu.
+ *
+ * **Kompilacja:**
+ * HEX_SERVO_CALIB=1 uruchamia kalibrację w main.c przed pętlą główną.
+ * Przy 0 moduł jest pusty.
+ *
+ * @warning Robot na podstawce - nogi przemiatają pełny zakres serw.
+ */
+
+#ifndef SERVO_CALIB_H
+#define SERVO_CALIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "robot_description.h"
+
+#ifndef HEX_SERVO_CALIB
+#define HEX_SERVO_CALIB 0
+#endif
+
+/**
+ * @brief Maska stawów (ServoCalibConfig_t::joints)
+ */
+///@{
+#define SERVO_CALIB_HIP (1U << 0)
+#define SERVO_CALIB_KNEE (1U << 1)
+#define SERVO_CALIB_ANKLE (1U << 2)
+#define SERVO_CALIB_JOINTS_ALL (SERVO_CALIB_HIP | SERVO_CALIB_KNEE | SERVO_CALIB_ANKLE)
+///@}
+
+/**
+ * @brief Kolejność przemiatania serw
+ */
+typedef enum
+{
+    SERVO_CALIB_PATTERN_ALL = 0, ///< Wszystkie serwa naraz
+    SERVO_CALIB_PATTERN_JOINT,   ///< Staw po stawie na wszystkich nogach
+    SERVO_CALIB_PATTERN_TRIPOD,  ///< Grupa tripodu A, potem B
+} ServoCalibPattern_t;
+
+/**
+ * @brief Wzorzec i zakres przemiatania
+ */
+typedef struct
+{
+    ServoCalibPattern_t pattern; ///< Kolejność grup
+    LegMask_t legs;              ///< Kalibrowane nogi (LEG_BIT)
+    uint8_t joints;              ///< Kalibrowane stawy (SERVO_CALIB_HIP...)
+    uint16_t center_pwm;         ///< Start każdej fazy i pozycja czekających serw
+    uint16_t floor_pwm;          ///< Dolna granica fazy MIN
+    uint16_t ceil_pwm;           ///< Górna granica fazy MAX
+    uint16_t step_pwm;           ///< Krok przemiatania
+    uint32_t dwell_ms;           ///< Postój na kroku (czas na reakcję operatora)
+} ServoCalibConfig_t;
+
+/**
+ * @brief Wynik przebiegu
+ */
+typedef struct
+{
+    uint8_t marked_min; ///< Serwa z zaznaczonym pwm_min
+    uint8_t marked_max; ///< Serwa z zaznaczonym pwm_max
+    uint8_t rejected;   ///< Serwa z pwm_min >= pwm_max - bez zmian
+    bool aborted;       ///< `calib abort` albo stop awaryjny
+    bool saved;         ///< Zapisano do magazynu
+} ServoCalibResult_t;
+
+extern ServoCalibConfig_t servo_calib_config;
+
+/**
+ * @brief Przeprowadź kalibrację wg servo_calib_config
+ *
+ * Blokuje do końca przebiegu; komendy UART obsługiwane w trakcie
+ * (rejestruje komendę `calib`). Kontrolery z servo_bus.
+ *
+ * @param[in] persist Zapisz limity do magazynu (configParamsSave())
+ * @param[out] result Wynik (może być NULL)
+ * @return true gdy przebieg doszedł do końca i zapis (jeśli żądany) się udał
+ */
+bool servoCalibRun(bool persist, ServoCalibResult_t *result);
+
+#endif // SERVO_CALIB_H
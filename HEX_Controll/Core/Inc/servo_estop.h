@@ -0,0 +1,119 @@
+/**
+ * @file servo_estop.h
+ * @brief Awaryjne zwolnienie wszystkich serw - przycisk, przerwanie, komenda
+ *
+ * @details
+ * Dotąd zatrzymanie serw to 18 osobnych PCA9685_SetChannelOff(), każde
+ * z limitem 1000 ms HAL - najgorszy czas zatrzymania liczony w sekundach.
+ * servoEstopTrigger():
+ * 1. (opcja SERVO_ESTOP_USE_OE) linia OE kontrolerów w stan wysoki -
+ *    wyjścia PWM wyłączone sprzętowo w ciągu kilku cykli,
+ * 2. na każdym kontrolerze jedna transakcja ALL_LED_OFF_H = full off
+ *    (PCA9685_AllOffFromISR(), 3 bajty, limit SERVO_ESTOP_TIMEOUT_US),
+ * 3. zatrzask (PCA9685_LockOutputs()): sterownik odrzuca każdy zapis
+ *    kanału - chody, leg_output, setAllto90()/testStanding(), test_positions -
+ *    dopóki servoEstopRelease() (inaczej następny zapis z pętli głównej
+ *    włączyłby kanały z powrotem).
+ *
+ * **Wyzwalanie:**
+ * - przycisk B1 Nucleo (PC13, zbocze opadające) - EXTI15_10 z
+ *   priorytetem SERVO_ESTOP_IRQ_PRIORITY, wyższym niż I2C (5) i SysTick,
+ * - komenda `estop` na UART, `estop clear` zwalnia zatrzask,
+ * - wprost z kodu (także z innego ISR).
+ *
+ * **Pomiar:** od wejścia w servoEstopTrigger() do STOP na każdym
+ * kontrolerze i do końca całości (DWT) - ostatni i najgorszy czas,
+ * servoEstopReport().
+ */
+
+#ifndef SERVO_ESTOP_H
+#define SERVO_ESTOP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pca9685.h"
+
+/**
+ * @brief Sterowanie linią OE kontrolerów (aktywna niska, wspólna dla PCA)
+ *
+ * 0 - OE na stałe do GND (domyślnie), 1 - OE z SERVO_ESTOP_OE_PORT/PIN.
+ */
+#ifndef SERVO_ESTOP_USE_OE
+#define SERVO_ESTOP_USE_OE 0
+#endif
+
+/**
+ * @brief Pin OE (D4 na złączu Arduino Nucleo, wolny od I2C/UART/krańcówek)
+ */
+///@{
+#define SERVO_ESTOP_OE_PORT GPIOB
+#define SERVO_ESTOP_OE_PIN GPIO_PIN_5
+///@}
+
+/**
+ * @brief Limit transakcji ALL_LED_OFF na kontroler [us]
+ */
+#ifndef SERVO_ESTOP_TIMEOUT_US
+#define SERVO_ESTOP_TIMEOUT_US 500U
+#endif
+
+/**
+ * @brief Priorytet EXTI przycisku - wywłaszcza I2C (5) i SysTick (15)
+ */
+#define SERVO_ESTOP_IRQ_PRIORITY 1
+
+/**
+ * @brief Maksymalna liczba kontrolerów zwalnianych awaryjnie
+ */
+#define SERVO_ESTOP_MAX_DEVICES 8
+
+/**
+ * @brief Wynik ostatniego wyzwolenia i statystyki
+ */
+typedef struct
+{
+    uint32_t triggers;                           ///< Wyzwolenia od startu
+    uint32_t failures;                           ///< Wyzwolenia z nieudaną transakcją
+    uint8_t devices;                             ///< Kontrolery w ostatnim wyzwoleniu
+    bool device_ok[SERVO_ESTOP_MAX_DEVICES];     ///< Wynik transakcji kontrolera
+    uint32_t device_us[SERVO_ESTOP_MAX_DEVICES]; ///< Od wyzwolenia do STOP kontrolera [us]
+    uint32_t oe_us;                              ///< Od wyzwolenia do OE wysoko [us] (0 bez OE)
+    uint32_t total_us;                           ///< Całe wyzwolenie [us]
+    uint32_t worst_us;                           ///< Najgorsze total_us od startu
+} ServoEstopStats_t;
+
+/**
+ * @brief Skonfiguruj PC13 (EXTI) i linię OE
+ *
+ * Kontrolery z servo_bus (servoBusDevice()); pca1/pca2 gdy servo_bus pusty.
+ * Wołać po servoBusAddDevice(). Włącza licznik DWT (dwtTimerInit()) -
+ * limit transakcji ALL_LED_OFF jest w cyklach.
+ */
+void servoEstopInit(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2);
+
+/**
+ * @brief Zwolnij wszystkie serwa i zatrzaśnij blokadę zapisów (bezpieczne w ISR)
+ */
+void servoEstopTrigger(void);
+
+/**
+ * @brief Zwolnij zatrzask - następne zapisy nóg znowu włączają kanały
+ */
+void servoEstopRelease(void);
+
+/**
+ * @brief Czy zatrzask jest aktywny (PCA9685_OutputsLocked())
+ */
+bool servoEstopActive(void);
+
+/**
+ * @brief Odczytaj statystyki wyzwoleń
+ */
+void servoEstopGetStats(ServoEstopStats_t *stats);
+
+/**
+ * @brief Wypisz stan i czasy ostatniego wyzwolenia
+ */
+void servoEstopReport(void);
+
+#endif // SERVO_ESTOP_H
@@ -0,0 +1,136 @@
+/**
+ * @file servo_frame.h
+ * @brief Wspólna ramka PWM serw: sterowanie pisze, magistrala i rejestrator czytają w miejscu
+ *
+ * @details
+ * Dotąd PWM nogi było kopiowane w każdej ramce kilka razy: lokalna
+ * tablica w legOutputSetJoints() -> bufor nogi stance -> bufor kanałów
+ * servo_bus -> ramka robocza flight_rec. ServoFrame_t jest jedynym
+ * miejscem tych wartości - obraz kanałów każdego kontrolera PCA9685
+ * w układzie, z którego servo_bus koduje transakcję (kanały ciągłe,
+ * więc sąsiednie nogi nadal idą jedną serią).
+ *
+ * **Własność (dzierżawy):**
+ * ```
+ * servoFrameAcquire()   sterowanie - jedyny zapisujący, ramka z puli
+ *   servoFrameChannels() + servoFrameMarkLeg()   pisanie PWM nóg
+ * servoFrameLease()     odczyt tylko przez const (magistrala na czas flush,
+ * servoFrameRelease()   rejestrator, telemetria) - licznik dzierżaw
+ * servoFramePublish()   koniec zapisu: ramka tylko do odczytu, staje się
+ *                       "ostatnią" (servoFrameLeaseLatest()), dzierżawa
+ *                       sterowania przechodzi na moduł
+ * ```
+ * Ramka wraca do puli (mem_arena.h), gdy zwolni ją ostatni dzierżawca -
+ * następna publikacja zwalnia poprzednią "ostatnią". Czytelnik trzymający
+ * dzierżawę długo zabiera blok puli; przy pustej puli servoFrameAcquire()
+ * zwraca NULL, a leg_output zapisuje wtedy nogi od razu, jak poza ramką.
+ *
+ * Moduł nie jest bezpieczny dla przerwań - dzierżawy tylko z pętli głównej
+ * (ISR magistrali czyta ramkę w trakcie flush, dzierżawę trzyma servo_bus).
+ */
+
+#ifndef SERVO_FRAME_H
+#define SERVO_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "robot_description.h"
+#include "leg_config.h"
+
+/**
+ * @brief Rozmiary ramki
+ */
+///@{
+#define SERVO_FRAME_DEVICES LEG_CONFIG_MAX_DEVICES ///< Kontrolery (LegMapping_t::device)
+#define SERVO_FRAME_CHANNELS 16                    ///< Kanały PCA9685
+///@}
+
+/**
+ * @brief Ramki w puli: zapisywana + ostatnia opublikowana + dzierżawa czytelnika
+ */
+#ifndef SERVO_FRAME_POOL_SIZE
+#define SERVO_FRAME_POOL_SIZE 3
+#endif
+
+/**
+ * @brief Brak kanałów nogi w ramce (ServoFrame_t::leg_slot)
+ */
+#define SERVO_FRAME_NO_SLOT 0xFFU
+
+/**
+ * @brief Ramka PWM wszystkich kontrolerów
+ */
+typedef struct
+{
+    uint32_t seq;                                               ///< Numer ramki od startu
+    uint16_t pwm[SERVO_FRAME_DEVICES][SERVO_FRAME_CHANNELS];    ///< Obraz kanałów kontrolerów
+    uint16_t pending[SERVO_FRAME_DEVICES];                      ///< Kanały do wysłania w flush (bit = kanał)
+    uint8_t leg_slot[HEX_LEG_COUNT];                            ///< device * 16 + kanał biodra nogi
+    LegMask_t legs;                                             ///< Nogi z PWM w tej ramce
+    LegMask_t bus_err;                                          ///< Nogi z nieudanym zapisem
+    uint8_t leases;                                             ///< Dzierżawy (zapisujący + czytelnicy)
+    bool published;                                             ///< Tylko do odczytu
+} ServoFrame_t;
+
+/**
+ * @brief Weź pustą ramkę do zapisu
+ *
+ * @return Ramka (dzierżawa zapisującego) albo NULL gdy pula pusta
+ */
+ServoFrame_t *servoFrameAcquire(void);
+
+/**
+ * @brief Trzy kanały od @p channel kontrolera @p device do zapisu PWM
+ *
+ * @return Wskaźnik w ramce albo NULL (ramka opublikowana, zły indeks)
+ */
+uint16_t *servoFrameChannels(ServoFrame_t *frame, uint8_t device, uint8_t channel);
+
+/**
+ * @brief Zapamiętaj kanały nogi zapisane przez servoFrameChannels()
+ *
+ * @param[in] pending true - kanały wyśle servo_bus w flush,
+ *                    false - noga zapisana od razu przez leg_output
+ */
+void servoFrameMarkLeg(ServoFrame_t *frame, int leg_number, uint8_t device, uint8_t channel, bool pending);
+
+/**
+ * @brief PWM trzech stawów nogi w ramce
+ *
+ * @return Wskaźnik albo NULL gdy noga nie ma PWM w tej ramce
+ */
+const uint16_t *servoFrameLegPwm(const ServoFrame_t *frame, int leg_number);
+
+/**
+ * @brief Dzierżawa tylko do odczytu
+ *
+ * @return @p frame (wygodnie: `const ServoFrame_t *f = servoFrameLease(x);`)
+ */
+const ServoFrame_t *servoFrameLease(const ServoFrame_t *frame);
+
+/**
+ * @brief Oddaj dzierżawę; ostatnia oddaje ramkę do puli
+ */
+void servoFrameRelease(const ServoFrame_t *frame);
+
+/**
+ * @brief Zakończ zapis - ramka tylko do odczytu i ostatnia opublikowana
+ *
+ * Dzierżawa zapisującego przechodzi na moduł (do następnej publikacji);
+ * zapisujący nie może już używać @p frame.
+ */
+void servoFramePublish(ServoFrame_t *frame);
+
+/**
+ * @brief Dzierżawa ostatniej opublikowanej ramki
+ *
+ * @return Ramka (oddać servoFrameRelease()) albo NULL przed pierwszą
+ */
+const ServoFrame_t *servoFrameLeaseLatest(void);
+
+/**
+ * @brief Liczba odmów servoFrameAcquire() (pusta pula)
+ */
+uint32_t servoFrameAcquireFails(void);
+
+#endif // SERVO_FRAME_H
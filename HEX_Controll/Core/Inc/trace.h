@@ -0,0 +1,169 @@
+/**
+ * @file trace.h
+ * @brief Bufor zdarzeń czasowych (begin/end) pętli sterowania
+ *
+ * @details
+ * Lekki tracer na targecie: każde zdarzenie to 8 bajtów
+ * (znacznik DWT CYCCNT, identyfikator etapu, typ, argument).
+ * Zapis kosztuje kilkanaście cykli, bez printf i bez HAL.
+ *
+ * **Instrumentowane etapy:**
+ * | Zdarzenie | Gdzie | Argument |
+ * |-----------|-------|----------|
+ * | TRACE_EV_FRAME | jeden punkt interpolacji chodu | numer punktu |
+ * | TRACE_EV_PHASE | faza chodu (swing/stance) | numer fazy |
+ * | TRACE_EV_IK | computeLegIK() | numer nogi |
+ * | TRACE_EV_MAPPING | mapowanie kątów IK na serwa | numer nogi |
+ * | TRACE_EV_I2C1 / TRACE_EV_I2C2 | transakcja PCA9685_SetPWM() | kanał |
+ * | TRACE_EV_DELAY | HAL_Delay() | czas [ms] |
+ * | TRACE_EV_IMU | odczyt MPU-6050 (między ramkami) | adres I2C |
+ *
+ * **Użycie:**
+ * 1. traceStart() przed chodem, traceStop() po nim
+ * 2. traceDump() wypisuje bufor przez UART (printf)
+ * 3. Na hoście: `python3 Tools/trace2chrome.py log.txt -o walk.json`
+ * 4. Otwórz walk.json w chrome://tracing lub https://ui.perfetto.dev
+ *
+ * **Kompilacja:**
+ * HEX_TRACE_ENABLE=1 (domyślnie w buildzie Debug) włącza makra.
+ * Przy 0 makra znikają całkowicie, a nagłówek nie wymaga HAL -
+ * dzięki temu hexapod_kinematics.c dalej kompiluje się na hoście.
+ *
+ * @note Licznik DWT przepełnia się co ~23.8 s przy 180 MHz - konwerter
+ *       rozwija przepełnienia zakładając odstęp zdarzeń < 23 s.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef HEX_TRACE_ENABLE
+#define HEX_TRACE_ENABLE 0
+#endif
+
+/**
+ * @brief Pojemność bufora zdarzeń (8 bajtów na zdarzenie)
+ */
+#ifndef TRACE_BUFFER_SIZE
+#define TRACE_BUFFER_SIZE 1024
+#endif
+
+/**
+ * @brief Identyfikatory etapów - nazwy w trace_event_names[]
+ */
+typedef enum
+{
+    TRACE_EV_FRAME = 0, ///< Jeden punkt interpolacji (ramka)
+    TRACE_EV_PHASE,     ///< Faza chodu
+    TRACE_EV_IK,        ///< Kinematyka odwrotna jednej nogi
+    TRACE_EV_MAPPING,   ///< Mapowanie kątów na serwa (offsety, limity)
+    TRACE_EV_I2C1,      ///< Transakcja na magistrali I2C1
+    TRACE_EV_I2C2,      ///< Transakcja na magistrali I2C2
+    TRACE_EV_DELAY,     ///< HAL_Delay()
+    TRACE_EV_IMU,       ///< Odczyt czujnika inercyjnego
+    TRACE_EV_COUNT
+} TraceEventId_t;
+
+/**
+ * @brief Typ zdarzenia (jak "ph" w formacie Chrome trace)
+ */
+typedef enum
+{
+    TRACE_PH_BEGIN = 'B',
+    TRACE_PH_END = 'E',
+    TRACE_PH_INSTANT = 'I'
+} TracePhase_t;
+
+/**
+ * @brief Pojedyncze zdarzenie w buforze
+ */
+typedef struct
+{
+    uint32_t cycles; ///< DWT CYCCNT w chwili zdarzenia
+    uint8_t id;      ///< TraceEventId_t
+    uint8_t phase;   ///< TracePhase_t
+    uint16_t arg;    ///< Argument (noga, kanał, punkt...)
+} TraceEvent_t;
+
+/**
+ * @brief Rozpocznij nagrywanie (czyści bufor)
+ *
+ * @param[in] ring true = bufor cykliczny (zostają ostatnie zdarzenia),
+ *                 false = zatrzymaj po zapełnieniu (zostają pierwsze)
+ */
+void traceStart(bool ring);
+
+/**
+ * @brief Zatrzymaj nagrywanie (bufor pozostaje do traceDump())
+ */
+void traceStop(void);
+
+/**
+ * @brief Wypisz bufor przez printf w formacie dla Tools/trace2chrome.py
+ *
+ * @details
+ * ```
+ * #TRACE v1 cpu_hz=180000000 events=812 dropped=0
+ * #NAME 0 frame
+ * ...
+ * E 123456789 B 2 1
+ * #END
+ * ```
+ */
+void traceDump(void);
+
+#if HEX_TRACE_ENABLE
+
+#include "dwt_timer.h"
+
+extern TraceEvent_t trace_buffer[TRACE_BUFFER_SIZE];
+extern volatile uint32_t trace_head;
+extern volatile bool trace_active;
+extern bool trace_ring;
+
+/**
+ * @brief Zapisz zdarzenie (wewnętrzne - używaj makr TRACE_*)
+ *
+ * @note Bezpieczne w ISR - indeks rezerwowany przy wyłączonych przerwaniach
+ */
+static inline void traceRecord(uint8_t id, uint8_t phase, uint16_t arg)
+{
+    if (!trace_active)
+    {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t index = trace_head;
+    if (index >= TRACE_BUFFER_SIZE && !trace_ring)
+    {
+        trace_active = false;
+        __set_PRIMASK(primask);
+        return;
+    }
+    trace_head = index + 1;
+    __set_PRIMASK(primask);
+
+    TraceEvent_t *ev = &trace_buffer[index % TRACE_BUFFER_SIZE];
+    ev->cycles = dwtCycles();
+    ev->id = id;
+    ev->phase = phase;
+    ev->arg = arg;
+}
+
+#define TRACE_BEGIN(id, arg) traceRecord((id), TRACE_PH_BEGIN, (uint16_t)(arg))
+#define TRACE_END(id, arg) traceRecord((id), TRACE_PH_END, (uint16_t)(arg))
+#define TRACE_INSTANT(id, arg) traceRecord((id), TRACE_PH_INSTANT, (uint16_t)(arg))
+
+#else
+
+#define TRACE_BEGIN(id, arg) ((void)0)
+#define TRACE_END(id, arg) ((void)0)
+#define TRACE_INSTANT(id, arg) ((void)0)
+
+#endif // HEX_TRACE_ENABLE
+
+#endif // TRACE_H
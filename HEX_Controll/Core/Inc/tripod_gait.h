@@ -91,6 +91,18 @@
 #include "pca9685.h"
 #include "stm32f4xx_hal.h"
 
+/**
+ * @brief Kadencja z konfiguracji (1) zamiast stałych punktów bez pauzy (0)
+ *
+ * Domyślnie tripod robi TRIPOD_FAST_POINTS ramek na fazę tak szybko, jak
+ * pozwala magistrala. Wartość początkowa dla tripodSetPaced().
+ */
+#ifndef HEX_TRIPOD_PACED
+#define HEX_TRIPOD_PACED 0
+#endif
+
+#define TRIPOD_FAST_POINTS 30 ///< Ramki na fazę bez kadencji (swing_points nieużywane)
+
 /**
  * @defgroup Tripod_Types Typy i enumeracje
  * @{
@@ -159,11 +171,21 @@ typedef struct
  * - lift_height: 4.0 cm
  * - swing_duration: 150 ms
  * - stance_duration: 150 ms
- * - swing_points: 150
- * - stance_points: 150
+ * - swing_points: 30
+ * - stance_points: 30
  */
 extern TripodConfig_t tripod_config;
 
+/**
+ * @brief Konfiguracja używana przez chód (odczyt w miejscu)
+ *
+ * @details
+ * Wskazuje na tripod_config albo - po configParamsLoad() - bezpośrednio
+ * na rekord w config_store. setTripodConfig() kopiuje aktywne wartości
+ * do tripod_config i przełącza wskaźnik z powrotem na RAM.
+ */
+extern const TripodConfig_t *tripod_cfg;
+
 /** @} */ // end of Tripod_Config
 
 /**
@@ -178,11 +200,11 @@ extern TripodConfig_t tripod_config;
  * Główna funkcja algorytmu tripod gait. Wykonuje jeden kompletny cykl
  * składający się z dwóch faz:
  *
- * **Faza 1 (150ms + interpolacja):**
+ * **Faza 1 (swing_duration_ms, swing_points ramek):**
  * - Grupa A (1,4,5): SWING - ruch nóg w powietrzu
  * - Grupa B (2,3,6): STANCE - podtrzymywanie robota na ziemi
  *
- * **Faza 2 (150ms + interpolacja):**
+ * **Faza 2 (swing_duration_ms, swing_points ramek):**
  * - Grupa A (1,4,5): STANCE - podtrzymywanie robota na ziemi
  * - Grupa B (2,3,6): SWING - ruch nóg w powietrzu
  *
@@ -196,10 +218,15 @@ extern TripodConfig_t tripod_config;
  * 2. Z pozycji przedniej do pozycji tylnej
  * 3. Synchronicznie z całą grupą
  *
- * **Ultra szybka optymalizacja:**
- * - Używa 30 punktów zamiast 150 (5x szybciej)
- * - Brak HAL_Delay() w pętlach interpolacji
- * - Całkowity czas cyklu: ~120ms zamiast 300ms
+ * **Kadencja:**
+ * - Fazy są równoczesne - obie trwają tyle samo ramek
+ * - Domyślnie (tripodSetPaced(false)): TRIPOD_FAST_POINTS ramek bez
+ *   pauzy - maksymalna prędkość, swing_points/swing_duration_ms nieużywane
+ * - tripodSetPaced(true): swing_points ramek co swing_duration_ms /
+ *   swing_points (controlFrameSetPeriod()); ramka, która nie zdąży, idzie
+ *   dalej bez pauzy i liczy się jako przekroczenie terminu (frame_miss);
+ *   swing_duration_ms = 0 - bez pauzy
+ * - Najszybszą kadencję bez przekroczeń dobiera cadence_tune.h
  *
  * @param[in] pca1 Wskaźnik na kontroler PCA9685 lewych nóg (I2C1) lub NULL
  * @param[in] pca2 Wskaźnik na kontroler PCA9685 prawych nóg (I2C2) lub NULL
@@ -354,6 +381,39 @@ void setTripodConfig(float step_length, float lift_height,
  */
 void printTripodConfig(void);
 
+/**
+ * @brief Włącz/wyłącz linię z kątami każdej nogi w każdej ramce
+ *
+ * Domyślnie włączone. Wypisanie 6 linii przez UART 115200 trwa dziesiątki
+ * ms - dłużej niż ramka przy domyślnej kadencji.
+ *
+ * @param[in] verbose true = wypisuj (jak dotąd)
+ * @return Poprzednie ustawienie
+ */
+bool tripodSetVerbose(bool verbose);
+
+/**
+ * @brief Włącz/wyłącz kadencję z konfiguracji (swing_points, swing_duration_ms)
+ *
+ * Domyślnie HEX_TRIPOD_PACED. cadence_tune.h włącza ją na czas strojenia
+ * i zostawia włączoną po znalezieniu kadencji.
+ *
+ * @param[in] paced true = ramki co swing_duration_ms / swing_points
+ * @return Poprzednie ustawienie
+ */
+bool tripodSetPaced(bool paced);
+
+/**
+ * @brief Wypisz szczytowe momenty stawów w fazie stance dla bieżącego kroku
+ *
+ * Model statyczny z leg_torque.h: tor stance obu grup nóg próbkowany
+ * leg_torque_config.samples razy. Wypisuje też krok, który planowanie
+ * cyklu faktycznie użyje (mniejszy przy polityce LEG_TORQUE_SCALE).
+ *
+ * @param[in] direction Kierunek ruchu
+ */
+void tripodPrintTorque(TripodDirection_t direction);
+
 /** @} */ // end of Tripod_Functions
 
 /**
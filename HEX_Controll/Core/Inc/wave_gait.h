@@ -156,6 +156,18 @@ typedef struct
     float step_height_base;    ///< Bazowa wysokość stania [cm] - pozycja Z w stance
 } WaveConfig_t;
 
+/**
+ * @brief Konfiguracja w RAM (wartości domyślne, zmieniana przez setWaveConfig())
+ */
+extern WaveConfig_t wave_config;
+
+/**
+ * @brief Konfiguracja używana przez chód (RAM lub rekord z config_store)
+ *
+ * setWaveConfig() kopiuje aktywne wartości do RAM i przełącza wskaźnik na kopię.
+ */
+extern const WaveConfig_t *wave_cfg;
+
 /** @} */ // end of Wave_Types
 
 /**
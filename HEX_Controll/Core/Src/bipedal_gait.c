@@ -1,20 +1,29 @@
 /*
  * bipedal_gait.c - Bipedal gait dla hexapoda - CORRECTED STANCE LOGIC
  *
- * Koncepcja: 3 pary nóg chodzące sekwencyjnie z fazą stance shift
+ * Koncepcja: N/2 par nóg chodzących sekwencyjnie z fazą stance shift
+ * - Para p: nogi p+1 i p+1+N/2 (N = HEX_LEG_COUNT), dla hexapoda:
  * - Para 0: Nogi 1,4 (lewa przednia + prawa środkowa)
  * - Para 1: Nogi 2,5 (prawa przednia + lewa tylna)
  * - Para 2: Nogi 3,6 (lewa środkowa + prawa tylna)
  *
  * POPRAWNA SEKWENCJA:
  * 1. Para X robi SWING (obecna pozycja → pozycja przednia), pozostałe STOJĄ
- * 2. FAZA STANCE: WSZYSTKIE nogi przesuwają się o 1/3 step_length do tyłu
+ * 2. FAZA STANCE: WSZYSTKIE nogi przesuwają się o step_length/(N/2) do tyłu
  * 3. Powtórz dla kolejnej pary
  */
 
 #include "bipedal_gait.h"
 #include <stdio.h>
 #include <math.h>
+#include "trace.h"
+#include "leg_output.h"
+#include "control_frame.h"
+#include "foot_contact.h"
+#include "metrics.h"
+#include "serial_cmd.h"
+#include "robot_description.h"
+#include "mem_arena.h"
 
 // Konfiguracja bipedal gait - ULTRA SZYBKA
 BipedalConfig_t bipedal_config = {
@@ -25,43 +34,35 @@ BipedalConfig_t bipedal_config = {
     .step_height_base = -24.0f // Bazowa wysokość stania [cm]
 };
 
-// Pozycje bazowe nóg - z ROS
-static const float base_positions[6][3] = {
-    {18.0f, -15.0f, -24.0f},  // Noga 1 - lewa przednia
-    {-18.0f, -15.0f, -24.0f}, // Noga 2 - prawa przednia
-    {22.0f, 0.0f, -24.0f},    // Noga 3 - lewa środkowa
-    {-22.0f, 0.0f, -24.0f},   // Noga 4 - prawa środkowa
-    {18.0f, 15.0f, -24.0f},   // Noga 5 - lewa tylna
-    {-18.0f, 15.0f, -24.0f}   // Noga 6 - prawa tylna
-};
+// Aktywna konfiguracja - RAM lub rekord z config_store (configParamsLoad)
+const BipedalConfig_t *bipedal_cfg = &bipedal_config;
 
-// Śledzenie aktualnych pozycji Y każdej nogi
-static float leg_current_y[6];
-static bool positions_initialized = false;
+// Pozycje bazowe nóg - robot_description.h (z ROS), z = ROBOT_STANCE_Z
+#define BASE_X(leg_index) (robot_description.stance_x[leg_index])
+#define BASE_Y(leg_index) (robot_description.stance_y[leg_index])
 
-// Definicje par nóg
-static const int leg_pairs[3][2] = {
-    {1, 4}, // Para 0: lewa przednia + prawa środkowa
-    {2, 5}, // Para 1: prawa przednia + lewa tylna
-    {3, 6}  // Para 2: lewa środkowa + prawa tylna
-};
+// Śledzenie aktualnych pozycji Y każdej nogi - w arenie chodu (gait_scratch)
+static float *leg_current_y;
 
-// Mapowanie kanałów PCA9685 z offsetami biodra
-typedef struct
+// Pary nóg: noga p+1 i p+1+N/2
+#define BIPEDAL_PAIRS (HEX_LEG_COUNT / 2)
+
+static int pairLeg(int pair_index, int member)
 {
-    uint8_t base_channel;
-    float hip_offset_deg;
-    bool is_left_side;
-} LegMapping_t;
-
-static const LegMapping_t leg_mapping[6] = {
-    {0, 37.5f, true},   // Noga 1: I2C1, kanały 0-2, offset +37.5°
-    {0, -37.5f, false}, // Noga 2: I2C2, kanały 0-2, offset -37.5°
-    {3, 0.0f, true},    // Noga 3: I2C1, kanały 3-5, bez offsetu
-    {3, 0.0f, false},   // Noga 4: I2C2, kanały 3-5, bez offsetu
-    {6, -37.5f, true},  // Noga 5: I2C1, kanały 6-8, offset -37.5°
-    {6, 37.5f, false}   // Noga 6: I2C2, kanały 6-8, offset +37.5°
-};
+    return pair_index + 1 + member * BIPEDAL_PAIRS;
+}
+
+/**
+ * @brief Dopisz cel stopy do partii IK
+ */
+static void batchAdd(LegIKBatch_t *batch, int leg_number, float x, float y, float z)
+{
+    batch->leg[batch->count] = (uint8_t)leg_number;
+    batch->x[batch->count] = x;
+    batch->y[batch->count] = y;
+    batch->z[batch->count] = z;
+    batch->count++;
+}
 
 /**
  * @brief Interpolacja kubiczna
@@ -84,66 +85,29 @@ static float lerp(float start, float end, float t)
 }
 
 /**
- * @brief Inicjalizacja pozycji nóg
+ * @brief Pozycje nóg z areny chodu - bazowe, gdy chód dopiero ją przejął
+ *
+ * @return false gdy stan nie mieści się w gait_scratch
  */
-static void initializeLegPositions(void)
+static bool initializeLegPositions(void)
 {
-    for (int i = 0; i < 6; i++)
+    bool fresh;
+    leg_current_y = memScratchGet(&leg_current_y, sizeof(float) * HEX_LEG_COUNT, &fresh);
+    if (leg_current_y == NULL)
     {
-        leg_current_y[i] = base_positions[i][1]; // Pozycje bazowe
+        return false;
     }
-    positions_initialized = true;
-    printf("🔧 Pozycje nóg zainicjalizowane\n");
-}
-
-/**
- * @brief Ustaw kanały serw dla nogi z offsetem biodra
- */
-static void setLegJointsWithOffset(int leg_number, float q1, float q2, float q3,
-                                   PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
-{
-    if (leg_number < 1 || leg_number > 6)
-        return;
-
-    const LegMapping_t *mapping = &leg_mapping[leg_number - 1];
-    PCA9685_Handle_t *pca_to_use = mapping->is_left_side ? pca1 : pca2;
-
-    if (pca_to_use == NULL)
+    if (!fresh)
     {
-        printf("⚠️  PCA dla nogi %d niedostępne\n", leg_number);
-        return;
+        return true; // Stan z poprzednich cykli tego chodu
     }
 
-    // Konwersja z offsetem
-    float hip_deg = (q1 * 180.0f / M_PI) + mapping->hip_offset_deg;
-    float knee_deg = q2 * 180.0f / M_PI;
-    float ankle_deg = q3 * 180.0f / M_PI;
-
-    // USUNIĘTO INWERSJĘ KOLAN - wszystkie nogi mają ten sam kierunek
-
-    // Mapowanie na serwa
-    float servo_hip = 90.0f + hip_deg;
-    float servo_knee = 90.0f + knee_deg;
-    float servo_ankle = 90.0f + ankle_deg;
-
-    // Ograniczenia
-    if (servo_hip < 0.0f)
-        servo_hip = 0.0f;
-    if (servo_hip > 180.0f)
-        servo_hip = 180.0f;
-    if (servo_knee < 0.0f)
-        servo_knee = 0.0f;
-    if (servo_knee > 180.0f)
-        servo_knee = 180.0f;
-    if (servo_ankle < 0.0f)
-        servo_ankle = 0.0f;
-    if (servo_ankle > 180.0f)
-        servo_ankle = 180.0f;
-
-    // Ustaw serwa
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 0, servo_hip);
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 1, servo_knee);
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 2, servo_ankle);
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        leg_current_y[i] = BASE_Y(i); // Pozycje bazowe
+    }
+    printf("🔧 Pozycje nóg zainicjalizowane\n");
+    return true;
 }
 
 /**
@@ -154,23 +118,32 @@ static bool executeSwingPhase(int pair_index, BipedalDirection_t direction,
 {
     printf("\n--- FAZA SWING: Para %d ---\n", pair_index);
 
-    int swing_leg1 = leg_pairs[pair_index][0];
-    int swing_leg2 = leg_pairs[pair_index][1];
+    int swing_leg1 = pairLeg(pair_index, 0);
+    int swing_leg2 = pairLeg(pair_index, 1);
 
     printf("SWING: nogi %d,%d | POZOSTAŁE: stoją bez ruchu\n", swing_leg1, swing_leg2);
 
     // ADAPTACYJNY DELAY - może być 0ms dla maksymalnej prędkości
-    uint32_t step_delay = bipedal_config.step_duration_ms / bipedal_config.step_points;
+    uint32_t step_delay = bipedal_cfg->step_duration_ms / bipedal_cfg->step_points;
     // NIE wymuszaj minimum 1ms - pozwól na 0ms dla ultra prędkości
 
     printf("Swing delay: %lu ms/punkt (total: %d punktów = %lu ms)\n",
-           step_delay, bipedal_config.step_points, step_delay * bipedal_config.step_points);
+           step_delay, bipedal_cfg->step_points, step_delay * bipedal_cfg->step_points);
 
     // === FAZA SWING ===
-    for (int i = 0; i <= bipedal_config.step_points; i++)
+    float swing_last_y[2] = {leg_current_y[swing_leg1 - 1], leg_current_y[swing_leg2 - 1]};
+    footSwingBegin(swing_leg1);
+    footSwingBegin(swing_leg2);
+    TRACE_BEGIN(TRACE_EV_PHASE, pair_index);
+    for (int i = 0; i <= bipedal_cfg->step_points; i++)
     {
-        float t = (float)i / (float)bipedal_config.step_points;
+        TRACE_BEGIN(TRACE_EV_FRAME, i);
+        controlFrameBegin();
+        float t = (float)i / (float)bipedal_cfg->step_points;
         float smooth_t = cubicInterpolation(t);
+        LegIKBatch_t swing_batch, stand_batch;
+        swing_batch.count = 0;
+        stand_batch.count = 0;
 
         // SWING dla pary
         for (int p = 0; p < 2; p++)
@@ -178,56 +151,68 @@ static bool executeSwingPhase(int pair_index, BipedalDirection_t direction,
             int leg_number = (p == 0) ? swing_leg1 : swing_leg2;
             int leg_index = leg_number - 1;
 
-            float base_x = base_positions[leg_index][0];
-            float base_y = base_positions[leg_index][1];
-            float base_z = base_positions[leg_index][2];
+            float base_x = BASE_X(leg_index);
+            float base_y = BASE_Y(leg_index);
+            float base_z = ROBOT_STANCE_Z;
 
             // Swing: z obecnej pozycji do pozycji przedniej
             float swing_start_y = leg_current_y[leg_index];          // Obecna pozycja
-            float swing_end_y = base_y - bipedal_config.step_length; // Pozycja przednia
+            float swing_end_y = base_y - bipedal_cfg->step_length; // Pozycja przednia
 
             float current_x = base_x;
             float current_y = lerp(swing_start_y, swing_end_y, smooth_t);
 
-            // Trajektoria łuku
-            float arc_height = 4.0f * bipedal_config.lift_height * t * (1.0f - t);
-            float current_z = base_z - arc_height;
+            // Trajektoria łuku - start z wysokości podłoża z poprzedniego przyziemienia
+            float arc_height = 4.0f * bipedal_cfg->lift_height * t * (1.0f - t);
+            float current_z = lerp(footSwingStartZ(leg_number, base_z), base_z, smooth_t) - arc_height;
 
-            // Oblicz IK i ustaw serwa
-            float q1, q2, q3;
-            if (computeLegIK(leg_number, current_x, current_y, current_z, &q1, &q2, &q3))
+            // Po przyziemieniu noga stoi - nie schodzi niżej i nie idzie dalej
+            if (!footSwingDown(leg_number))
             {
-                setLegJointsWithOffset(leg_number, q1, q2, q3, pca1, pca2);
-            }
+                footSwingUpdate(leg_number, t, &current_z);
 
-            // Zapisz pozycję końcową swing
-            if (i == bipedal_config.step_points)
-            {
-                leg_current_y[leg_index] = swing_end_y;
-                printf("SWING KONIEC Noga %d: y=%.1f\n", leg_number, swing_end_y);
+                legOutputMarkSwing(leg_number);
+                batchAdd(&swing_batch, leg_number, current_x, current_y, current_z);
+                swing_last_y[p] = current_y;
             }
         }
 
         // POZOSTAŁE NOGI: stoją w obecnych pozycjach (bez ruchu)
-        for (int leg = 1; leg <= 6; leg++)
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
         {
             if (leg == swing_leg1 || leg == swing_leg2)
                 continue; // Pomiń swing legs
 
             int leg_index = leg - 1;
-            float current_x = base_positions[leg_index][0];
-            float current_y = leg_current_y[leg_index]; // Obecna pozycja (bez zmian)
-            float current_z = base_positions[leg_index][2];
-
-            float q1, q2, q3;
-            if (computeLegIK(leg, current_x, current_y, current_z, &q1, &q2, &q3))
-            {
-                setLegJointsWithOffset(leg, q1, q2, q3, pca1, pca2);
-            }
+            batchAdd(&stand_batch, leg, BASE_X(leg_index), leg_current_y[leg_index],
+                     footGroundZ(leg, ROBOT_STANCE_Z));
         }
 
+        // Oblicz IK i ustaw serwa - swing pierwszy
+        legOutputMoveFeet(&swing_batch, pca1, pca2, false);
+        legOutputMoveFeet(&stand_batch, pca1, pca2, false);
+
         // USUŃ HAL_Delay dla maksymalnej prędkości!
         // HAL_Delay(step_delay);  // ← WYŁĄCZONE!
+        controlFrameEnd(0);
+        TRACE_END(TRACE_EV_FRAME, i);
+
+        // Obie nogi na ziemi - reszta łuku niepotrzebna
+        if (footSwingDown(swing_leg1) && footSwingDown(swing_leg2))
+        {
+            printf("PRZYZIEMIENIE: swing zakończony po %d/%d punktach\n", i, bipedal_cfg->step_points);
+            break;
+        }
+    }
+
+    TRACE_END(TRACE_EV_PHASE, pair_index);
+
+    // Zapisz pozycję końcową swing (koniec łuku albo przyziemienie)
+    for (int p = 0; p < 2; p++)
+    {
+        int leg_number = (p == 0) ? swing_leg1 : swing_leg2;
+        leg_current_y[leg_number - 1] = swing_last_y[p];
+        printf("SWING KONIEC Noga %d: y=%.1f\n", leg_number, swing_last_y[p]);
     }
 
     return true;
@@ -239,7 +224,7 @@ static bool executeSwingPhase(int pair_index, BipedalDirection_t direction,
 static bool executeStanceShift(BipedalDirection_t direction,
                                PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
 {
-    printf("\n--- FAZA STANCE: Wszystkie nogi przesuwają się o 1/3 do tyłu ---\n");
+    printf("\n--- FAZA STANCE: Wszystkie nogi przesuwają się o 1/%d do tyłu ---\n", BIPEDAL_PAIRS);
 
     // ULTRA SZYBKA STANCE - mniej punktów, szybszy delay
     int stance_points = 10;                     // DRASTYCZNIE MNIEJ punktów
@@ -249,38 +234,36 @@ static bool executeStanceShift(BipedalDirection_t direction,
     printf("Stance delay: %lu ms/punkt (total: %d punktów = %lu ms)\n",
            stance_delay, stance_points, stance_delay * stance_points);
 
-    float stance_shift = bipedal_config.step_length / 3.0f;
+    float stance_shift = bipedal_cfg->step_length / (float)BIPEDAL_PAIRS;
 
     // Zapisz pozycje startowe stance
-    float stance_start_y[6];
-    for (int i = 0; i < 6; i++)
+    float stance_start_y[HEX_LEG_COUNT];
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
     {
         stance_start_y[i] = leg_current_y[i];
     }
 
     // === FAZA STANCE SHIFT ===
+    TRACE_BEGIN(TRACE_EV_PHASE, 0);
     for (int i = 0; i <= stance_points; i++)
     {
+        TRACE_BEGIN(TRACE_EV_FRAME, i);
+        controlFrameBegin();
         float t = (float)i / (float)stance_points;
         float smooth_t = cubicInterpolation(t);
+        LegIKBatch_t batch;
+        batch.count = 0;
 
-        // WSZYSTKIE NOGI przesuwają się o 1/3 do tyłu
-        for (int leg = 1; leg <= 6; leg++)
+        // WSZYSTKIE NOGI przesuwają się o 1/(N/2) do tyłu
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
         {
             int leg_index = leg - 1;
 
-            float current_x = base_positions[leg_index][0];
-            float current_z = base_positions[leg_index][2];
-
-            // Stance shift: z obecnej pozycji o 1/3 do tyłu
+            // Stance shift: z obecnej pozycji o 1/(N/2) do tyłu
             float stance_end_y = stance_start_y[leg_index] + stance_shift;
             float current_y = lerp(stance_start_y[leg_index], stance_end_y, smooth_t);
 
-            float q1, q2, q3;
-            if (computeLegIK(leg, current_x, current_y, current_z, &q1, &q2, &q3))
-            {
-                setLegJointsWithOffset(leg, q1, q2, q3, pca1, pca2);
-            }
+            batchAdd(&batch, leg, BASE_X(leg_index), current_y, footGroundZ(leg, ROBOT_STANCE_Z));
 
             // Zapisz nową pozycję
             if (i == stance_points)
@@ -291,10 +274,16 @@ static bool executeStanceShift(BipedalDirection_t direction,
             }
         }
 
+        legOutputMoveFeet(&batch, pca1, pca2, false);
+
         // USUŃ HAL_Delay dla maksymalnej prędkości!
         // HAL_Delay(stance_delay);  // ← WYŁĄCZONE!
+        controlFrameEnd(0);
+        TRACE_END(TRACE_EV_FRAME, i);
     }
 
+    TRACE_END(TRACE_EV_PHASE, 0);
+
     return true;
 }
 
@@ -327,6 +316,23 @@ static bool executePairStep(int pair_index, BipedalDirection_t direction,
     return true;
 }
 
+/**
+ * @brief Histogram czasu cyklu (rejestracja przy pierwszym cyklu)
+ */
+static Metric_t *cycleMetric(void)
+{
+    static const uint32_t bounds_ms[] = {100, 200, 300, 500, 750, 1000, 2000};
+    static Metric_t *metric = NULL;
+    static bool registered = false;
+
+    if (!registered)
+    {
+        metric = metricsRegisterHistogram("bipedal_cycle_ms", "ms", bounds_ms, sizeof(bounds_ms) / sizeof(bounds_ms[0]));
+        registered = true;
+    }
+    return metric;
+}
+
 /**
  * @brief Wykonaj jeden pełny cykl bipedal gait
  */
@@ -338,18 +344,18 @@ bool bipedalGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, BipedalDir
                                                   : (direction == BIPEDAL_LEFT)       ? "LEWO"
                                                                                       : "PRAWO");
 
-    // Inicjalizacja pozycji nóg
-    if (!positions_initialized)
+    // Inicjalizacja pozycji nóg (po zmianie chodu - od pozycji bazowych)
+    if (!initializeLegPositions())
     {
-        initializeLegPositions();
+        return false;
     }
 
     uint32_t cycle_start = HAL_GetTick();
 
-    // SEKWENCJA 3 KROKÓW PAR (każdy krok = swing + stance shift)
-    for (int pair = 0; pair < 3; pair++)
+    // SEKWENCJA N/2 KROKÓW PAR (każdy krok = swing + stance shift)
+    for (int pair = 0; pair < BIPEDAL_PAIRS; pair++)
     {
-        printf("\n>>> KROK %d/3 <<<\n", pair + 1);
+        printf("\n>>> KROK %d/%d <<<\n", pair + 1, BIPEDAL_PAIRS);
 
         bool success = executePairStep(pair, direction, pca1, pca2);
         if (!success)
@@ -363,9 +369,9 @@ bool bipedalGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, BipedalDir
 
     // Sprawdź pozycje końcowe
     printf("\n=== SPRAWDZENIE POZYCJI KOŃCOWYCH ===\n");
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
     {
-        float expected_y = base_positions[i][1];
+        float expected_y = BASE_Y(i);
         float actual_y = leg_current_y[i];
         float diff = fabsf(actual_y - expected_y);
 
@@ -374,6 +380,7 @@ bool bipedalGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, BipedalDir
     }
 
     uint32_t total_time = HAL_GetTick() - cycle_start;
+    metricObserve(cycleMetric(), total_time);
     printf("\n✅ BIPEDAL GAIT CYCLE ZAKOŃCZONY w %lu ms\n", total_time);
 
     return true;
@@ -400,6 +407,7 @@ bool bipedalGaitWalk(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
         }
 
         // HAL_Delay(50); // USUŃ dla maksymalnej prędkości!
+        serialCmdPoll(); // Komendy UART między cyklami (bez pauzy)
     }
 
     printf("\n✅ BIPEDAL GAIT WALK ZAKOŃCZONY\n");
@@ -412,10 +420,15 @@ bool bipedalGaitWalk(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
 void setBipedalConfig(float step_length, float lift_height,
                       uint32_t step_duration, int step_points)
 {
+    // Aktywny może być rekordem z flash - zmiany na kopii w RAM
+    if (bipedal_cfg != &bipedal_config)
+        bipedal_config = *bipedal_cfg;
+
     bipedal_config.step_length = step_length;
     bipedal_config.lift_height = lift_height;
     bipedal_config.step_duration_ms = step_duration;
     bipedal_config.step_points = step_points;
+    bipedal_cfg = &bipedal_config;
 
     printf("✅ Konfiguracja bipedal zaktualizowana: krok=%.1fcm, podniesienie=%.1fcm, czas=%lums, punkty=%d\n",
            step_length, lift_height, step_duration, step_points);
@@ -427,11 +440,11 @@ void setBipedalConfig(float step_length, float lift_height,
 void printBipedalConfig(void)
 {
     printf("\n=== KONFIGURACJA BIPEDAL GAIT ===\n");
-    printf("Długość kroku: %.1f cm\n", bipedal_config.step_length);
-    printf("Wysokość podniesienia: %.1f cm\n", bipedal_config.lift_height);
-    printf("Czas swing: %lu ms\n", bipedal_config.step_duration_ms);
-    printf("Punkty interpolacji: %d\n", bipedal_config.step_points);
-    printf("Wysokość bazowa: %.1f cm\n", bipedal_config.step_height_base);
+    printf("Długość kroku: %.1f cm\n", bipedal_cfg->step_length);
+    printf("Wysokość podniesienia: %.1f cm\n", bipedal_cfg->lift_height);
+    printf("Czas swing: %lu ms\n", bipedal_cfg->step_duration_ms);
+    printf("Punkty interpolacji: %d\n", bipedal_cfg->step_points);
+    printf("Wysokość bazowa: %.1f cm\n", bipedal_cfg->step_height_base);
     printf("ALGORYTM: 2-PHASE (swing + stance shift wszystkich nóg)\n");
     printf("================================\n");
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+/*
+ * body_leveling.c - Filtr komplementarny + regulator PI pozy korpusu
+ */
+
+#include "body_leveling.h"
+#include <math.h>
+
+#define DEG_PER_RAD (180.0f / (float)M_PI)
+
+BodyLevelingConfig_t body_leveling_config = {
+    .period_ms = 10,     // 100 Hz
+    .filter_tau_s = 0.5f, // Akcelerometr dominuje po ~0.5 s (drgania chodu odfiltrowane)
+    .kp = 0.3f,
+    .ki = 2.0f,
+    .max_tilt_deg = 8.0f};
+
+static bool enabled = false;
+static bool estimate_valid = false; // Pierwsza próbka inicjalizuje estymatę z akcelerometru
+static float est_roll, est_pitch;   // [°]
+static float int_roll, int_pitch;   // Część całkująca [°]
+static float corr_roll, corr_pitch; // [°]
+static float corr_sin_roll, corr_cos_roll = 1.0f;
+static float corr_sin_pitch, corr_cos_pitch = 1.0f;
+
+static float clampf(float v, float limit)
+{
+    if (v > limit)
+        return limit;
+    if (v < -limit)
+        return -limit;
+    return v;
+}
+
+void bodyLevelingReset(void)
+{
+    estimate_valid = false;
+    est_roll = est_pitch = 0.0f;
+    int_roll = int_pitch = 0.0f;
+    corr_roll = corr_pitch = 0.0f;
+    corr_sin_roll = corr_sin_pitch = 0.0f;
+    corr_cos_roll = corr_cos_pitch = 1.0f;
+}
+
+void bodyLevelingEnable(bool enable)
+{
+    bodyLevelingReset();
+    enabled = enable;
+}
+
+bool bodyLevelingEnabled(void)
+{
+    return enabled;
+}
+
+void bodyLevelingUpdate(const ImuSample_t *sample, float dt)
+{
+    const BodyLevelingConfig_t *cfg = &body_leveling_config;
+    const float *a = sample->accel_g;
+
+    float acc_roll = atan2f(a[0], a[2]) * DEG_PER_RAD;
+    float acc_pitch = atan2f(a[1], sqrtf(a[0] * a[0] + a[2] * a[2])) * DEG_PER_RAD;
+
+    if (!estimate_valid || dt <= 0.0f)
+    {
+        est_roll = acc_roll;
+        est_pitch = acc_pitch;
+        estimate_valid = true;
+    }
+    else
+    {
+        // Przechył = obrót wokół -Y, pochylenie = obrót wokół +X (imu.h)
+        float alpha = cfg->filter_tau_s / (cfg->filter_tau_s + dt);
+        est_roll = alpha * (est_roll - sample->gyro_dps[1] * dt) + (1.0f - alpha) * acc_roll;
+        est_pitch = alpha * (est_pitch + sample->gyro_dps[0] * dt) + (1.0f - alpha) * acc_pitch;
+    }
+
+    if (!enabled)
+    {
+        return;
+    }
+
+    // PI z anti-windup: całka nie wychodzi poza zakres korekty
+    int_roll = clampf(int_roll + cfg->ki * est_roll * dt, cfg->max_tilt_deg);
+    int_pitch = clampf(int_pitch + cfg->ki * est_pitch * dt, cfg->max_tilt_deg);
+    corr_roll = clampf(cfg->kp * est_roll + int_roll, cfg->max_tilt_deg);
+    corr_pitch = clampf(cfg->kp * est_pitch + int_pitch, cfg->max_tilt_deg);
+
+    // sin/cos raz na krok pętli, nie dla każdej nogi w każdej ramce
+    corr_sin_roll = sinf(corr_roll / DEG_PER_RAD);
+    corr_cos_roll = cosf(corr_roll / DEG_PER_RAD);
+    corr_sin_pitch = sinf(corr_pitch / DEG_PER_RAD);
+    corr_cos_pitch = cosf(corr_pitch / DEG_PER_RAD);
+}
+
+void bodyLevelingApply(float *x, float *y, float *z)
+{
+    if (!enabled)
+    {
+        return;
+    }
+
+    float x1 = *x * corr_cos_roll - *z * corr_sin_roll;
+    float z1 = *z * corr_cos_roll + *x * corr_sin_roll;
+
+    float y2 = *y * corr_cos_pitch - z1 * corr_sin_pitch;
+    float z2 = z1 * corr_cos_pitch + *y * corr_sin_pitch;
+
+    *x = x1;
+    *y = y2;
+    *z = z2;
+}
+
+void bodyLevelingGetState(BodyLevelingState_t *state)
+{
+    state->enabled = enabled;
+    state->roll_deg = est_roll;
+    state->pitch_deg = est_pitch;
+    state->corr_roll_deg = corr_roll;
+    state->corr_pitch_deg = corr_pitch;
+}
@@ -0,0 +1,147 @@
+/*
+ * bus_load.c - Model zajętości magistral PCA9685 w fazach chodu
+ */
+
+#include "bus_load.h"
+#include <stdio.h>
+#include <string.h>
+
+const char *const bus_load_gait_names[BUS_LOAD_GAITS] = {"tripod", "bipedal", "wave"};
+
+uint8_t busLoadPhaseCount(BusLoadGait_t gait)
+{
+    switch (gait)
+    {
+    case BUS_LOAD_TRIPOD:
+        return 2;
+    case BUS_LOAD_BIPEDAL:
+        return HEX_LEG_COUNT / 2;
+    case BUS_LOAD_WAVE:
+        return HEX_LEG_COUNT;
+    default:
+        return 0;
+    }
+}
+
+LegMask_t busLoadSwingLegs(BusLoadGait_t gait, uint8_t phase)
+{
+    LegMask_t swing = 0;
+    switch (gait)
+    {
+    case BUS_LOAD_TRIPOD:
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+        {
+            if (robot_description.group[leg - 1] == phase)
+                swing |= LEG_BIT(leg);
+        }
+        break;
+    case BUS_LOAD_BIPEDAL:
+        // Para jak pairLeg() w bipedal_gait.c
+        swing = LEG_BIT(phase + 1) | LEG_BIT(phase + 1 + HEX_LEG_COUNT / 2);
+        break;
+    case BUS_LOAD_WAVE:
+        swing = LEG_BIT(phase + 1);
+        break;
+    default:
+        break;
+    }
+    return swing;
+}
+
+uint32_t busLoadTransactionUs(uint8_t channels)
+{
+    // START + adres + rejestr + 4 B na kanał + STOP, bajt = 8 bitów + ACK
+    uint32_t bits = (2U + 4U * channels) * 9U + 2U;
+    return bits * 1000000U / BUS_LOAD_SCL_HZ + BUS_LOAD_TX_OVERHEAD_US;
+}
+
+void busLoadAnalyse(const LegConfig_t *config, const uint8_t *device_bus, BusLoadGait_t gait,
+                    BusLoadResult_t *result)
+{
+    memset(result, 0, sizeof(*result));
+    result->gait = gait;
+    result->phases = busLoadPhaseCount(gait);
+
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        uint8_t device = config->legs[leg - 1].device;
+        uint8_t bus = (device_bus != NULL) ? device_bus[device] : device;
+        if (bus + 1U > result->buses)
+            result->buses = (uint8_t)(bus + 1U);
+    }
+
+    for (uint8_t p = 0; p < result->phases; p++)
+    {
+        BusLoadPhase_t *phase = &result->phase[p];
+        uint16_t stance[LEG_CONFIG_MAX_DEVICES] = {0}; // Kanały stance w flush, bit = kanał
+
+        phase->swing = busLoadSwingLegs(gait, p);
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+        {
+            const LegMapping_t *m = &config->legs[leg - 1];
+            uint8_t bus = (device_bus != NULL) ? device_bus[m->device] : m->device;
+
+            if (phase->swing & LEG_BIT(leg))
+            {
+                phase->swing_legs[bus]++;
+                phase->swing_us += busLoadTransactionUs(3);
+            }
+            else
+            {
+                stance[m->device] |= (uint16_t)(0x7U << m->base_channel);
+            }
+        }
+
+        // Serie ciągłych kanałów jak startNext() w servo_bus.c
+        for (uint8_t d = 0; d < LEG_CONFIG_MAX_DEVICES; d++)
+        {
+            uint8_t bus = (device_bus != NULL) ? device_bus[d] : d;
+            uint16_t dirty = stance[d];
+            while (dirty != 0)
+            {
+                uint8_t first = (uint8_t)__builtin_ctz(dirty);
+                uint8_t count = 0;
+                while (first + count < 16 && (dirty & (1U << (first + count))))
+                    count++;
+                dirty &= (uint16_t)~(((1U << count) - 1U) << first);
+
+                phase->transactions[bus]++;
+                phase->bus_us[bus] += busLoadTransactionUs(count);
+            }
+        }
+
+        for (uint8_t b = 0; b < result->buses; b++)
+        {
+            if (phase->bus_us[b] > phase->flush_us)
+                phase->flush_us = phase->bus_us[b];
+        }
+        if (phase->flush_us > result->worst_flush_us)
+            result->worst_flush_us = phase->flush_us;
+        result->sum_flush_us += phase->flush_us;
+    }
+}
+
+void busLoadPrint(const BusLoadResult_t *result)
+{
+    printf("%s: najgorszy flush %lu us, suma faz %lu us\n", bus_load_gait_names[result->gait],
+           (unsigned long)result->worst_flush_us, (unsigned long)result->sum_flush_us);
+    for (uint8_t p = 0; p < result->phases; p++)
+    {
+        const BusLoadPhase_t *phase = &result->phase[p];
+
+        printf("  faza %u swing", p);
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+        {
+            if (phase->swing & LEG_BIT(leg))
+                printf(" %d", leg);
+        }
+        printf(" (%lu us):", (unsigned long)phase->swing_us);
+
+        for (uint8_t b = 0; b < result->buses; b++)
+        {
+            printf("  mag %u: swing %u, stance %u tr %4lu us", b, phase->swing_legs[b],
+                   phase->transactions[b], (unsigned long)phase->bus_us[b]);
+        }
+        printf("  -> flush %lu us\n", (unsigned long)phase->flush_us);
+    }
+}
@@ -0,0 +1,133 @@
+/*
+ * cadence_tune.c - Przeszukiwanie czasu fazy i punktów tripodu po terminach ramek
+ */
+
+#include "cadence_tune.h"
+#include "tripod_gait.h"
+#include "control_frame.h"
+#include "config_params.h"
+#include "metrics.h"
+#include <stdio.h>
+
+#if HEX_CADENCE_TUNE
+
+CadenceTuneConfig_t cadence_tune_config = {
+    .start_phase_ms = 300, // 2x domyślna faza - zdaje przy każdym rozsądnym buildzie
+    .min_phase_ms = 60,
+    .step_ms = 20,
+    .points_max = 30,
+    .points_min = 10, // Poniżej widać schodki na łuku swing
+    .points_step = 5,
+    .cycles = 2,
+    .quiet = true,
+};
+
+/**
+ * @brief Jedna próba: cykle do przodu i do tyłu przy danej kadencji
+ */
+static bool runTrial(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
+                     const TripodConfig_t *base, uint32_t phase_ms, int points,
+                     uint32_t *frame_us_max)
+{
+    setTripodConfig(base->step_length, base->lift_height, phase_ms, phase_ms, points, points);
+
+    Metric_t *bus = metricsFind("servo_bus_err");
+    uint32_t bus_before = (bus != NULL) ? bus->count : 0;
+    controlFrameResetStats();
+
+    bool ok = true;
+    for (uint8_t c = 0; c < cadence_tune_config.cycles; c++)
+        ok = tripodGaitCycle(pca1, pca2, TRIPOD_FORWARD) && ok;
+    for (uint8_t c = 0; c < cadence_tune_config.cycles; c++)
+        ok = tripodGaitCycle(pca1, pca2, TRIPOD_BACKWARD) && ok;
+
+    ControlFrameStats_t stats;
+    controlFrameGetStats(&stats);
+    uint32_t bus_errors = (bus != NULL) ? bus->count - bus_before : 0;
+    bool pass = ok && stats.deadline_misses == 0 && bus_errors == 0;
+
+    printf("STROJENIE: faza %3lu ms, %2d pkt, termin %5lu us, ramka max %5lu us, przekroczenia %lu, błędy I2C %lu -> %s\n",
+           phase_ms, points, stats.period_us, stats.frame_us_max,
+           stats.deadline_misses, bus_errors, pass ? "OK" : "NIE");
+
+    *frame_us_max = stats.frame_us_max;
+    HAL_Delay(200); // Uspokojenie robota między próbami
+    return pass;
+}
+
+bool cadenceTuneRun(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool persist,
+                    CadenceTuneResult_t *result)
+{
+    const CadenceTuneConfig_t *cfg = &cadence_tune_config;
+    CadenceTuneResult_t r = {0};
+
+    // Stan do przywrócenia, gdy żadna próba nie zda
+    const TripodConfig_t *original_cfg = tripod_cfg;
+    TripodConfig_t original = *tripod_cfg;
+    TripodConfig_t original_ram = tripod_config;
+    bool was_verbose = tripodSetVerbose(!cfg->quiet);
+    bool was_paced = tripodSetPaced(true);
+
+    printf("\n=== STROJENIE KADENCJI TRIPOD ===\n");
+    printf("Faza %lu..%lu ms co %lu ms, punkty %u..%u co %u, %u cykle w każdą stronę\n",
+           cfg->start_phase_ms, cfg->min_phase_ms, cfg->step_ms,
+           cfg->points_max, cfg->points_min, cfg->points_step, cfg->cycles);
+
+    uint8_t points_step = (cfg->points_step > 0) ? cfg->points_step : 1;
+    for (uint32_t phase_ms = cfg->start_phase_ms; phase_ms >= cfg->min_phase_ms; phase_ms -= cfg->step_ms)
+    {
+        bool passed = false;
+
+        // Najwięcej punktów, które się mieszczą - płynność przed zapasem
+        for (int points = cfg->points_max; points >= cfg->points_min; points -= points_step)
+        {
+            uint32_t frame_us_max;
+            r.trials++;
+            if (runTrial(pca1, pca2, &original, phase_ms, points, &frame_us_max))
+            {
+                r.found = true;
+                r.phase_ms = phase_ms;
+                r.points = points;
+                r.frame_us_max = frame_us_max;
+                passed = true;
+                break;
+            }
+        }
+
+        // Krótsza faza nie zda, skoro ta nie zdała przy żadnej liczbie punktów
+        if (!passed || cfg->step_ms == 0 || phase_ms < cfg->min_phase_ms + cfg->step_ms)
+            break;
+    }
+
+    if (r.found)
+    {
+        setTripodConfig(original.step_length, original.lift_height,
+                        r.phase_ms, r.phase_ms, r.points, r.points);
+        printf("✅ Kadencja: faza %lu ms, %d punktów (ramka max %lu us z %lu us), %u prób\n",
+               r.phase_ms, r.points, r.frame_us_max, r.phase_ms * 1000U / (uint32_t)r.points, r.trials);
+        if (cfg->quiet)
+            printf("ℹ️  Zmierzone bez wypisywania kątów - pozostaje wyłączone\n");
+        else
+            tripodSetVerbose(was_verbose);
+
+        if (persist)
+        {
+            r.saved = configParamsSave(CONFIG_TYPE_TRIPOD, tripod_cfg);
+            printf("%s\n", r.saved ? "Zapisano do flash" : "❌ Zapis do flash nieudany");
+        }
+    }
+    else
+    {
+        tripod_config = original_ram;
+        tripod_cfg = original_cfg;
+        tripodSetVerbose(was_verbose);
+        tripodSetPaced(was_paced);
+        printf("❌ Żadna kadencja bez przekroczeń - konfiguracja bez zmian\n");
+    }
+
+    if (result != NULL)
+        *result = r;
+    return r.found;
+}
+
+#endif // HEX_CADENCE_TUNE
@@ -0,0 +1,238 @@
+/*
+ * config_params.c - Rekordy config_store -> wskaźniki parametrów
+ */
+
+#include "config_params.h"
+#include "config_store.h"
+#include "hexapod_kinematics.h"
+#include "leg_config.h"
+#include "tripod_gait.h"
+#include "bipedal_gait.h"
+#include "wave_gait.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+    ConfigType_t type;
+    uint16_t version;
+    uint32_t size;
+    const char *name;
+    bool (*validate)(const void *data); // NULL = bez dodatkowej kontroli
+} ConfigParam_t;
+
+static bool validateGeometry(const void *data)
+{
+    const RobotGeometry_t *g = (const RobotGeometry_t *)data;
+    return g->l1 >= 0.0f && g->l2 > 0.0f && g->l3 > 0.0f;
+}
+
+static bool validateLegConfig(const void *data)
+{
+    return legConfigValidate((const LegConfig_t *)data);
+}
+
+static bool validateTripod(const void *data)
+{
+    const TripodConfig_t *c = (const TripodConfig_t *)data;
+    return c->swing_points > 0 && c->stance_points > 0;
+}
+
+static bool validateBipedal(const void *data)
+{
+    return ((const BipedalConfig_t *)data)->step_points > 0;
+}
+
+static bool validateWave(const void *data)
+{
+    return ((const WaveConfig_t *)data)->step_points > 0;
+}
+
+static const ConfigParam_t params[] = {
+    {CONFIG_TYPE_GEOMETRY, ROBOT_GEOMETRY_VERSION, sizeof(RobotGeometry_t), "geometria", validateGeometry},
+    {CONFIG_TYPE_LEG_CONFIG, LEG_CONFIG_VERSION, sizeof(LegConfig_t), "nogi/PWM", validateLegConfig},
+    {CONFIG_TYPE_TRIPOD, TRIPOD_CONFIG_VERSION, sizeof(TripodConfig_t), "tripod", validateTripod},
+    {CONFIG_TYPE_BIPEDAL, BIPEDAL_CONFIG_VERSION, sizeof(BipedalConfig_t), "bipedal", validateBipedal},
+    {CONFIG_TYPE_WAVE, WAVE_CONFIG_VERSION, sizeof(WaveConfig_t), "wave", validateWave}};
+
+#define PARAM_COUNT (sizeof(params) / sizeof(params[0]))
+
+static const ConfigParam_t *findParam(ConfigType_t type)
+{
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (params[i].type == type)
+            return &params[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Ustaw wskaźnik parametru (NULL = wartości domyślne)
+ */
+static void bindParam(ConfigType_t type, const void *data)
+{
+    switch (type)
+    {
+    case CONFIG_TYPE_GEOMETRY:
+        // Kopia do SRAM (HOT_CONST) - IK nie czyta z sektora flash
+        memcpy(&robot_geometry_default, data ? data : &robot_geometry_urdf, sizeof(robot_geometry_default));
+        robot_geometry = &robot_geometry_default;
+        break;
+    case CONFIG_TYPE_LEG_CONFIG:
+        leg_config = data ? (const LegConfig_t *)data : &leg_config_default;
+        break;
+    case CONFIG_TYPE_TRIPOD:
+        tripod_cfg = data ? (const TripodConfig_t *)data : &tripod_config;
+        break;
+    case CONFIG_TYPE_BIPEDAL:
+        bipedal_cfg = data ? (const BipedalConfig_t *)data : &bipedal_config;
+        break;
+    case CONFIG_TYPE_WAVE:
+        wave_cfg = data ? (const WaveConfig_t *)data : &wave_config;
+        break;
+    }
+}
+
+static const void *currentParam(ConfigType_t type)
+{
+    switch (type)
+    {
+    case CONFIG_TYPE_GEOMETRY:
+        return robot_geometry;
+    case CONFIG_TYPE_LEG_CONFIG:
+        return leg_config;
+    case CONFIG_TYPE_TRIPOD:
+        return tripod_cfg;
+    case CONFIG_TYPE_BIPEDAL:
+        return bipedal_cfg;
+    case CONFIG_TYPE_WAVE:
+        return wave_cfg;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Znajdź pasujący rekord (wersja, rozmiar, walidacja) lub NULL
+ */
+static const void *lookupRecord(const ConfigParam_t *p, const char **status)
+{
+    uint16_t version;
+    uint32_t length;
+    const void *data = configStoreFind(p->type, &version, &length);
+
+    if (data == NULL)
+    {
+        *status = "domyślne";
+        return NULL;
+    }
+    if (version != p->version || length != p->size)
+    {
+        *status = "domyślne (inna wersja rekordu)";
+        return NULL;
+    }
+    if (p->validate != NULL && !p->validate(data))
+    {
+        *status = "domyślne (błędne wartości w rekordzie)";
+        return NULL;
+    }
+    *status = "flash";
+    return data;
+}
+
+static bool isStorePointer(const void *data)
+{
+    uintptr_t addr = (uintptr_t)data;
+    return addr >= CONFIG_STORE_ADDR_A && addr < CONFIG_STORE_ADDR_B + CONFIG_STORE_SECTOR_SIZE;
+}
+
+/**
+ * @brief Podepnij ponownie parametry czytane z flash
+ *
+ * Po kompaktowaniu stare adresy rekordów są nieważne. Parametry zmienione
+ * w RAM (np. setTripodConfig()) zostają bez zmian.
+ */
+static void rebindStored(void)
+{
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        if (isStorePointer(currentParam(params[i].type)))
+        {
+            const char *status;
+            bindParam(params[i].type, lookupRecord(&params[i], &status));
+        }
+    }
+}
+
+void configParamsLoad(void)
+{
+    ConfigStoreStats_t stats;
+    configStoreGetStats(&stats);
+
+    printf("\n=== KONFIGURACJA ===\n");
+    if (stats.active_addr == 0)
+    {
+        printf("⚠️  Magazyn konfiguracji niedostępny - wartości domyślne\n");
+        return;
+    }
+
+    printf("Sektor 0x%08lX, generacja %lu, kasowań %lu, zajęte %lu B, rekordów %lu (uszkodzonych %lu)\n",
+           stats.active_addr, stats.generation, stats.erase_count,
+           stats.used_bytes, stats.records, stats.corrupted);
+
+    for (uint32_t i = 0; i < PARAM_COUNT; i++)
+    {
+        const char *status;
+        bindParam(params[i].type, lookupRecord(&params[i], &status));
+        printf("  %-10s: %s\n", params[i].name, status);
+    }
+}
+
+bool configParamsSave(ConfigType_t type, const void *data)
+{
+    const ConfigParam_t *p = findParam(type);
+    if (p == NULL)
+    {
+        return false;
+    }
+
+    if (data == NULL)
+    {
+        data = currentParam(type);
+    }
+    if (p->validate != NULL && !p->validate(data))
+    {
+        printf("❌ Konfiguracja %s: błędne wartości - nie zapisano\n", p->name);
+        return false;
+    }
+
+    bool ok = configStoreWrite(p->type, p->version, data, p->size);
+
+    // Kompaktowanie mogło przenieść rekordy - także przy błędzie zapisu
+    rebindStored();
+    if (ok)
+    {
+        const char *status;
+        bindParam(p->type, lookupRecord(p, &status));
+    }
+
+    printf("%s Konfiguracja %s %s\n", ok ? "✅" : "❌", p->name, ok ? "zapisana" : "- błąd zapisu flash");
+    return ok;
+}
+
+bool configParamsReset(ConfigType_t type)
+{
+    const ConfigParam_t *p = findParam(type);
+    if (p == NULL)
+    {
+        return false;
+    }
+
+    bool ok = configStoreDelete(p->type);
+    if (ok)
+    {
+        bindParam(p->type, NULL);
+    }
+    rebindStored();
+    return ok;
+}
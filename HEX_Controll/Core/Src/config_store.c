@@ -0,0 +1,381 @@
+/*
+ * config_store.c - Dziennik rekordów konfiguracji w sektorach 6/7 flash
+ *
+ * Opis formatu i gwarancji w config_store.h.
+ */
+
+#include "config_store.h"
+#include "crc32.h"
+#include "stm32f4xx_hal.h"
+#include <stddef.h>
+#include <string.h>
+
+#define CONFIG_SECTOR_MAGIC 0x53435848U // "HXCS"
+#define CONFIG_RECORD_MAGIC 0x52435848U // "HXCR"
+#define ERASED_WORD 0xFFFFFFFFU
+
+// Nagłówek sektora - magic programowane jako ostatnie (zatwierdzenie)
+typedef struct
+{
+    uint32_t generation;  // Rośnie przy każdym kompaktowaniu
+    uint32_t erase_count; // Licznik kasowań tego sektora
+    uint32_t reserved;
+    uint32_t magic;
+} ConfigSectorHeader_t;
+
+typedef struct
+{
+    uint32_t addr;
+    uint32_t sector;
+} ConfigSector_t;
+
+static const ConfigSector_t sectors[2] = {
+    {CONFIG_STORE_ADDR_A, FLASH_SECTOR_6},
+    {CONFIG_STORE_ADDR_B, FLASH_SECTOR_7}};
+
+static int active = -1;     // Indeks aktywnego sektora
+static uint32_t write_addr; // Pierwszy wolny bajt w aktywnym sektorze
+static uint32_t next_seq = 1;
+static uint32_t valid_records;
+static uint32_t corrupted_records;
+
+// Najnowszy rekord każdego typu (wskaźniki do flash)
+static const ConfigRecordHeader_t *record_index[CONFIG_STORE_MAX_TYPES];
+
+static const ConfigSectorHeader_t *sectorHeader(int s)
+{
+    return (const ConfigSectorHeader_t *)(uintptr_t)sectors[s].addr;
+}
+
+static uint32_t sectorEnd(int s)
+{
+    return sectors[s].addr + CONFIG_STORE_SECTOR_SIZE;
+}
+
+static uint32_t align4(uint32_t n)
+{
+    return (n + 3U) & ~3U;
+}
+
+static uint32_t recordCrc(const ConfigRecordHeader_t *h, const void *data)
+{
+    uint32_t fields[3] = {h->length, (uint32_t)h->type | ((uint32_t)h->version << 16), h->seq};
+    uint32_t crc = crc32Update(0, fields, sizeof(fields));
+    return crc32Update(crc, data, h->length);
+}
+
+/**
+ * @brief Unieważnij D-cache ART po programowaniu (mógł trzymać 0xFF)
+ */
+static void flashDataCacheFlush(void)
+{
+    if (FLASH->ACR & FLASH_ACR_DCEN)
+    {
+        __HAL_FLASH_DATA_CACHE_DISABLE();
+        __HAL_FLASH_DATA_CACHE_RESET();
+        __HAL_FLASH_DATA_CACHE_ENABLE();
+    }
+}
+
+static bool flashEraseSector(int s)
+{
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_SECTORS,
+        .Sector = sectors[s].sector,
+        .NbSectors = 1,
+        .VoltageRange = FLASH_VOLTAGE_RANGE_3};
+    uint32_t bad_sector = 0;
+
+    HAL_FLASH_Unlock();
+    HAL_StatusTypeDef status = HAL_FLASHEx_Erase(&erase, &bad_sector);
+    HAL_FLASH_Lock();
+    return status == HAL_OK;
+}
+
+/**
+ * @brief Programuj dane słowami (flash musi być odblokowany)
+ *
+ * Ostatnie niepełne słowo dopełniane 0xFF, słowa 0xFFFFFFFF pomijane.
+ */
+static bool flashProgram(uint32_t addr, const void *data, uint32_t length)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (length > 0)
+    {
+        uint32_t n = (length < 4U) ? length : 4U;
+        uint32_t word = ERASED_WORD;
+        memcpy(&word, p, n);
+
+        if (word != ERASED_WORD &&
+            HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr, word) != HAL_OK)
+        {
+            return false;
+        }
+        addr += 4U;
+        p += n;
+        length -= n;
+    }
+    return true;
+}
+
+/**
+ * @brief Zapisz rekord pod adresem: nagłówek bez magic, dane, magic
+ */
+static bool programRecord(uint32_t addr, const ConfigRecordHeader_t *h, const void *data)
+{
+    const uint32_t magic = CONFIG_RECORD_MAGIC;
+
+    return flashProgram(addr, h, offsetof(ConfigRecordHeader_t, magic)) &&
+           flashProgram(addr + sizeof(ConfigRecordHeader_t), data, h->length) &&
+           flashProgram(addr + offsetof(ConfigRecordHeader_t, magic), &magic, sizeof(magic));
+}
+
+/**
+ * @brief Przejrzyj sektor: indeks najnowszych rekordów, koniec dziennika
+ */
+static void scanSector(int s)
+{
+    memset(record_index, 0, sizeof(record_index));
+    valid_records = 0;
+    corrupted_records = 0;
+
+    uint32_t addr = sectors[s].addr + sizeof(ConfigSectorHeader_t);
+    uint32_t end = sectorEnd(s);
+
+    while (addr + sizeof(ConfigRecordHeader_t) <= end)
+    {
+        const ConfigRecordHeader_t *h = (const ConfigRecordHeader_t *)(uintptr_t)addr;
+        if (h->length == ERASED_WORD)
+        {
+            break; // Wolne miejsce
+        }
+
+        uint32_t total = sizeof(ConfigRecordHeader_t) + align4(h->length);
+        if (h->length > CONFIG_STORE_SECTOR_SIZE || total > end - addr)
+        {
+            // Uszkodzona długość - dalej nie da się iść, sektor do kompaktowania
+            corrupted_records++;
+            addr = end;
+            break;
+        }
+
+        if (h->magic == CONFIG_RECORD_MAGIC && h->type > 0 && h->type < CONFIG_STORE_MAX_TYPES &&
+            recordCrc(h, h + 1) == h->crc32)
+        {
+            const ConfigRecordHeader_t *prev = record_index[h->type];
+            if (prev == NULL || (int32_t)(h->seq - prev->seq) > 0)
+            {
+                record_index[h->type] = h;
+            }
+            if ((int32_t)(h->seq - next_seq) >= 0)
+            {
+                next_seq = h->seq + 1U;
+            }
+            valid_records++;
+        }
+        else
+        {
+            corrupted_records++; // Przerwany zapis - pomijamy
+        }
+        addr += total;
+    }
+
+    write_addr = addr;
+}
+
+/**
+ * @brief Skasuj sektor i zapisz nagłówek (bez rekordów)
+ */
+static bool formatSector(int s, uint32_t generation)
+{
+    const ConfigSectorHeader_t *old = sectorHeader(s);
+    ConfigSectorHeader_t h = {
+        .generation = generation,
+        .erase_count = ((old->magic == CONFIG_SECTOR_MAGIC) ? old->erase_count : 0U) + 1U,
+        .reserved = ERASED_WORD,
+        .magic = CONFIG_SECTOR_MAGIC};
+
+    if (!flashEraseSector(s))
+    {
+        return false;
+    }
+
+    HAL_FLASH_Unlock();
+    bool ok = flashProgram(sectors[s].addr, &h, offsetof(ConfigSectorHeader_t, magic)) &&
+              flashProgram(sectors[s].addr + offsetof(ConfigSectorHeader_t, magic), &h.magic, sizeof(h.magic));
+    HAL_FLASH_Lock();
+    flashDataCacheFlush();
+    return ok;
+}
+
+/**
+ * @brief Przenieś najnowsze rekordy do drugiego sektora i przełącz na niego
+ *
+ * Nowy sektor staje się ważny dopiero po zapisaniu magic nagłówka, więc
+ * przerwanie w trakcie zostawia aktywny stary sektor.
+ */
+static bool compact(void)
+{
+    int dst = 1 - active;
+    const ConfigSectorHeader_t *old = sectorHeader(dst);
+    ConfigSectorHeader_t h = {
+        .generation = sectorHeader(active)->generation + 1U,
+        .erase_count = ((old->magic == CONFIG_SECTOR_MAGIC) ? old->erase_count : 0U) + 1U,
+        .reserved = ERASED_WORD,
+        .magic = CONFIG_SECTOR_MAGIC};
+
+    if (!flashEraseSector(dst))
+    {
+        return false;
+    }
+
+    HAL_FLASH_Unlock();
+    bool ok = true;
+    uint32_t addr = sectors[dst].addr + sizeof(ConfigSectorHeader_t);
+    for (int type = 1; type < CONFIG_STORE_MAX_TYPES && ok; type++)
+    {
+        const ConfigRecordHeader_t *r = record_index[type];
+        if (r == NULL || r->length == 0)
+        {
+            continue; // Usunięte typy nie przechodzą dalej
+        }
+        ok = programRecord(addr, r, r + 1);
+        addr += sizeof(ConfigRecordHeader_t) + align4(r->length);
+    }
+    ok = ok && flashProgram(sectors[dst].addr, &h, offsetof(ConfigSectorHeader_t, magic)) &&
+         flashProgram(sectors[dst].addr + offsetof(ConfigSectorHeader_t, magic), &h.magic, sizeof(h.magic));
+    HAL_FLASH_Lock();
+    flashDataCacheFlush();
+
+    if (!ok)
+    {
+        return false;
+    }
+
+    active = dst;
+    scanSector(active);
+    return true;
+}
+
+bool configStoreInit(void)
+{
+    int best = -1;
+    for (int s = 0; s < 2; s++)
+    {
+        const ConfigSectorHeader_t *h = sectorHeader(s);
+        if (h->magic != CONFIG_SECTOR_MAGIC)
+            continue;
+        if (best < 0 || (int32_t)(h->generation - sectorHeader(best)->generation) > 0)
+            best = s;
+    }
+
+    if (best < 0)
+    {
+        // Pierwsze uruchomienie - pusty magazyn w sektorze 6
+        if (!formatSector(0, 1U))
+        {
+            active = -1;
+            return false;
+        }
+        best = 0;
+    }
+
+    active = best;
+    scanSector(active);
+    return true;
+}
+
+const void *configStoreFind(uint16_t type, uint16_t *version, uint32_t *length)
+{
+    if (active < 0 || type == 0 || type >= CONFIG_STORE_MAX_TYPES)
+    {
+        return NULL;
+    }
+
+    const ConfigRecordHeader_t *r = record_index[type];
+    if (r == NULL || r->length == 0)
+    {
+        return NULL;
+    }
+
+    if (version != NULL)
+        *version = r->version;
+    if (length != NULL)
+        *length = r->length;
+    return r + 1;
+}
+
+bool configStoreWrite(uint16_t type, uint16_t version, const void *data, uint32_t length)
+{
+    if (active < 0 || type == 0 || type >= CONFIG_STORE_MAX_TYPES || (data == NULL && length > 0))
+    {
+        return false;
+    }
+
+    uint32_t total = sizeof(ConfigRecordHeader_t) + align4(length);
+    if (total > CONFIG_STORE_SECTOR_SIZE - sizeof(ConfigSectorHeader_t))
+    {
+        return false;
+    }
+
+    if (total > sectorEnd(active) - write_addr)
+    {
+        if (!compact() || total > sectorEnd(active) - write_addr)
+        {
+            return false;
+        }
+    }
+
+    ConfigRecordHeader_t h = {
+        .length = length,
+        .type = type,
+        .version = version,
+        .seq = next_seq,
+        .magic = CONFIG_RECORD_MAGIC};
+    h.crc32 = recordCrc(&h, data);
+
+    HAL_FLASH_Unlock();
+    bool ok = programRecord(write_addr, &h, data);
+    HAL_FLASH_Lock();
+    flashDataCacheFlush();
+
+    uint32_t addr = write_addr;
+    write_addr += total; // Przy błędzie miejsce i tak jest zużyte
+    if (!ok)
+    {
+        corrupted_records++;
+        return false;
+    }
+
+    record_index[type] = (const ConfigRecordHeader_t *)(uintptr_t)addr;
+    next_seq++;
+    valid_records++;
+    return true;
+}
+
+bool configStoreDelete(uint16_t type)
+{
+    if (configStoreFind(type, NULL, NULL) == NULL)
+    {
+        return true; // Nic do usunięcia
+    }
+    return configStoreWrite(type, 0, NULL, 0);
+}
+
+void configStoreGetStats(ConfigStoreStats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (active < 0)
+    {
+        return;
+    }
+
+    stats->active_addr = sectors[active].addr;
+    stats->generation = sectorHeader(active)->generation;
+    stats->erase_count = sectorHeader(active)->erase_count;
+    stats->used_bytes = write_addr - sectors[active].addr;
+    stats->free_bytes = sectorEnd(active) - write_addr;
+    stats->records = valid_records;
+    stats->corrupted = corrupted_records;
+}
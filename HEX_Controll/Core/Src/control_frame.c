@@ -0,0 +1,280 @@
+/*
+ * control_frame.c - Zadania między ramkami chodu (IMU + poziomowanie) i pomiary
+ */
+
+#include "control_frame.h"
+#include "body_leveling.h"
+#include "mpu6050.h"
+#include "dwt_timer.h"
+#include "trace.h"
+#include "metrics.h"
+#include "flight_rec.h"
+#include "leg_output.h"
+#include <stdio.h>
+#include <string.h>
+
+static ImuSource_t imu_source = IMU_SOURCE_NONE;
+static MPU6050_Handle_t mpu;
+
+static uint32_t frame_start;
+static uint32_t last_update;       // Znacznik ostatniego kroku pętli
+static bool have_last_update;
+static uint32_t pending_sample;    // Znacznik próbki czekającej na pierwszą ramkę
+static bool latency_pending;
+
+// Sumy w µs - 32 bity wystarczają na ~70 minut chodu
+static uint32_t frames, frame_us_sum, frame_us_max;
+static uint32_t updates, imu_errors, interval_us_sum, interval_count;
+static uint32_t read_us_sum, read_us_max;
+static uint32_t latency_us_sum, latency_us_max, latency_count;
+
+// Okres ramki (controlFrameSetPeriod) - 0 = bez terminu
+static uint32_t frame_period_us;
+static uint32_t deadline_misses, overrun_us_max;
+
+// Rejestr metryk (metrics.h) - ramki liczone od początku do początku
+#define FRAME_GAP_US 1000000U // Dłuższa przerwa = koniec chodu, nie ramka
+static const uint32_t frame_us_bounds[] = {500, 1000, 2000, 3000, 5000, 10000, 20000};
+static Metric_t *m_frame_us, *m_frame_rate, *m_idle_pct, *m_imu_err, *m_miss;
+static uint32_t prev_begin, prev_busy_end;
+static bool have_prev_frame;
+
+static uint32_t cyclesPerMs(void)
+{
+    return SystemCoreClock / 1000U;
+}
+
+ImuSource_t controlFrameInit(I2C_HandleTypeDef *imu_bus, ImuSource_t source)
+{
+    dwtTimerInit();
+    controlFrameResetStats();
+
+    imu_source = IMU_SOURCE_NONE;
+    if (source == IMU_SOURCE_MPU6050)
+    {
+        if (imu_bus != NULL && MPU6050_Init(&mpu, imu_bus, MPU6050_ADDRESS))
+            imu_source = IMU_SOURCE_MPU6050;
+    }
+    else if (source == IMU_SOURCE_SIM)
+    {
+        imu_source = IMU_SOURCE_SIM;
+    }
+
+    bodyLevelingEnable(imu_source != IMU_SOURCE_NONE);
+    have_last_update = false;
+
+    m_frame_us = metricsRegisterHistogram("frame_us", "us", frame_us_bounds,
+                                          sizeof(frame_us_bounds) / sizeof(frame_us_bounds[0]));
+    m_frame_rate = metricsRegisterGauge("frame_rate", "Hz");
+    m_idle_pct = metricsRegisterGauge("frame_idle", "%");
+    m_imu_err = metricsRegisterCounter("imu_err", NULL);
+    m_miss = metricsRegisterCounter("frame_miss", NULL);
+    return imu_source;
+}
+
+void controlFrameBegin(void)
+{
+    frame_start = dwtCycles();
+    legOutputFrameBegin();
+
+    // Okres ramki i część bez pracy (pauza + kod chodu między ramkami)
+    if (have_prev_frame)
+    {
+        uint32_t period_us = dwtCyclesToUs(frame_start - prev_begin);
+        if (period_us > 0 && period_us < FRAME_GAP_US)
+        {
+            uint32_t busy_us = dwtCyclesToUs(prev_busy_end - prev_begin);
+            metricSet(m_frame_rate, 1e6f / (float)period_us);
+            metricSet(m_idle_pct, 100.0f * (float)(period_us - busy_us) / (float)period_us);
+        }
+    }
+    prev_begin = frame_start;
+
+    // Pierwsza ramka po kroku pętli używa nowej korekty
+    if (latency_pending)
+    {
+        uint32_t us = dwtCyclesToUs(frame_start - pending_sample);
+        latency_us_sum += us;
+        if (us > latency_us_max)
+            latency_us_max = us;
+        latency_count++;
+        latency_pending = false;
+    }
+}
+
+/**
+ * @brief Krok pętli poziomowania, jeśli minął jej okres
+ */
+static void levelingService(uint32_t now)
+{
+    if (imu_source == IMU_SOURCE_NONE || !bodyLevelingEnabled())
+    {
+        return;
+    }
+
+    uint32_t period = body_leveling_config.period_ms * cyclesPerMs();
+    if (have_last_update && (now - last_update) < period)
+    {
+        return;
+    }
+
+    float dt = 0.0f;
+    if (have_last_update)
+    {
+        uint32_t interval_us = dwtCyclesToUs(now - last_update);
+        interval_us_sum += interval_us;
+        interval_count++;
+        dt = (float)interval_us * 1e-6f;
+    }
+    last_update = now;
+    have_last_update = true;
+
+    ImuSample_t sample;
+    bool ok = true;
+    if (imu_source == IMU_SOURCE_MPU6050)
+    {
+        ok = MPU6050_Read(&mpu, &sample);
+    }
+    else
+    {
+        imuSimRead(&sample, dt);
+    }
+
+    uint32_t read_us = dwtCyclesToUs(dwtCycles() - now);
+    read_us_sum += read_us;
+    if (read_us > read_us_max)
+        read_us_max = read_us;
+
+    if (!ok)
+    {
+        imu_errors++;
+        metricInc(m_imu_err);
+        return;
+    }
+
+    bodyLevelingUpdate(&sample, dt);
+    updates++;
+    pending_sample = now;
+    latency_pending = true;
+}
+
+void controlFrameEnd(uint32_t idle_ms)
+{
+    legOutputFlush(); // Nogi stance czekające za swing
+    uint32_t now = dwtCycles();
+    uint32_t frame_us = dwtCyclesToUs(now - frame_start);
+    frame_us_sum += frame_us;
+    if (frame_us > frame_us_max)
+        frame_us_max = frame_us;
+    frames++;
+    metricObserve(m_frame_us, frame_us);
+
+    uint32_t updates_before = updates, errors_before = imu_errors;
+    levelingService(now);
+    prev_busy_end = dwtCycles();
+    have_prev_frame = true;
+
+    uint8_t flags = bodyLevelingEnabled() ? FLIGHT_FLAG_LEVELING : 0;
+    if (updates != updates_before)
+        flags |= FLIGHT_FLAG_IMU_READ;
+    if (imu_errors != errors_before)
+        flags |= FLIGHT_FLAG_IMU_READ | FLIGHT_FLAG_IMU_ERR;
+
+    // Termin liczony od początku ramki: zapisy + zadania między ramkami
+    uint32_t deadline = now + idle_ms * cyclesPerMs();
+    if (frame_period_us > 0)
+    {
+        uint32_t busy_us = dwtCyclesToUs(prev_busy_end - frame_start);
+        if (busy_us > frame_period_us)
+        {
+            deadline_misses++;
+            metricInc(m_miss);
+            flags |= FLIGHT_FLAG_DEADLINE;
+            if (busy_us - frame_period_us > overrun_us_max)
+                overrun_us_max = busy_us - frame_period_us;
+        }
+
+        uint32_t period_end = frame_start + frame_period_us * (cyclesPerMs() / 1000U);
+        if ((int32_t)(period_end - deadline) > 0)
+            deadline = period_end;
+    }
+    flightRecCommit(frame_us, dwtCyclesToUs(prev_busy_end - now), flags);
+
+    if ((int32_t)(deadline - dwtCycles()) > 0)
+    {
+        // Pauza od końca zapisów - odczyt IMU zjada pauzę, nie wydłuża ramki
+        TRACE_BEGIN(TRACE_EV_DELAY, idle_ms);
+        while ((int32_t)(deadline - dwtCycles()) > 0)
+        {
+        }
+        TRACE_END(TRACE_EV_DELAY, idle_ms);
+    }
+}
+
+void controlFrameSetPeriod(uint32_t period_us)
+{
+    frame_period_us = period_us;
+}
+
+void controlFrameGetStats(ControlFrameStats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->frames = frames;
+    stats->frame_us_max = frame_us_max;
+    stats->level_updates = updates;
+    stats->imu_errors = imu_errors;
+    stats->read_us_max = read_us_max;
+    stats->latency_us_max = latency_us_max;
+    stats->period_us = frame_period_us;
+    stats->deadline_misses = deadline_misses;
+    stats->overrun_us_max = overrun_us_max;
+
+    if (frames > 0)
+        stats->frame_us_avg = frame_us_sum / frames;
+    if (updates + imu_errors > 0)
+        stats->read_us_avg = read_us_sum / (updates + imu_errors);
+    if (latency_count > 0)
+        stats->latency_us_avg = latency_us_sum / latency_count;
+    if (interval_us_sum > 0)
+        stats->level_rate_hz = (float)interval_count * 1e6f / (float)interval_us_sum;
+}
+
+void controlFrameResetStats(void)
+{
+    frames = frame_us_sum = frame_us_max = 0;
+    updates = imu_errors = interval_us_sum = interval_count = 0;
+    read_us_sum = read_us_max = 0;
+    latency_us_sum = latency_us_max = latency_count = 0;
+    deadline_misses = overrun_us_max = 0;
+    latency_pending = false;
+    have_prev_frame = false;
+}
+
+void controlFrameReport(void)
+{
+    static const char *const source_names[] = {"brak", "MPU-6050", "symulacja"};
+    ControlFrameStats_t s;
+    BodyLevelingState_t lv;
+    controlFrameGetStats(&s);
+    bodyLevelingGetState(&lv);
+
+    printf("\n=== RAMKI / POZIOMOWANIE ===\n");
+    printf("Ramki: %lu, zapis serw śr %lu us, max %lu us\n", s.frames, s.frame_us_avg, s.frame_us_max);
+    if (s.period_us > 0 || s.deadline_misses > 0)
+    {
+        printf("Termin ramki %lu us: przekroczony %lu razy (max o %lu us)\n",
+               s.period_us, s.deadline_misses, s.overrun_us_max);
+    }
+    printf("IMU: %s, poziomowanie %s\n", source_names[imu_source], lv.enabled ? "ON" : "OFF");
+    if (imu_source == IMU_SOURCE_NONE)
+    {
+        return;
+    }
+
+    printf("Pętla: %lu kroków, %.1f Hz (zadane %.1f Hz), błędy odczytu %lu\n",
+           s.level_updates, s.level_rate_hz, 1000.0f / (float)body_leveling_config.period_ms, s.imu_errors);
+    printf("Odczyt IMU: śr %lu us, max %lu us\n", s.read_us_avg, s.read_us_max);
+    printf("Opóźnienie próbka -> korekta: śr %lu us, max %lu us\n", s.latency_us_avg, s.latency_us_max);
+    printf("Przechył %.2f°, pochylenie %.2f°, korekta %.2f° / %.2f°\n",
+           lv.roll_deg, lv.pitch_deg, lv.corr_roll_deg, lv.corr_pitch_deg);
+}
@@ -0,0 +1,153 @@
+/*
+ * flight_rec.c - Bufor kołowy ostatnich ramek w .noinit, zrzut na żądanie i po awarii
+ */
+
+#include "flight_rec.h"
+#include "foot_contact.h"
+#include "servo_frame.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FLIGHT_REC_MAGIC 0x464C5245U // "FLRE"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t head;   // Następny slot do zapisu
+    uint32_t count;  // Zapisane ramki (<= FLIGHT_REC_FRAMES)
+    uint32_t frozen; // 1 = zamrożony przez flightRecFault()
+    uint32_t cfsr, hfsr, bfar, mmfar;
+    uint32_t fault_tick;
+    FlightFrame_t frames[FLIGHT_REC_FRAMES];
+} FlightRecorder_t;
+
+// Poza .bss - przetrwa reset po HardFault
+static FlightRecorder_t recorder __attribute__((section(".noinit")));
+
+FlightFrame_t flight_rec_current;
+static uint32_t frame_seq;
+static uint32_t servo_seq; // Następna nieprzepisana ramka PWM (servo_frame.h)
+
+static bool headerValid(void)
+{
+    return recorder.magic == FLIGHT_REC_MAGIC &&
+           recorder.head < FLIGHT_REC_FRAMES &&
+           recorder.count <= FLIGHT_REC_FRAMES;
+}
+
+bool flightRecInit(void)
+{
+    bool had_fault = headerValid() && recorder.frozen;
+
+    if (had_fault)
+    {
+        printf("\n❌ POPRZEDNIE URUCHOMIENIE: HardFault po %lu ms\n", recorder.fault_tick);
+        printf("CFSR=0x%08lX HFSR=0x%08lX BFAR=0x%08lX MMFAR=0x%08lX\n",
+               recorder.cfsr, recorder.hfsr, recorder.bfar, recorder.mmfar);
+        flightRecDump();
+    }
+
+    memset(&recorder, 0, sizeof(recorder));
+    memset(&flight_rec_current, 0, sizeof(flight_rec_current));
+    recorder.magic = FLIGHT_REC_MAGIC;
+    frame_seq = 0;
+    servo_seq = 0;
+    return had_fault;
+}
+
+void flightRecCommit(uint32_t write_us, uint32_t service_us, uint8_t flags)
+{
+    if (recorder.frozen)
+    {
+        return;
+    }
+
+    FlightFrame_t *cur = &flight_rec_current;
+    cur->seq = frame_seq++;
+    cur->tick_ms = HAL_GetTick();
+    cur->write_us = (write_us > 0xFFFFU) ? 0xFFFFU : (uint16_t)write_us;
+    cur->service_us = (service_us > 0xFFFFU) ? 0xFFFFU : (uint16_t)service_us;
+    cur->flags = flags;
+
+    // PWM nóg zapisanych w tej ramce - dzierżawa ramki serw, jedna kopia do bufora
+    const ServoFrame_t *servo = servoFrameLeaseLatest();
+    if (servo != NULL)
+    {
+        if (servo->seq >= servo_seq)
+        {
+            for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+            {
+                const uint16_t *pwm = servoFrameLegPwm(servo, leg);
+                if (pwm != NULL)
+                    memcpy(cur->pwm[leg - 1], pwm, sizeof(cur->pwm[0]));
+            }
+            cur->bus_err_mask |= (uint8_t)servo->bus_err;
+            servo_seq = servo->seq + 1;
+        }
+        servoFrameRelease(servo);
+    }
+
+    cur->contact_mask = 0;
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        if (footSwingDown(leg))
+            cur->contact_mask |= (uint8_t)(1U << (leg - 1));
+    }
+
+    memcpy(&recorder.frames[recorder.head], cur, sizeof(*cur));
+    recorder.head = (recorder.head + 1) % FLIGHT_REC_FRAMES;
+    if (recorder.count < FLIGHT_REC_FRAMES)
+        recorder.count++;
+
+    // Maski dotyczą jednej ramki, cele i PWM zostają (noga bez zapisu stoi)
+    cur->ik_fail_mask = 0;
+    cur->bus_err_mask = 0;
+}
+
+void flightRecDump(void)
+{
+    if (!headerValid())
+    {
+        printf("Rejestrator: brak danych\n");
+        return;
+    }
+
+    printf("\n=== REJESTRATOR RAMEK (%lu z %u) ===\n", recorder.count, FLIGHT_REC_FRAMES);
+    printf("seq,tick_ms,write_us,service_us,flags,ik_fail,bus_err,contact");
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        printf(",x%d,y%d,z%d,pwm%d_0,pwm%d_1,pwm%d_2", leg, leg, leg, leg, leg, leg);
+    }
+    printf("\n");
+
+    uint32_t first = (recorder.head + FLIGHT_REC_FRAMES - recorder.count) % FLIGHT_REC_FRAMES;
+    for (uint32_t n = 0; n < recorder.count; n++)
+    {
+        const FlightFrame_t *f = &recorder.frames[(first + n) % FLIGHT_REC_FRAMES];
+        printf("%lu,%lu,%u,%u,0x%02X,0x%02X,0x%02X,0x%02X",
+               f->seq, f->tick_ms, f->write_us, f->service_us,
+               f->flags, f->ik_fail_mask, f->bus_err_mask, f->contact_mask);
+        for (int leg = 0; leg < HEX_LEG_COUNT; leg++)
+        {
+            printf(",%d,%d,%d,%u,%u,%u",
+                   f->foot_cmm[leg][0], f->foot_cmm[leg][1], f->foot_cmm[leg][2],
+                   f->pwm[leg][0], f->pwm[leg][1], f->pwm[leg][2]);
+        }
+        printf("\n");
+    }
+}
+
+void flightRecFault(void)
+{
+    recorder.cfsr = SCB->CFSR;
+    recorder.hfsr = SCB->HFSR;
+    recorder.bfar = SCB->BFAR;
+    recorder.mmfar = SCB->MMFAR;
+    recorder.fault_tick = HAL_GetTick();
+    recorder.frozen = 1;
+
+    // Bez printf w HardFault - zrzut po resecie w flightRecInit()
+    __DSB();
+    NVIC_SystemReset();
+}
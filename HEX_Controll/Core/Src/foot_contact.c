@@ -0,0 +1,219 @@
+/*
+ * foot_contact.c - Przyziemienie stóp: wykrywanie kontaktu w swingu i wysokość podłoża
+ */
+
+#include "foot_contact.h"
+#include <stdio.h>
+#include <string.h>
+#include "robot_description.h"
+
+FootContactConfig_t foot_contact_config = {
+    .min_swing_t = 0.5f,  // Tylko opadająca połowa łuku - przy podnoszeniu stopa jeszcze dotyka
+    .debounce_frames = 2};
+
+typedef struct
+{
+    FootState_t pub;
+    bool swinging;
+    bool have_last_z;
+    bool start_valid;
+    float last_z;       // Wysokość wysłana w poprzedniej ramce
+    float start_z;      // Wysokość startu swingu
+    float contact_z;    // Wysokość przy pierwszym odczycie kontaktu
+    float descent_dir;  // Znak zmiany z przy opadaniu (przeciwny do pierwszego ruchu łuku)
+    uint8_t contact_frames;
+} FootTrack_t;
+
+static FootContactSource_t source = FOOT_CONTACT_SOURCE_NONE;
+static FootContactReadFn gpio_read = NULL;
+static FootTrack_t feet[HEX_LEG_COUNT];
+
+static bool sim_ground_set[HEX_LEG_COUNT];
+static float sim_ground_z[HEX_LEG_COUNT];
+
+static bool validLeg(int leg_number)
+{
+    return legNumberValid(leg_number);
+}
+
+static bool simRead(int leg_number, float foot_z)
+{
+    int i = leg_number - 1;
+    if (!sim_ground_set[i] || feet[i].descent_dir == 0.0f)
+        return false;
+
+    // Stopa doszła do podłoża lub dalej w kierunku opadania
+    return (foot_z - sim_ground_z[i]) * feet[i].descent_dir >= 0.0f;
+}
+
+static bool readContact(int leg_number, float foot_z)
+{
+    if (source == FOOT_CONTACT_SOURCE_SIM)
+        return simRead(leg_number, foot_z);
+    if (source == FOOT_CONTACT_SOURCE_GPIO && gpio_read != NULL)
+        return gpio_read(leg_number, foot_z);
+    return false;
+}
+
+void footContactSetSource(FootContactSource_t new_source, FootContactReadFn read)
+{
+    source = new_source;
+    gpio_read = read;
+    if (source == FOOT_CONTACT_SOURCE_GPIO && gpio_read == NULL)
+    {
+        source = FOOT_CONTACT_SOURCE_NONE;
+    }
+    footContactReset();
+}
+
+FootContactSource_t footContactGetSource(void)
+{
+    return source;
+}
+
+void footContactReset(void)
+{
+    memset(feet, 0, sizeof(feet));
+}
+
+void footSwingBegin(int leg_number)
+{
+    if (!validLeg(leg_number))
+        return;
+
+    FootTrack_t *f = &feet[leg_number - 1];
+    f->start_valid = f->pub.ground_valid;
+    f->start_z = f->pub.ground_z;
+    f->swinging = true;
+    f->have_last_z = false;
+    f->contact_frames = 0;
+    f->descent_dir = 0.0f;
+    f->pub.touched_down = false;
+    f->pub.touchdown_t = 0.0f;
+    f->pub.swings++;
+}
+
+bool footSwingUpdate(int leg_number, float t, float *z)
+{
+    if (source == FOOT_CONTACT_SOURCE_NONE || !validLeg(leg_number))
+        return false;
+
+    FootTrack_t *f = &feet[leg_number - 1];
+    if (!f->swinging)
+        return false;
+    if (f->pub.touched_down)
+    {
+        *z = f->pub.ground_z;
+        return true;
+    }
+
+    // Początek łuku to zawsze unoszenie (smoothstep startuje z zerową prędkością)
+    if (f->descent_dir == 0.0f && f->have_last_z && *z != f->last_z)
+    {
+        f->descent_dir = (*z > f->last_z) ? -1.0f : 1.0f;
+    }
+
+    if (t >= foot_contact_config.min_swing_t && f->have_last_z &&
+        readContact(leg_number, f->last_z))
+    {
+        // Stopa nie schodzi niżej, dopóki kontakt się nie potwierdzi albo nie zniknie
+        if (f->contact_frames == 0)
+            f->contact_z = f->last_z;
+        *z = f->contact_z;
+        if (++f->contact_frames >= foot_contact_config.debounce_frames || t >= 1.0f)
+        {
+            f->pub.touched_down = true;
+            f->pub.touchdown_t = t;
+            f->pub.ground_z = f->contact_z;
+            f->pub.ground_valid = true;
+            if (t < 1.0f)
+                f->pub.early_touchdowns++;
+        }
+        return true;
+    }
+
+    f->contact_frames = 0;
+    f->last_z = *z;
+    f->have_last_z = true;
+
+    if (t >= 1.0f)
+    {
+        // Koniec łuku bez kontaktu - podłoże nieznane, stance na base_z
+        f->pub.ground_valid = false;
+        f->pub.missed_touchdowns++;
+        f->swinging = false;
+    }
+    return false;
+}
+
+bool footSwingDown(int leg_number)
+{
+    if (!validLeg(leg_number))
+        return false;
+    return feet[leg_number - 1].pub.touched_down;
+}
+
+float footSwingStartZ(int leg_number, float fallback)
+{
+    if (source == FOOT_CONTACT_SOURCE_NONE || !validLeg(leg_number))
+        return fallback;
+
+    const FootTrack_t *f = &feet[leg_number - 1];
+    return f->start_valid ? f->start_z : fallback;
+}
+
+float footGroundZ(int leg_number, float fallback)
+{
+    if (source == FOOT_CONTACT_SOURCE_NONE || !validLeg(leg_number))
+        return fallback;
+
+    const FootState_t *s = &feet[leg_number - 1].pub;
+    return s->ground_valid ? s->ground_z : fallback;
+}
+
+void footContactGetState(int leg_number, FootState_t *state)
+{
+    if (!validLeg(leg_number))
+    {
+        memset(state, 0, sizeof(*state));
+        return;
+    }
+    *state = feet[leg_number - 1].pub;
+}
+
+void footContactSimSetGround(int leg_number, float ground_z)
+{
+    if (!validLeg(leg_number))
+        return;
+    sim_ground_set[leg_number - 1] = true;
+    sim_ground_z[leg_number - 1] = ground_z;
+}
+
+void footContactSimClear(void)
+{
+    memset(sim_ground_set, 0, sizeof(sim_ground_set));
+}
+
+void footContactReport(void)
+{
+    static const char *const source_names[] = {"brak", "GPIO", "symulacja"};
+
+    printf("\n=== KONTAKT STÓP ===\n");
+    printf("Źródło: %s\n", source_names[source]);
+    if (source == FOOT_CONTACT_SOURCE_NONE)
+    {
+        return;
+    }
+
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        const FootState_t *s = &feet[leg - 1].pub;
+        printf("Noga %d: swingi %lu, wcześniej %lu, bez kontaktu %lu, podłoże ",
+               leg, (unsigned long)s->swings, (unsigned long)s->early_touchdowns,
+               (unsigned long)s->missed_touchdowns);
+        if (s->ground_valid)
+            printf("z=%.2f cm (t=%.2f)\n", s->ground_z, s->touchdown_t);
+        else
+            printf("nieznane\n");
+    }
+}
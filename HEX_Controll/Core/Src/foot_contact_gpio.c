@@ -0,0 +1,32 @@
+/*
+ * foot_contact_gpio.c - Krańcówki w stopach na PC0..PC5 (zwierne do GND, pull-up)
+ */
+
+#include "foot_contact.h"
+#include "stm32f4xx_hal.h"
+#include "robot_description.h"
+
+// Noga 1..6 -> PC0..PC5 (złącze CN7/CN8 Nucleo, wolne od I2C/UART/LED)
+_Static_assert(HEX_LEG_COUNT <= 6, "foot_contact_gpio: krańcówki tylko na PC0..PC5");
+static const uint16_t contact_pins[6] = {
+    GPIO_PIN_0, GPIO_PIN_1, GPIO_PIN_2, GPIO_PIN_3, GPIO_PIN_4, GPIO_PIN_5};
+
+static bool gpioRead(int leg_number, float foot_z)
+{
+    (void)foot_z;
+    return HAL_GPIO_ReadPin(GPIOC, contact_pins[leg_number - 1]) == GPIO_PIN_RESET;
+}
+
+void footContactGpioInit(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+
+    GPIO_InitStruct.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5;
+    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+    footContactSetSource(FOOT_CONTACT_SOURCE_GPIO, gpioRead);
+}
@@ -4,35 +4,51 @@
  */
 
 #include "hexapod_kinematics.h"
+#include "trace.h"
+#include "hot_path.h"
+#include "robot_description.h"
+
+#define LEG_ORIGIN(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) {ox, oy, right, right},
+
+#define ROBOT_GEOMETRY_URDF                      \
+    {                                            \
+        .l1 = L1,                                \
+        .l2 = L2,                                \
+        .l3 = L3,                                \
+        .origins = {ROBOT_LEG_TABLE(LEG_ORIGIN)} \
+    }
+
+// Geometria z URDF (tabela w robot_description.h) - we flash, do przywrócenia wartości domyślnych
+const RobotGeometry_t robot_geometry_urdf = ROBOT_GEOMETRY_URDF;
+
+// Geometria w SRAM dla IK - configParamsLoad() kopiuje tu rekord z config_store
+HOT_CONST RobotGeometry_t robot_geometry_default = ROBOT_GEOMETRY_URDF;
 
-const LegOrigin_t leg_origins[6] = {
-    {6.8956f, -7.7136f, false, false}, // Noga 1 - lewa przednia
-    {-8.6608f, -7.7136f, true, true},  // Noga 2 - prawa przednia
-    {10.1174f, 0.0645f, false, false}, // Noga 3 - lewa środkowa
-    {-11.8826f, -0.0645f, true, true}, // Noga 4 - prawa środkowa
-    {6.8956f, 7.8427f, false, false},  // Noga 5 - lewa tylna
-    {-8.6608f, 7.8427f, true, true}    // Noga 6 - prawa tylna
-};
+const RobotGeometry_t *robot_geometry = &robot_geometry_default;
 
 // Kinematyka odwrotna - SKOPIOWANA Z ROS
-bool computeLegIK(int leg_number, float x, float y, float z,
-                  float *q1, float *q2, float *q3)
+// Ciało wspólne dla kopii w SRAM (computeLegIK) i we flash (computeLegIKFlash)
+static inline __attribute__((always_inline)) bool legIKSolve(int leg_number, float x, float y, float z,
+                                                             float *q1, float *q2, float *q3)
 {
-    if (leg_number < 1 || leg_number > 6 || q1 == NULL || q2 == NULL || q3 == NULL)
+    if (!legNumberValid(leg_number) || q1 == NULL || q2 == NULL || q3 == NULL)
     {
         return false;
     }
 
+    TRACE_BEGIN(TRACE_EV_IK, leg_number);
+
     // Pobierz konfigurację dla danej nogi
-    const LegOrigin_t *leg = &leg_origins[leg_number - 1];
+    const RobotGeometry_t *geo = robot_geometry;
+    const LegOrigin_t *leg = &geo->origins[leg_number - 1];
 
-    printf("Leg %d IK input - x: %.2f, y: %.2f, z: %.2f\n", leg_number, x, y, z);
+    IK_LOG("Leg %d IK input - x: %.2f, y: %.2f, z: %.2f\n", leg_number, x, y, z);
 
     // 1. Przekształcenie do lokalnego układu współrzędnych nogi
     float local_x = x - leg->x;
     float local_y = y - leg->y;
 
-    printf("Leg %d - local coords: x=%.3f, y=%.3f\n", leg_number, local_x, local_y);
+    IK_LOG("Leg %d - local coords: x=%.3f, y=%.3f\n", leg_number, local_x, local_y);
 
     // 2. Obliczenie kąta biodra (obrót wokół osi Z)
     *q1 = atan2f(local_y, local_x);
@@ -46,39 +62,40 @@ bool computeLegIK(int leg_number, float x, float y, float z,
             *q1 = *q1 + M_PI;
     }
 
-    printf("Leg %d - hip angle before constraints: %.2f deg\n", leg_number, *q1 * 180.0f / M_PI);
+    IK_LOG("Leg %d - hip angle before constraints: %.2f deg\n", leg_number, *q1 * 180.0f / M_PI);
 
     // 3. Obliczenie odległości radialnej od osi biodra
-    float r = sqrtf(local_x * local_x + local_y * local_y) - L1;
+    float r = sqrtf(local_x * local_x + local_y * local_y) - geo->l1;
     float h = -z; // Zmiana znaku, bo oś Z jest skierowana w dół
 
-    printf("Leg %d - r=%.2f, h=%.2f\n", leg_number, r, h);
+    IK_LOG("Leg %d - r=%.2f, h=%.2f\n", leg_number, r, h);
 
     // 4. Sprawdzenie czy punkt jest w zasięgu nogi
     float D2 = r * r + h * h;
     float D = sqrtf(D2);
 
-    printf("Leg %d - distance D=%.2f, max_reach=%.2f, min_reach=%.2f\n",
-           leg_number, D, L2 + L3, fabsf(L2 - L3));
+    IK_LOG("Leg %d - distance D=%.2f, max_reach=%.2f, min_reach=%.2f\n",
+           leg_number, D, geo->l2 + geo->l3, fabsf(geo->l2 - geo->l3));
 
-    if (D > (L2 + L3) || D < fabsf(L2 - L3))
+    if (D > (geo->l2 + geo->l3) || D < fabsf(geo->l2 - geo->l3))
     {
-        printf("Leg %d IK failed - Distance %.2f out of range [%.2f, %.2f]\n",
-               leg_number, D, fabsf(L2 - L3), L2 + L3);
-        printf("  Target: x=%.2f, y=%.2f, z=%.2f\n", x, y, z);
-        printf("  Local: x=%.2f, y=%.2f\n", local_x, local_y);
-        printf("  r=%.2f, h=%.2f\n", r, h);
+        IK_LOG("Leg %d IK failed - Distance %.2f out of range [%.2f, %.2f]\n",
+               leg_number, D, fabsf(geo->l2 - geo->l3), geo->l2 + geo->l3);
+        IK_LOG("  Target: x=%.2f, y=%.2f, z=%.2f\n", x, y, z);
+        IK_LOG("  Local: x=%.2f, y=%.2f\n", local_x, local_y);
+        IK_LOG("  r=%.2f, h=%.2f\n", r, h);
+        TRACE_END(TRACE_EV_IK, leg_number);
         return false;
     }
 
     // 5. Obliczenie gamma (kąt między L2 i L3)
-    float cos_gamma = (D2 - L2 * L2 - L3 * L3) / (2.0f * L2 * L3);
+    float cos_gamma = (D2 - geo->l2 * geo->l2 - geo->l3 * geo->l3) / (2.0f * geo->l2 * geo->l3);
     cos_gamma = fmaxf(-1.0f, fminf(1.0f, cos_gamma));
     float gamma = acosf(cos_gamma);
 
     // 6. Obliczenie kąta kolana (q2)
     float alpha = atan2f(h, r);
-    float beta = acosf((D2 + L2 * L2 - L3 * L3) / (2.0f * L2 * D));
+    float beta = acosf((D2 + geo->l2 * geo->l2 - geo->l3 * geo->l3) / (2.0f * geo->l2 * D));
     *q2 = -(alpha - beta);
 
     // 7. Obliczenie kąta kostki (q3)
@@ -93,16 +110,97 @@ bool computeLegIK(int leg_number, float x, float y, float z,
         *q3 = -(M_PI - gamma);
     }
 
-    printf("Leg %d final angles [deg]: hip=%.1f, knee=%.1f, ankle=%.1f\n",
+    IK_LOG("Leg %d final angles [deg]: hip=%.1f, knee=%.1f, ankle=%.1f\n",
            leg_number, *q1 * 180.0f / M_PI, *q2 * 180.0f / M_PI, *q3 * 180.0f / M_PI);
 
+    TRACE_END(TRACE_EV_IK, leg_number);
     return true;
 }
 
+HOT_FUNC bool computeLegIK(int leg_number, float x, float y, float z,
+                           float *q1, float *q2, float *q3)
+{
+    return legIKSolve(leg_number, x, y, z, q1, q2, q3);
+}
+
+#if HEX_PERF_BENCHMARK
+// Ta sama IK bez HOT_FUNC - porównanie flash/SRAM w perf_bench.c
+bool computeLegIKFlash(int leg_number, float x, float y, float z,
+                       float *q1, float *q2, float *q3)
+{
+    return legIKSolve(leg_number, x, y, z, q1, q2, q3);
+}
+#endif
+
+// IK wielu nóg naraz - ten sam algorytm co legIKSolve(), etapami po wszystkich wpisach
+HOT_FUNC bool computeLegIKBatch(LegIKBatch_t *batch)
+{
+    if (batch == NULL || batch->count > HEX_LEG_COUNT)
+    {
+        return false;
+    }
+    batch->ok = 0;
+    for (int i = 0; i < batch->count; i++)
+    {
+        if (!legNumberValid(batch->leg[i]))
+        {
+            return false;
+        }
+    }
+
+    TRACE_BEGIN(TRACE_EV_IK, 0);
+
+    const RobotGeometry_t *geo = robot_geometry;
+    const int n = batch->count;
+    const float l2 = geo->l2, l3 = geo->l3;
+    const float reach_max = l2 + l3;
+    const float reach_min = fabsf(l2 - l3);
+    float r[HEX_LEG_COUNT], h[HEX_LEG_COUNT], D2[HEX_LEG_COUNT];
+    LegMask_t ok = 0;
+
+    // 1. Biodro, odległość radialna i zasięg
+    for (int i = 0; i < n; i++)
+    {
+        const LegOrigin_t *leg = &geo->origins[batch->leg[i] - 1];
+        float local_x = batch->x[i] - leg->x;
+        float local_y = batch->y[i] - leg->y;
+
+        float q1 = atan2f(local_y, local_x);
+        float flip = (q1 > 0) ? q1 - M_PI : q1 + M_PI;
+        batch->q1[i] = leg->invert_hip ? flip : q1;
+
+        r[i] = sqrtf(local_x * local_x + local_y * local_y) - geo->l1;
+        h[i] = -batch->z[i];
+        D2[i] = r[i] * r[i] + h[i] * h[i];
+
+        float D = sqrtf(D2[i]);
+        ok |= (LegMask_t)(D <= reach_max && D >= reach_min) << i;
+    }
+
+    // 2. Kolano i kostka - q3 = γ - π po obu stronach (dla lewej -(π - γ) to ta sama wartość)
+    for (int i = 0; i < n; i++)
+    {
+        float cos_gamma = (D2[i] - l2 * l2 - l3 * l3) / (2.0f * l2 * l3);
+        cos_gamma = fmaxf(-1.0f, fminf(1.0f, cos_gamma));
+        float gamma = acosf(cos_gamma);
+
+        float alpha = atan2f(h[i], r[i]);
+        float beta = acosf((D2[i] + l2 * l2 - l3 * l3) / (2.0f * l2 * sqrtf(D2[i])));
+        batch->q2[i] = -(alpha - beta);
+        batch->q3[i] = gamma - M_PI;
+    }
+
+    batch->ok = ok;
+
+    TRACE_END(TRACE_EV_IK, 0);
+    return ok == (LegMask_t)((1ULL << n) - 1U);
+}
+
 // Debug funkcja IK - SKOPIOWANA Z ROS
 bool debugLegIK(int leg_number, float x, float y, float z)
 {
-    const LegOrigin_t *leg = &leg_origins[leg_number - 1];
+    const RobotGeometry_t *geo = robot_geometry;
+    const LegOrigin_t *leg = &geo->origins[leg_number - 1];
 
     printf("=== DEBUG IK dla nogi %d ===\n", leg_number);
     printf("Cel: x=%.2f, y=%.2f, z=%.2f\n", x, y, z);
@@ -117,24 +215,24 @@ bool debugLegIK(int leg_number, float x, float y, float z)
     printf("Lokalne: x=%.2f, y=%.2f\n", local_x, local_y);
 
     // Odległość radialna
-    float r = sqrtf(local_x * local_x + local_y * local_y) - L1;
+    float r = sqrtf(local_x * local_x + local_y * local_y) - geo->l1;
     float h = -z;
     float D = sqrtf(r * r + h * h);
 
     printf("r=%.2f, h=%.2f, D=%.2f\n", r, h, D);
-    printf("Zasięg: min=%.2f, max=%.2f\n", fabsf(L2 - L3), L2 + L3);
-    printf("Długości segmentów: L1=%.1f, L2=%.1f, L3=%.1f\n", L1, L2, L3);
+    printf("Zasięg: min=%.2f, max=%.2f\n", fabsf(geo->l2 - geo->l3), geo->l2 + geo->l3);
+    printf("Długości segmentów: L1=%.1f, L2=%.1f, L3=%.1f\n", geo->l1, geo->l2, geo->l3);
 
-    if (D > (L2 + L3))
+    if (D > (geo->l2 + geo->l3))
     {
         printf("Cel za daleko! D=%.2f > max=%.2f (różnica: %.2f)\n",
-               D, L2 + L3, D - (L2 + L3));
+               D, geo->l2 + geo->l3, D - (geo->l2 + geo->l3));
         return false;
     }
 
-    if (D < fabsf(L2 - L3))
+    if (D < fabsf(geo->l2 - geo->l3))
     {
-        printf("Cel za blisko! D=%.2f < min=%.2f\n", D, fabsf(L2 - L3));
+        printf("Cel za blisko! D=%.2f < min=%.2f\n", D, fabsf(geo->l2 - geo->l3));
         return false;
     }
 
@@ -159,24 +257,14 @@ void testAllBasePositions(void)
 {
     printf("=== TESTOWANIE WSZYSTKICH POZYCJI BAZOWYCH ===\n");
 
-    // Pozycje bazowe z ROS (w cm)
-    const float base_positions[6][3] = {
-        {18.0f, -15.0f, -24.0f},  // Noga 1
-        {-18.0f, -15.0f, -24.0f}, // Noga 2
-        {22.0f, 0.0f, -24.0f},    // Noga 3
-        {-22.0f, 0.0f, -24.0f},   // Noga 4
-        {18.0f, 15.0f, -24.0f},   // Noga 5
-        {-18.0f, 15.0f, -24.0f}   // Noga 6
-    };
-
     bool all_ok = true;
 
-    for (int leg = 1; leg <= 6; leg++)
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
     {
         printf("\n--- NOGA %d ---\n", leg);
-        float x = base_positions[leg - 1][0];
-        float y = base_positions[leg - 1][1];
-        float z = base_positions[leg - 1][2];
+        float x = robot_description.stance_x[leg - 1];
+        float y = robot_description.stance_y[leg - 1];
+        float z = ROBOT_STANCE_Z;
 
         bool result = debugLegIK(leg, x, y, z);
         if (!result)
@@ -204,4 +292,123 @@ void testAllBasePositions(void)
         printf("Niektóre pozycje są poza zasięgiem!\n");
         printf("Rozważ zmniejszenie step_length lub pozycji bazowych\n");
     }
-}
\ No newline at end of file
+}
+
+// Kąty w płaszczyźnie nogi (oś h w dół): udo θ2 = -q2, podudzie θ3 = θ2 + γ, γ = q3 + π
+static void legPlaneAngles(float q2, float q3, float *theta2, float *theta3)
+{
+    *theta2 = -q2;
+    *theta3 = -q2 + q3 + (float)M_PI;
+}
+
+// Kinematyka prosta - odwrotność computeLegIK()
+bool computeLegFK(int leg_number, float q1, float q2, float q3,
+                  float *x, float *y, float *z)
+{
+    if (!legNumberValid(leg_number) || x == NULL || y == NULL || z == NULL)
+    {
+        return false;
+    }
+
+    const RobotGeometry_t *geo = robot_geometry;
+    const LegOrigin_t *leg = &geo->origins[leg_number - 1];
+
+    float theta2, theta3;
+    legPlaneAngles(q2, q3, &theta2, &theta3);
+
+    // Odległość stopy od osi biodra i wysokość (w dół) w płaszczyźnie nogi
+    float rho = geo->l1 + geo->l2 * cosf(theta2) + geo->l3 * cosf(theta3);
+    float h = geo->l2 * sinf(theta2) + geo->l3 * sinf(theta3);
+
+    // Prawe nogi mają kąt biodra obrócony o π
+    float side = leg->invert_hip ? -1.0f : 1.0f;
+
+    *x = leg->x + side * rho * cosf(q1);
+    *y = leg->y + side * rho * sinf(q1);
+    *z = -h;
+
+    return true;
+}
+
+// Analityczny jakobian computeLegFK()
+bool computeLegJacobian(int leg_number, float q1, float q2, float q3,
+                        float J[3][3])
+{
+    if (!legNumberValid(leg_number) || J == NULL)
+    {
+        return false;
+    }
+
+    const RobotGeometry_t *geo = robot_geometry;
+    const LegOrigin_t *leg = &geo->origins[leg_number - 1];
+
+    float theta2, theta3;
+    legPlaneAngles(q2, q3, &theta2, &theta3);
+
+    float s2 = sinf(theta2), c2 = cosf(theta2);
+    float s3 = sinf(theta3), c3 = cosf(theta3);
+
+    float rho = geo->l1 + geo->l2 * c2 + geo->l3 * c3;
+
+    // dθ2/dq2 = dθ3/dq2 = -1, dθ3/dq3 = 1
+    float drho_dq2 = geo->l2 * s2 + geo->l3 * s3;
+    float drho_dq3 = -geo->l3 * s3;
+    float dh_dq2 = -geo->l2 * c2 - geo->l3 * c3;
+    float dh_dq3 = geo->l3 * c3;
+
+    float side = leg->invert_hip ? -1.0f : 1.0f;
+    float c1 = side * cosf(q1);
+    float s1 = side * sinf(q1);
+
+    J[0][0] = -s1 * rho;
+    J[0][1] = c1 * drho_dq2;
+    J[0][2] = c1 * drho_dq3;
+
+    J[1][0] = c1 * rho;
+    J[1][1] = s1 * drho_dq2;
+    J[1][2] = s1 * drho_dq3;
+
+    J[2][0] = 0.0f;
+    J[2][1] = -dh_dq2;
+    J[2][2] = -dh_dq3;
+
+    return true;
+}
+
+// Uwarunkowanie jakobianu - σ biodra = |ρ|, σ kolano/kostka z macierzy 2x2
+float legJacobianCondition(int leg_number, float q1, float q2, float q3)
+{
+    float J[3][3];
+    if (!computeLegJacobian(leg_number, q1, q2, q3, J))
+    {
+        return INFINITY;
+    }
+
+    float sigma_hip = hypotf(J[0][0], J[1][0]);
+
+    // Płaski jakobian: [dρ/dq2 dρ/dq3; dz/dq2 dz/dq3]
+    float side = robot_geometry->origins[leg_number - 1].invert_hip ? -1.0f : 1.0f;
+    float c1 = side * cosf(q1);
+    float s1 = side * sinf(q1);
+    float a = J[0][1] * c1 + J[1][1] * s1;
+    float b = J[0][2] * c1 + J[1][2] * s1;
+    float c = J[2][1];
+    float d = J[2][2];
+
+    // Wartości szczególne macierzy 2x2 w postaci zamkniętej
+    float sum = a * a + b * b + c * c + d * d;
+    float det = fabsf(a * d - b * c);
+    float disc = sqrtf(fmaxf(0.0f, sum * sum - 4.0f * det * det));
+    float sigma_big = sqrtf(0.5f * (sum + disc));
+    float sigma_small = (sigma_big > 0.0f) ? det / sigma_big : 0.0f;
+
+    float sigma_max = fmaxf(sigma_hip, sigma_big);
+    float sigma_min = fminf(sigma_hip, sigma_small);
+
+    if (sigma_min <= 1e-6f)
+    {
+        return INFINITY;
+    }
+
+    return sigma_max / sigma_min;
+}
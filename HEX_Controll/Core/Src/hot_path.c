@@ -0,0 +1,30 @@
+/*
+ * hot_path.c - Raport akceleratora flash i kodu w SRAM
+ */
+
+#include "hot_path.h"
+#include "hexapod_kinematics.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+
+// Granice kodu/tablic kopiowanych do SRAM (STM32F446XX_FLASH.ld)
+extern uint32_t _sramfunc;
+extern uint32_t _eramfunc;
+
+void hotPathReport(void)
+{
+    uint32_t acr = FLASH->ACR;
+
+    printf("\n=== FLASH / ART ===\n");
+    printf("SYSCLK %lu MHz, latency %lu WS\n",
+           SystemCoreClock / 1000000U, (acr & FLASH_ACR_LATENCY) >> FLASH_ACR_LATENCY_Pos);
+    printf("Prefetch: %s, I-cache: %s, D-cache: %s\n",
+           (acr & FLASH_ACR_PRFTEN) ? "ON" : "OFF",
+           (acr & FLASH_ACR_ICEN) ? "ON" : "OFF",
+           (acr & FLASH_ACR_DCEN) ? "ON" : "OFF");
+
+    uint32_t ram_code = (uint32_t)((uintptr_t)&_eramfunc - (uintptr_t)&_sramfunc);
+    uint32_t ik_addr = (uint32_t)(uintptr_t)&computeLegIK;
+    printf("Kod/tablice w SRAM: %lu B, computeLegIK @ 0x%08lX (%s)\n",
+           ram_code, ik_addr, (ik_addr >= SRAM1_BASE && ik_addr < SRAM1_BASE + 0x20000U) ? "SRAM" : "flash");
+}
@@ -0,0 +1,53 @@
+/*
+ * imu_sim.c - Symulowany czujnik inercyjny (bez HAL)
+ */
+
+#include "imu.h"
+#include <math.h>
+
+static float sim_roll = 0.0f;  // [rad]
+static float sim_pitch = 0.0f; // [rad]
+static float prev_roll = 0.0f;
+static float prev_pitch = 0.0f;
+static float noise_accel = 0.0f;
+static float noise_gyro = 0.0f;
+static uint32_t noise_state = 0x12345678U;
+
+// Szum równomierny [-1, 1] (xorshift32 - powtarzalny między uruchomieniami)
+static float noise(void)
+{
+    noise_state ^= noise_state << 13;
+    noise_state ^= noise_state >> 17;
+    noise_state ^= noise_state << 5;
+    return (float)(noise_state >> 8) / (float)(1U << 23) - 1.0f;
+}
+
+void imuSimSetTilt(float roll_deg, float pitch_deg)
+{
+    sim_roll = roll_deg * (float)M_PI / 180.0f;
+    sim_pitch = pitch_deg * (float)M_PI / 180.0f;
+}
+
+void imuSimSetNoise(float accel_g, float gyro_dps)
+{
+    noise_accel = accel_g;
+    noise_gyro = gyro_dps;
+}
+
+void imuSimRead(ImuSample_t *sample, float dt)
+{
+    // Grawitacja w układzie korpusu: lewa strona wyżej -> +X, tył wyżej -> +Y
+    sample->accel_g[0] = sinf(sim_roll) * cosf(sim_pitch) + noise_accel * noise();
+    sample->accel_g[1] = sinf(sim_pitch) + noise_accel * noise();
+    sample->accel_g[2] = cosf(sim_roll) * cosf(sim_pitch) + noise_accel * noise();
+
+    // Przechył (lewa w górę) to obrót wokół -Y, pochylenie (tył w górę) wokół +X
+    float roll_rate = (dt > 0.0f) ? (sim_roll - prev_roll) / dt : 0.0f;
+    float pitch_rate = (dt > 0.0f) ? (sim_pitch - prev_pitch) / dt : 0.0f;
+    sample->gyro_dps[0] = pitch_rate * 180.0f / (float)M_PI + noise_gyro * noise();
+    sample->gyro_dps[1] = -roll_rate * 180.0f / (float)M_PI + noise_gyro * noise();
+    sample->gyro_dps[2] = noise_gyro * noise();
+
+    prev_roll = sim_roll;
+    prev_pitch = sim_pitch;
+}
@@ -0,0 +1,161 @@
+/*
+ * joint_interp.c - Hermite kątów stawów między keyframe'ami IK
+ */
+
+#include "joint_interp.h"
+#include "hexapod_kinematics.h"
+#include "hot_path.h"
+#include <math.h>
+
+JointInterpConfig_t joint_interp_config = {
+    .enabled = true,
+    .stride = 4,          // 30 punktów fazy -> 9 IK zamiast 31
+    .max_error_cm = 0.1f, // ~rozdzielczość serwa na końcu nogi
+};
+
+#define KEY(track, k) ((track)->q[(k) & (JOINT_INTERP_WINDOW - 1)])
+
+_Static_assert((JOINT_INTERP_WINDOW & (JOINT_INTERP_WINDOW - 1)) == 0, "joint_interp: okno musi być potęgą 2");
+
+HOT_FUNC static uint16_t keyPoint(const JointTrack_t *track, uint16_t k)
+{
+    uint32_t p = (uint32_t)k * track->stride;
+    return (p > track->points) ? track->points : (uint16_t)p;
+}
+
+static bool solveKey(JointTrack_t *track, uint16_t k)
+{
+    float foot[3];
+    float *q = KEY(track, k);
+
+    track->path(track->leg_number, (float)keyPoint(track, k) / (float)track->points, foot);
+    return computeLegIK(track->leg_number, foot[0], foot[1], foot[2], &q[0], &q[1], &q[2]);
+}
+
+HOT_FUNC static void tangent(const JointTrack_t *track, uint16_t k, float m[3])
+{
+    uint16_t a = (k > 0) ? k - 1 : k;
+    uint16_t b = (k < track->last_key) ? k + 1 : k;
+    float span = (float)(keyPoint(track, b) - keyPoint(track, a));
+    const float *qa = KEY(track, a);
+    const float *qb = KEY(track, b);
+
+    for (int j = 0; j < 3; j++)
+    {
+        m[j] = (qb[j] - qa[j]) / span;
+    }
+}
+
+void jointTrackBegin(JointTrack_t *track, int leg_number, JointPathFn path,
+                     uint16_t points, uint8_t stride)
+{
+    track->path = path;
+    track->points = points;
+    track->stride = (stride < 1) ? 1 : stride;
+    track->last_key = (uint16_t)((points + track->stride - 1) / track->stride);
+    track->solved = -1;
+    track->leg_number = (uint8_t)leg_number;
+    track->valid = (path != NULL && points > 0 && legNumberValid(leg_number));
+}
+
+HOT_FUNC bool jointTrackSample(JointTrack_t *track, uint16_t i, float q[3])
+{
+    if (!track->valid || i > track->points)
+    {
+        return false;
+    }
+
+    uint16_t seg = i / track->stride;
+    if (seg >= track->last_key)
+        seg = track->last_key - 1; // i == points - koniec ostatniego odcinka
+
+    // Okno musi obejmować q_seg-1 .. q_seg+2
+    int16_t oldest = (seg > 0) ? (int16_t)(seg - 1) : 0;
+    int16_t newest = (seg + 2 < track->last_key) ? (int16_t)(seg + 2) : (int16_t)track->last_key;
+    if (oldest <= track->solved - JOINT_INTERP_WINDOW)
+    {
+        track->valid = false;
+        return false;
+    }
+    while (track->solved < newest)
+    {
+        if (!solveKey(track, (uint16_t)(track->solved + 1)))
+        {
+            track->valid = false;
+            return false;
+        }
+        track->solved++;
+    }
+
+    uint16_t p0 = keyPoint(track, seg);
+    float h = (float)(keyPoint(track, seg + 1) - p0);
+    float u = (float)(i - p0) / h;
+    float u2 = u * u;
+    float u3 = u2 * u;
+    float h00 = 2.0f * u3 - 3.0f * u2 + 1.0f;
+    float h10 = u3 - 2.0f * u2 + u;
+    float h01 = -2.0f * u3 + 3.0f * u2;
+    float h11 = u3 - u2;
+
+    float m0[3], m1[3];
+    tangent(track, seg, m0);
+    tangent(track, seg + 1, m1);
+    const float *q0 = KEY(track, seg);
+    const float *q1 = KEY(track, seg + 1);
+
+    for (int j = 0; j < 3; j++)
+    {
+        q[j] = h00 * q0[j] + h10 * h * m0[j] + h01 * q1[j] + h11 * h * m1[j];
+    }
+    return true;
+}
+
+float jointTrackMaxError(int leg_number, JointPathFn path, uint16_t points, uint8_t stride)
+{
+    JointTrack_t track;
+    float worst = 0.0f;
+
+    jointTrackBegin(&track, leg_number, path, points, stride);
+    for (uint16_t i = 0; i <= points; i++)
+    {
+        float q[3], foot[3], x, y, z;
+
+        if (!jointTrackSample(&track, i, q) ||
+            !computeLegFK(leg_number, q[0], q[1], q[2], &x, &y, &z))
+        {
+            return INFINITY;
+        }
+
+        path(leg_number, (float)i / (float)points, foot);
+        float dx = x - foot[0];
+        float dy = y - foot[1];
+        float dz = z - foot[2];
+        float err = sqrtf(dx * dx + dy * dy + dz * dz);
+        if (err > worst)
+            worst = err;
+    }
+    return worst;
+}
+
+uint8_t jointInterpPlanStride(int leg_number, JointPathFn path, uint16_t points, float *max_error)
+{
+    if (max_error != NULL)
+        *max_error = 0.0f;
+    if (!joint_interp_config.enabled)
+    {
+        return 1;
+    }
+
+    // Błąd rośnie ze stride - pierwszy od góry mieszczący się w granicy
+    for (uint8_t stride = joint_interp_config.stride; stride >= 2; stride--)
+    {
+        float err = jointTrackMaxError(leg_number, path, points, stride);
+        if (err <= joint_interp_config.max_error_cm)
+        {
+            if (max_error != NULL)
+                *max_error = err;
+            return stride;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,65 @@
+/*
+ * leg_config.c - Domyślne mapowanie nóg i limity PWM serw
+ */
+
+#include "leg_config.h"
+
+#define PWM_DEFAULT {LEG_CONFIG_PWM_MIN_DEFAULT, LEG_CONFIG_PWM_MAX_DEFAULT}
+#define LEG_PWM_DEFAULT {PWM_DEFAULT, PWM_DEFAULT, PWM_DEFAULT}
+
+#define LEG_MAPPING(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) {channel, hip, device},
+#define LEG_SERVO(...) LEG_PWM_DEFAULT,
+
+// Kontroler, kanały i offsety bioder z ROBOT_LEG_TABLE (robot_description.h)
+const LegConfig_t leg_config_default = {
+    .legs = {ROBOT_LEG_TABLE(LEG_MAPPING)},
+    .servo = {ROBOT_LEG_TABLE(LEG_SERVO)}};
+
+const LegConfig_t *leg_config = &leg_config_default;
+
+uint16_t legConfigAngleToPwm(const ServoPwmLimits_t *limits, float angle)
+{
+    if (angle < 0.0f)
+        angle = 0.0f;
+    if (angle > 180.0f)
+        angle = 180.0f;
+
+    // Jak PCA9685_SetServoAngle(), ale z zakresem danego serwa
+    int32_t range = (int32_t)limits->pwm_max - (int32_t)limits->pwm_min;
+    return (uint16_t)((int32_t)limits->pwm_min + (int32_t)((angle / 180.0f) * (float)range));
+}
+
+bool legConfigValidate(const LegConfig_t *config)
+{
+    for (int leg = 0; leg < HEX_LEG_COUNT; leg++)
+    {
+        const LegMapping_t *m = &config->legs[leg];
+        if (m->base_channel > 13 || m->device >= LEG_CONFIG_MAX_DEVICES ||
+            m->hip_offset_deg < -90.0f || m->hip_offset_deg > 90.0f)
+        {
+            return false;
+        }
+
+        // Dwie nogi na tych samych kanałach jednego kontrolera - błąd okablowania
+        for (int other = 0; other < leg; other++)
+        {
+            const LegMapping_t *o = &config->legs[other];
+            if (o->device == m->device && o->base_channel + 3 > m->base_channel &&
+                m->base_channel + 3 > o->base_channel)
+            {
+                return false;
+            }
+        }
+
+        for (int joint = 0; joint < 3; joint++)
+        {
+            const ServoPwmLimits_t *s = &config->servo[leg][joint];
+            // PCA9685: 12 bitów, 4096 = pełny okres; min == max to martwe serwo
+            if (s->pwm_min >= 4096 || s->pwm_max >= 4096 || s->pwm_min == s->pwm_max)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
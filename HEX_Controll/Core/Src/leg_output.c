@@ -0,0 +1,390 @@
+/*
+ * leg_output.c - Kąty IK -> PWM serw nogi według leg_config
+ */
+
+#include "leg_output.h"
+#include "servo_bus.h"
+#include "servo_frame.h"
+#include "servo_estop.h"
+#include "hexapod_kinematics.h"
+#include "body_leveling.h"
+#include "trace.h"
+#include "metrics.h"
+#include "flight_rec.h"
+#include "dwt_timer.h"
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+// Domyślne zakresy muszą odpowiadać dotychczasowemu PCA9685_SetServoAngle()
+_Static_assert(LEG_CONFIG_PWM_MIN_DEFAULT == SERVO_PWM_MIN, "leg_config: PWM min != SERVO_PWM_MIN");
+_Static_assert(LEG_CONFIG_PWM_MAX_DEFAULT == SERVO_PWM_MAX, "leg_config: PWM max != SERVO_PWM_MAX");
+
+static Metric_t *m_ik_fail;   // Punkty poza zasięgiem IK
+static Metric_t *m_servo_err; // Nieudane zapisy PWM nogi (I2C)
+
+LegOutputOrder_t leg_output_order = LEG_ORDER_SWING_FIRST;
+
+// Noga stance czekająca na legOutputFlush() - PWM zostaje w ramce
+typedef struct
+{
+    PCA9685_Handle_t *pca;
+    uint8_t device;
+    uint8_t channel;
+    bool on_bus; // Kontroler z servo_bus - zapis w servoBusFlushFrame()
+    const uint16_t *pwm;
+} StagedLeg_t;
+
+static StagedLeg_t staged[HEX_LEG_COUNT];
+static LegMask_t staged_mask;
+static bool in_frame;                         // Między legOutputFrameBegin() a legOutputFlush()
+static ServoFrame_t *frame;                   // Ramka PWM bieżącej ramki (NULL - pula pusta)
+static uint32_t frame_begin;
+static LegMask_t swing_mask, prev_swing_mask;
+static LegMask_t written_mask;                // Nogi zapisane w bieżącej ramce
+static uint32_t write_us[HEX_LEG_COUNT];      // Koniec zapisu nogi od początku ramki
+static uint32_t last_swing_us[HEX_LEG_COUNT]; // Z ostatniej ramki swing - do przyziemienia
+static LegOutputTiming_t timing[2];
+
+void legOutputInit(void)
+{
+    m_ik_fail = metricsRegisterCounter("ik_fail", NULL);
+    m_servo_err = metricsRegisterCounter("servo_bus_err", NULL);
+}
+
+static float clampServo(float angle)
+{
+    if (angle < 0.0f)
+        return 0.0f;
+    if (angle > 180.0f)
+        return 180.0f;
+    return angle;
+}
+
+static void recordWrite(int leg_number, const uint16_t pwm[3], bool ok, uint32_t end_cycles)
+{
+    if (!ok)
+    {
+        metricInc(m_servo_err);
+    }
+
+    // Z ramki PWM rejestrator bierze wartości w flightRecCommit() - tu tylko wynik
+    if (frame != NULL && (frame->legs & LEG_BIT(leg_number)))
+    {
+        if (!ok)
+            frame->bus_err |= LEG_BIT(leg_number);
+    }
+    else
+    {
+        flightRecJoints(leg_number, pwm, ok);
+    }
+
+    if (in_frame)
+    {
+        write_us[leg_number - 1] = dwtCyclesToUs(end_cycles - frame_begin);
+        written_mask |= LEG_BIT(leg_number);
+    }
+}
+
+static bool writeLeg(int leg_number, PCA9685_Handle_t *pca, uint8_t channel, const uint16_t pwm[3])
+{
+    if (servoEstopActive())
+    {
+        return false; // Stop awaryjny - kanały wyłączone do servoEstopRelease()
+    }
+
+    bool ok = PCA9685_SetPWMMulti(pca, channel, pwm, 3);
+    if (servoEstopActive())
+    {
+        // Stop wyzwolony w trakcie zapisu - ten zapis mógł włączyć kanały z powrotem
+        servoEstopTrigger();
+        ok = false;
+    }
+    recordWrite(leg_number, pwm, ok, dwtCycles());
+    return ok;
+}
+
+/**
+ * @brief Kontroler nogi: urządzenie servo_bus, a przed servoBusAddDevice()
+ *        (np. benchmark) pca1/pca2 dla urządzeń 0/1 jak dotąd
+ */
+static PCA9685_Handle_t *legController(const LegMapping_t *mapping,
+                                       PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
+{
+    if (servoBusDeviceCount() > 0)
+        return servoBusDevice(mapping->device);
+    if (mapping->device == 0)
+        return pca1;
+    return (mapping->device == 1) ? pca2 : NULL;
+}
+
+bool legOutputSetJoints(int leg_number, float q1, float q2, float q3,
+                        PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool verbose)
+{
+    if (!legNumberValid(leg_number))
+    {
+        printf("❌ Nieprawidłowy numer nogi: %d\n", leg_number);
+        return false;
+    }
+
+    if (servoEstopActive())
+    {
+        return false; // Stop awaryjny - bez zapisów do servoEstopRelease()
+    }
+
+    const LegConfig_t *config = leg_config;
+    const LegMapping_t *mapping = &config->legs[leg_number - 1];
+    PCA9685_Handle_t *pca_to_use = legController(mapping, pca1, pca2);
+
+    if (pca_to_use == NULL)
+    {
+        printf("⚠️  PCA %d dla nogi %d niedostępne (kanały %d-%d)\n",
+               mapping->device, leg_number, mapping->base_channel, mapping->base_channel + 2);
+        return false;
+    }
+
+    TRACE_BEGIN(TRACE_EV_MAPPING, leg_number);
+
+    // Konwersja radianów na stopnie, 90° = neutralne
+    float ik_deg[3] = {q1 * 180.0f / M_PI, q2 * 180.0f / M_PI, q3 * 180.0f / M_PI};
+    float servo[3] = {
+        clampServo(90.0f + ik_deg[0] + mapping->hip_offset_deg),
+        clampServo(90.0f + ik_deg[1]),
+        clampServo(90.0f + ik_deg[2])};
+
+    // W ramce PWM od razu w obrazie kanałów kontrolera - bez kopii dalej
+    uint16_t local[3];
+    uint16_t *pwm = (frame != NULL) ? servoFrameChannels(frame, mapping->device, mapping->base_channel) : NULL;
+    bool in_place = (pwm != NULL);
+    if (!in_place)
+        pwm = local;
+
+    for (int joint = 0; joint < 3; joint++)
+    {
+        pwm[joint] = legConfigAngleToPwm(&config->servo[leg_number - 1][joint], servo[joint]);
+    }
+
+    if (verbose)
+    {
+        printf("Noga %d [kanały %d-%d]: IK[%.1f°, %.1f°, %.1f°] + offset[%.1f°] -> Servo[%.1f°, %.1f°, %.1f°]\n",
+               leg_number, mapping->base_channel, mapping->base_channel + 2,
+               ik_deg[0], ik_deg[1], ik_deg[2], mapping->hip_offset_deg,
+               servo[0], servo[1], servo[2]);
+    }
+
+    TRACE_END(TRACE_EV_MAPPING, leg_number);
+
+    LegMask_t bit = LEG_BIT(leg_number);
+    if (in_place && in_frame && leg_output_order == LEG_ORDER_SWING_FIRST && !(swing_mask & bit))
+    {
+        // Stance poczeka do końca ramki - magistrala najpierw dla swing
+        StagedLeg_t *st = &staged[leg_number - 1];
+        st->pca = pca_to_use;
+        st->device = mapping->device;
+        st->channel = mapping->base_channel;
+        st->on_bus = servoBusDevice(mapping->device) == pca_to_use;
+        st->pwm = pwm;
+        servoFrameMarkLeg(frame, leg_number, mapping->device, mapping->base_channel, st->on_bus);
+        staged_mask |= bit;
+        return true;
+    }
+
+    if (in_place)
+        servoFrameMarkLeg(frame, leg_number, mapping->device, mapping->base_channel, false);
+    return writeLeg(leg_number, pca_to_use, mapping->base_channel, pwm);
+}
+
+bool legOutputMoveFoot(int leg_number, float x, float y, float z,
+                       PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool verbose)
+{
+    if (!legNumberValid(leg_number))
+    {
+        printf("❌ Nieprawidłowy numer nogi: %d\n", leg_number);
+        return false;
+    }
+
+    bodyLevelingApply(&x, &y, &z);
+    flightRecFoot(leg_number, x, y, z);
+
+    float q1, q2, q3;
+    if (!computeLegIK(leg_number, x, y, z, &q1, &q2, &q3))
+    {
+        metricInc(m_ik_fail);
+        flightRecIkFail(leg_number);
+        return false;
+    }
+    return legOutputSetJoints(leg_number, q1, q2, q3, pca1, pca2, verbose);
+}
+
+bool legOutputMoveFeet(LegIKBatch_t *batch,
+                       PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, bool verbose)
+{
+    if (batch->count > HEX_LEG_COUNT)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < batch->count; i++)
+    {
+        bodyLevelingApply(&batch->x[i], &batch->y[i], &batch->z[i]);
+        flightRecFoot(batch->leg[i], batch->x[i], batch->y[i], batch->z[i]);
+    }
+
+    computeLegIKBatch(batch);
+
+    bool ok = true;
+    for (int i = 0; i < batch->count; i++)
+    {
+        if (!(batch->ok & ((LegMask_t)1U << i)))
+        {
+            metricInc(m_ik_fail);
+            flightRecIkFail(batch->leg[i]);
+            ok = false;
+            continue;
+        }
+        ok &= legOutputSetJoints(batch->leg[i], batch->q1[i], batch->q2[i], batch->q3[i],
+                                 pca1, pca2, verbose);
+    }
+    return ok;
+}
+
+void legOutputFrameBegin(void)
+{
+    frame_begin = dwtCycles();
+    in_frame = true;
+
+    // Poprzednia ramka niezamknięta (chód przerwany) - opublikuj ją teraz
+    if (frame != NULL)
+        servoFramePublish(frame);
+    frame = servoFrameAcquire();
+    swing_mask = 0;
+    staged_mask = 0;
+    written_mask = 0;
+}
+
+void legOutputMarkSwing(int leg_number)
+{
+    if (legNumberValid(leg_number))
+        swing_mask |= LEG_BIT(leg_number);
+}
+
+static void addLatency(LegLatency_t *l, uint32_t us)
+{
+    l->count++;
+    l->sum_us += us;
+    if (us > l->max_us)
+        l->max_us = us;
+}
+
+void legOutputFlush(void)
+{
+    if (!in_frame)
+    {
+        return;
+    }
+
+    // Stance: wszystkie magistrale naraz, czas = najwolniejsza magistrala
+    LegMask_t bus_mask = 0;
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        const StagedLeg_t *st = &staged[leg - 1];
+        LegMask_t bit = LEG_BIT(leg);
+        if (!(staged_mask & bit))
+            continue;
+        if (st->on_bus)
+            bus_mask |= bit;
+        else
+            writeLeg(leg, st->pca, st->channel, st->pwm);
+    }
+
+    if (bus_mask != 0 && !servoEstopActive())
+    {
+        servoBusFlushFrame(frame); // Kanały pending czytane z ramki w miejscu
+        if (servoEstopActive())
+            servoEstopTrigger(); // Jak w writeLeg() - stop w trakcie flush
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+        {
+            const StagedLeg_t *st = &staged[leg - 1];
+            if (!(bus_mask & LEG_BIT(leg)))
+                continue;
+            uint32_t done;
+            bool ok = servoBusDeviceResult(st->device, &done);
+            recordWrite(leg, st->pwm, ok, done);
+        }
+    }
+    staged_mask = 0;
+    in_frame = false;
+
+    // Ramka tylko do odczytu - rejestrator i telemetria biorą dzierżawy
+    if (frame != NULL)
+    {
+        servoFramePublish(frame);
+        frame = NULL;
+    }
+
+    LegOutputTiming_t *t = &timing[leg_output_order];
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        LegMask_t bit = LEG_BIT(leg);
+        bool swing = swing_mask & bit;
+        bool was_swing = prev_swing_mask & bit;
+
+        if (was_swing && !swing)
+            addLatency(&t->touchdown, last_swing_us[leg - 1]);
+        if (!(written_mask & bit))
+            continue;
+
+        if (swing)
+        {
+            addLatency(&t->swing, write_us[leg - 1]);
+            if (!was_swing)
+                addLatency(&t->lift_off, write_us[leg - 1]);
+            last_swing_us[leg - 1] = write_us[leg - 1];
+        }
+        else
+        {
+            addLatency(&t->stance, write_us[leg - 1]);
+        }
+    }
+    prev_swing_mask = swing_mask;
+}
+
+void legOutputGetTiming(LegOutputOrder_t order, LegOutputTiming_t *out)
+{
+    *out = timing[order];
+}
+
+void legOutputResetTiming(void)
+{
+    memset(timing, 0, sizeof(timing));
+    prev_swing_mask = 0;
+}
+
+static void printLatency(const char *name, const LegLatency_t *a, const LegLatency_t *b)
+{
+    printf("%-14s", name);
+    const LegLatency_t *cols[2] = {a, b};
+    for (int i = 0; i < 2; i++)
+    {
+        if (cols[i]->count > 0)
+            printf("  %6lu / %6lu", cols[i]->sum_us / cols[i]->count, cols[i]->max_us);
+        else
+            printf("  %15s", "-");
+    }
+    printf("\n");
+}
+
+void legOutputReport(void)
+{
+    const LegOutputTiming_t *c = &timing[LEG_ORDER_CALL];
+    const LegOutputTiming_t *s = &timing[LEG_ORDER_SWING_FIRST];
+
+    printf("\n=== KOLEJNOŚĆ ZAPISÓW NÓG (aktywna: %s) ===\n",
+           leg_output_order == LEG_ORDER_SWING_FIRST ? "swing najpierw" : "jak chód");
+    printf("Koniec zapisu od początku ramki [us], śr / max\n");
+    printf("%-14s  %15s  %15s\n", "", "jak chód", "swing najpierw");
+    printLatency("oderwanie", &c->lift_off, &s->lift_off);
+    printLatency("przyziemienie", &c->touchdown, &s->touchdown);
+    printLatency("swing", &c->swing, &s->swing);
+    printLatency("stance", &c->stance, &s->stance);
+}
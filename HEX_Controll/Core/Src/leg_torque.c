@@ -0,0 +1,147 @@
+/*
+ * leg_torque.c - Rozkład ciężaru na stopy podporowe i momenty τ = Jᵀ·F
+ */
+
+#include "leg_torque.h"
+#include "hexapod_kinematics.h"
+#include <stdio.h>
+#include <math.h>
+
+#define GRAVITY 9.81f
+#define CM_TO_M 0.01f
+
+LegTorqueConfig_t leg_torque_config = {
+    .body_mass_kg = 2.0f,     // 18x MG996R (~1 kg) + rama + akumulator
+    .stall_torque_nm = 0.96f, // MG996R przy 5 V (pca9685.h: V+ = 5 V)
+    .budget_fraction = 0.9f,  // Stance trwa ułamek cyklu - krótko blisko utyku
+    .dynamic_factor = 1.3f,   // Przenoszenie ciężaru przy zmianie grup
+    .samples = 5,
+    .policy = LEG_TORQUE_FLAG}; // Krok bez zmian - LEG_TORQUE_SCALE włącza się świadomie
+
+bool legTorqueSupportLoads(const float feet[][3], int n, float loads_n[])
+{
+    const LegTorqueConfig_t *cfg = &leg_torque_config;
+    float weight = cfg->body_mass_kg * GRAVITY * cfg->dynamic_factor;
+
+    if (n <= 0)
+    {
+        return false;
+    }
+
+    if (n != 3)
+    {
+        for (int i = 0; i < n; i++)
+            loads_n[i] = weight / (float)n;
+        return true;
+    }
+
+    // Reguła Cramera dla układu z nagłówka
+    float c0 = feet[1][0] * feet[2][1] - feet[2][0] * feet[1][1];
+    float c1 = feet[2][0] * feet[0][1] - feet[0][0] * feet[2][1];
+    float c2 = feet[0][0] * feet[1][1] - feet[1][0] * feet[0][1];
+    float det = c0 + c1 + c2;
+
+    if (fabsf(det) < 1e-3f)
+    {
+        return false;
+    }
+
+    loads_n[0] = weight * c0 / det;
+    loads_n[1] = weight * c1 / det;
+    loads_n[2] = weight * c2 / det;
+
+    return loads_n[0] >= 0.0f && loads_n[1] >= 0.0f && loads_n[2] >= 0.0f;
+}
+
+bool legTorqueJoint(int leg_number, const float foot[3], float load_n, float tau_nm[3])
+{
+    float q1, q2, q3;
+    float J[3][3];
+
+    if (!computeLegIK(leg_number, foot[0], foot[1], foot[2], &q1, &q2, &q3) ||
+        !computeLegJacobian(leg_number, q1, q2, q3, J))
+    {
+        return false;
+    }
+
+    // τ = Jᵀ·F, F = (0, 0, load) - tylko wiersz z jakobianu
+    for (int j = 0; j < 3; j++)
+    {
+        tau_nm[j] = J[2][j] * CM_TO_M * load_n;
+    }
+    return true;
+}
+
+void legTorqueReportInit(LegTorqueReport_t *report)
+{
+    for (int j = 0; j < 3; j++)
+    {
+        report->peak_nm[j] = 0.0f;
+        report->peak_leg[j] = 0;
+    }
+    report->max_load_n = 0.0f;
+    report->budget_nm = leg_torque_config.stall_torque_nm * leg_torque_config.budget_fraction;
+    report->utilization = 0.0f;
+    report->supported = true;
+    report->reachable = true;
+}
+
+void legTorqueAccumulate(LegTorqueReport_t *report, const int legs[], const float feet[][3], int n)
+{
+    float loads[HEX_LEG_COUNT];
+
+    if (n > HEX_LEG_COUNT)
+        n = HEX_LEG_COUNT;
+    if (!legTorqueSupportLoads(feet, n, loads))
+    {
+        report->supported = false;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        // Ujemna siła to brak podparcia - moment liczony dla wartości bezwzględnej
+        float load = fabsf(loads[i]);
+        float tau[3];
+
+        if (load > report->max_load_n)
+            report->max_load_n = load;
+
+        if (!legTorqueJoint(legs[i], feet[i], load, tau))
+        {
+            report->reachable = false;
+            continue;
+        }
+
+        for (int j = 0; j < 3; j++)
+        {
+            if (fabsf(tau[j]) > report->peak_nm[j])
+            {
+                report->peak_nm[j] = fabsf(tau[j]);
+                report->peak_leg[j] = (uint8_t)legs[i];
+            }
+        }
+    }
+
+    float peak = fmaxf(report->peak_nm[0], fmaxf(report->peak_nm[1], report->peak_nm[2]));
+    report->utilization = (report->budget_nm > 0.0f) ? peak / report->budget_nm : INFINITY;
+}
+
+bool legTorqueWithinBudget(const LegTorqueReport_t *report)
+{
+    return report->supported && report->reachable && report->utilization <= 1.0f;
+}
+
+void legTorquePrint(const LegTorqueReport_t *report)
+{
+    static const char *const joint_names[3] = {"biodro", "kolano", "kostka"};
+
+    printf("Momenty stance (budżet %.2f N·m, max obciążenie stopy %.1f N):\n",
+           report->budget_nm, report->max_load_n);
+    for (int j = 0; j < 3; j++)
+    {
+        printf("  %-7s %.3f N·m (noga %d)\n", joint_names[j], report->peak_nm[j], report->peak_leg[j]);
+    }
+    printf("  wykorzystanie %.0f%%%s%s\n", report->utilization * 100.0f,
+           report->supported ? "" : ", ŚRODEK MASY POZA PODPARCIEM",
+           report->reachable ? "" : ", POZA ZASIĘGIEM IK");
+}
@@ -84,6 +84,22 @@
 #include "tripod_gait.h"
 #include "bipedal_gait.h"
 #include "wave_gait.h"
+#include "trace.h"
+#include "perf_bench.h"
+#include "cadence_tune.h"
+#include "servo_calib.h"
+#include "hot_path.h"
+#include "mem_monitor.h"
+#include "config_store.h"
+#include "config_params.h"
+#include "control_frame.h"
+#include "foot_contact.h"
+#include "metrics.h"
+#include "serial_cmd.h"
+#include "leg_output.h"
+#include "servo_bus.h"
+#include "servo_estop.h"
+#include "flight_rec.h"
 
 #include <stdio.h>
 
@@ -96,7 +112,9 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#ifndef HEX_WALK_ALL_GAITS
+#define HEX_WALK_ALL_GAITS 0 // 1 = bipedal i wave po tripodzie w każdym obiegu pętli (Renode, WALKS=3)
+#endif
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -129,11 +147,32 @@ void SystemClock_Config(void);
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+/**
+ * @brief Ustaw jeden staw wszystkich nóg na kąt
+ *
+ * Kontroler i kanał z leg_config (ROBOT_LEG_TABLE) - pca1/pca2 tylko
+ * gdy servo_bus nie ma jeszcze urządzeń.
+ *
+ * @param joint 0 = biodro, 1 = kolano, 2 = kostka
+ */
+static void setJointAllLegs(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, int joint, float angle)
+{
+  for (int leg = 0; leg < HEX_LEG_COUNT; leg++)
+  {
+    const LegMapping_t *m = &leg_config->legs[leg];
+    PCA9685_Handle_t *pca = servoBusDevice(m->device);
+    if (pca == NULL)
+      pca = (m->device == 0) ? pca1 : (m->device == 1) ? pca2 : NULL;
+    if (pca != NULL)
+      PCA9685_SetServoAngle(pca, m->base_channel + joint, angle);
+  }
+}
+
 /**
  * @brief Ustaw wszystkie serwa na pozycję neutralną (90°)
  *
  * @details
- * Funkcja testowa ustawiająca wszystkie 18 serw na kąt 90° (pozycja neutralna).
+ * Funkcja testowa ustawiająca wszystkie serwa (3 na nogę) na kąt 90° (pozycja neutralna).
  * Przydatna do:
  * - Weryfikacji komunikacji z kontrolerami PCA9685
  * - Sprawdzenia mechanicznego zakresu ruchu serw
@@ -153,30 +192,15 @@ void SystemClock_Config(void);
 void setAllto90(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
 {
   // Test wszystkich bioder na 90° (środek przedziału)
-  PCA9685_SetServoAngle(pca1, 0, 90.0f); // Noga 1 HIP
-  PCA9685_SetServoAngle(pca2, 0, 90.0f); // Noga 2 HIP
-  PCA9685_SetServoAngle(pca1, 3, 90.0f); // Noga 3 HIP
-  PCA9685_SetServoAngle(pca2, 3, 90.0f); // Noga 4 HIP
-  PCA9685_SetServoAngle(pca1, 6, 90.0f); // Noga 5 HIP
-  PCA9685_SetServoAngle(pca2, 6, 90.0f); // Noga 6 HIP
+  setJointAllLegs(pca1, pca2, 0, 90.0f);
 
   HAL_Delay(1000); // Czekaj 1 sekundę, aby zobaczyć pozycje
 
-  PCA9685_SetServoAngle(pca1, 1, 90.0f); // Noga 1 KNEE
-  PCA9685_SetServoAngle(pca2, 1, 90.0f); // Noga 2 KNEE
-  PCA9685_SetServoAngle(pca1, 4, 90.0f); // Noga 3 KNEE
-  PCA9685_SetServoAngle(pca2, 4, 90.0f); // Noga 4 KNEE
-  PCA9685_SetServoAngle(pca1, 7, 90.0f); // Noga 5 KNEE
-  PCA9685_SetServoAngle(pca2, 7, 90.0f); // Noga 6 KNEE
+  setJointAllLegs(pca1, pca2, 1, 90.0f); // Kolana
 
   HAL_Delay(1000); // Czekaj 1 sekundę, aby zobaczyć pozycje
 
-  PCA9685_SetServoAngle(pca1, 2, 90.0f); // Noga 1 ANKLE
-  PCA9685_SetServoAngle(pca2, 2, 90.0f); // Noga 2 ANKLE
-  PCA9685_SetServoAngle(pca1, 5, 90.0f); // Noga 3 ANKLE
-  PCA9685_SetServoAngle(pca2, 5, 90.0f); // Noga 4 ANKLE
-  PCA9685_SetServoAngle(pca1, 8, 90.0f); // Noga 5 ANKLE
-  PCA9685_SetServoAngle(pca2, 8, 90.0f); // Noga 6 ANKLE
+  setJointAllLegs(pca1, pca2, 2, 90.0f); // Kostki
 }
 
 /**
@@ -194,36 +218,21 @@ void setAllto90(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
  * @param pca1 Wskaźnik na kontroler lewych nóg (I2C1)
  * @param pca2 Wskaźnik na kontroler prawych nóg (I2C2)
  *
- * @see base_positions w poszczególnych plikach gait - dokładne pozycje IK
+ * @see ROBOT_LEG_TABLE w robot_description.h - dokładne pozycje IK
  * @note Funkcja testowa - w normalnej pracy używa się kinematyki odwrotnej
  */
 void testStanding(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
 {
   // Test pozycji stojącej
-  PCA9685_SetServoAngle(pca1, 0, 90.0f); // Noga 1 HIP
-  PCA9685_SetServoAngle(pca2, 0, 90.0f); // Noga 2 HIP
-  PCA9685_SetServoAngle(pca1, 3, 90.0f); // Noga 3 HIP
-  PCA9685_SetServoAngle(pca2, 3, 90.0f); // Noga 4 HIP
-  PCA9685_SetServoAngle(pca1, 6, 90.0f); // Noga 5 HIP
-  PCA9685_SetServoAngle(pca2, 6, 90.0f); // Noga 6 HIP
+  setJointAllLegs(pca1, pca2, 0, 90.0f); // Biodra
 
   HAL_Delay(1000); // Czekaj 1 sekundę, aby zobaczyć pozycje
 
-  PCA9685_SetServoAngle(pca1, 1, 60.0f); // Noga 1 KNEE
-  PCA9685_SetServoAngle(pca2, 1, 60.0f); // Noga 2 KNEE
-  PCA9685_SetServoAngle(pca1, 4, 60.0f); // Noga 3 KNEE
-  PCA9685_SetServoAngle(pca2, 4, 60.0f); // Noga 4 KNEE
-  PCA9685_SetServoAngle(pca1, 7, 60.0f); // Noga 5 KNEE
-  PCA9685_SetServoAngle(pca2, 7, 60.0f); // Noga 6 KNEE
+  setJointAllLegs(pca1, pca2, 1, 60.0f); // Kolana
 
   HAL_Delay(1000); // Czekaj 1 sekundę, aby zobaczyć pozycje
 
-  PCA9685_SetServoAngle(pca1, 2, 5.0f); // Noga 1 ANKLE
-  PCA9685_SetServoAngle(pca2, 2, 5.0f); // Noga 2 ANKLE
-  PCA9685_SetServoAngle(pca1, 5, 5.0f); // Noga 3 ANKLE
-  PCA9685_SetServoAngle(pca2, 5, 5.0f); // Noga 4 ANKLE
-  PCA9685_SetServoAngle(pca1, 8, 5.0f); // Noga 5 ANKLE
-  PCA9685_SetServoAngle(pca2, 8, 5.0f); // Noga 6 ANKLE
+  setJointAllLegs(pca1, pca2, 2, 5.0f); // Kostki
 }
 
 /* USER CODE END 0 */
@@ -236,6 +245,7 @@ int main(void)
 {
 
   /* USER CODE BEGIN 1 */
+  memMonitorPaintStack(); // Przed HAL_Init - pomiar high-water stosu
 
   /* USER CODE END 1 */
 
@@ -261,6 +271,17 @@ int main(void)
   MX_I2C2_Init();
   MX_USART2_UART_Init();
   /* USER CODE BEGIN 2 */
+  hotPathReport(); // Konfiguracja ART i kod w SRAM
+  serialCmdInit(&huart2); // Komendy UART: help, metrics, frame, feet, mem
+  legOutputInit();        // Metryki ik_fail / servo_bus_err
+  flightRecInit();        // Zrzut ramek sprzed ewentualnego HardFault
+
+  // Parametry z flash (sektory 6/7) - przed pierwszym użyciem IK i chodów
+  if (!configStoreInit())
+  {
+    printf("⚠️  Błąd inicjalizacji magazynu konfiguracji\n");
+  }
+  configParamsLoad();
 
   /**
    * @brief Inicjalizacja kontrolera PCA9685 #1 (lewe nogi)
@@ -296,6 +317,40 @@ int main(void)
     }
   }
 
+  // Indeksy urządzeń servo_bus = LegMapping_t::device (leg_config.c): 0 = I2C1, 1 = I2C2.
+  // Kolejne kontrolery (inne adresy lub I2C3) dopisuje się tutaj i w leg_config.
+  servoBusAddDevice(&pca1);
+  servoBusAddDevice(&pca2);
+  servoEstopInit(&pca1, &pca2); // B1 (PC13) = stop awaryjny: ALL_LED_OFF na każdym PCA
+
+#if HEX_PERF_BENCHMARK
+  perfBenchmarkRun(&pca1, &pca2, NULL); // Czas ramki chodu dla tego buildu
+#endif
+
+  // Opcjonalny MPU-6050 na I2C1 - bez czujnika chód bez poziomowania
+  if (controlFrameInit(&hi2c1, IMU_SOURCE_MPU6050) == IMU_SOURCE_NONE)
+  {
+    printf("ℹ️  Brak MPU-6050 (I2C1, 0x68) - poziomowanie korpusu wyłączone\n");
+  }
+
+  // Krańcówki stóp PC0..PC5 - bez nich swing kończy się na base_z jak dotąd
+  footContactGpioInit();
+
+#if HEX_SERVO_CALIB
+  // Limity PWM wszystkich serw w jednym przebiegu - operator potwierdza 'calib mark' na UART
+  servoCalibRun(true, NULL);
+#endif
+
+#if HEX_CADENCE_TUNE
+  // Najszybsza kadencja tripodu bez przekroczeń terminu ramki
+  testStanding(&pca1, &pca2);
+  HAL_Delay(1000);
+  footContactReset();
+  cadenceTuneRun(&pca1, &pca2, HEX_CADENCE_TUNE_SAVE, NULL);
+#endif
+
+  memMonitorReport(); // Stos/sterta po inicjalizacji
+
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -306,15 +361,37 @@ int main(void)
     // testBasicPositions(&pca1, &pca2);
 
     setAllto90(&pca1, &pca2);   // Ustaw wszystkie serwa na 90°
-    HAL_Delay(1000);            // Czekaj 1 sekundę, aby zobaczyć pozycje
+    serialCmdWait(1000);        // Czekaj 1 sekundę, aby zobaczyć pozycje
     testStanding(&pca1, &pca2); // Test pozycji stojącej
-    HAL_Delay(15000);           // Czekaj 1 sekundę, aby zobaczyć pozycje
-
-    tripodGaitWalk(&pca1, &pca2, TRIPOD_FORWARD, 5);
+    serialCmdWait(15000);       // Czekaj 15 s (komendy UART obsługiwane w trakcie)
+
+#if HEX_TRACE_ENABLE
+    traceStart(false); // Bufor liniowy - zapis pierwszych zdarzeń chodu
+#endif
+    controlFrameResetStats();
+    footContactReset(); // Start z pozycji stojącej - wysokość podłoża nieznana
+    if (!tripodGaitWalk(&pca1, &pca2, TRIPOD_FORWARD, 5))
+    {
+      flightRecDump(); // Ramki prowadzące do błędu
+    }
+#if HEX_TRACE_ENABLE
+    traceStop();
+    traceDump(); // Zrzut przez UART -> Tools/trace2chrome.py
+#endif
+    controlFrameReport(); // Czas ramek, częstotliwość i opóźnienie poziomowania
+    legOutputReport();    // Czas zapisów swing/stance od początku ramki
+    servoBusReport();     // Czas flush stance: najwolniejsza magistrala vs suma
+    footContactReport();  // Przyziemienia i wysokość podłoża pod nogami
+    memMonitorCheck();    // Ostrzeżenie przy spadku zapasu stosu/sterty
+#if HEX_WALK_ALL_GAITS
+    bipedalGaitWalk(&pca1, &pca2, BIPEDAL_FORWARD, 3);
+    waveGaitWalk(&pca1, &pca2, WAVE_FORWARD, 3);
+#else
     // bipedalGaitWalk(&pca1, &pca2, BIPEDAL_FORWARD, 3);
     // waveGaitWalk(&pca1, &pca2, WAVE_FORWARD, 3);
+#endif
 
-    HAL_Delay(15000); // Czekaj 1 sekundę, aby zobaczyć pozycje
+    serialCmdWait(15000); // Czekaj 15 s (komendy UART obsługiwane w trakcie)
 
     /* USER CODE END WHILE */
 
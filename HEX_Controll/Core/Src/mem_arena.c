@@ -0,0 +1,147 @@
+/*
+ * mem_arena.c - Areny i pule w .bss, arena stanu aktywnego chodu
+ */
+
+#include "mem_arena.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t gait_scratch_storage[MEM_ARENA_ROUND(MEM_SCRATCH_SIZE)] __attribute__((aligned(MEM_ARENA_ALIGN)));
+
+MemArena_t gait_scratch = {
+    .name = "gait_scratch",
+    .base = gait_scratch_storage,
+    .size = sizeof(gait_scratch_storage)};
+
+// Rejestr do raportu - wpis przy pierwszej alokacji
+static MemArena_t *arenas[MEM_ARENA_REGISTRY_MAX];
+static uint8_t arena_count;
+static MemPool_t *pools[MEM_ARENA_REGISTRY_MAX];
+static uint8_t pool_count;
+
+void *memArenaAlloc(MemArena_t *arena, size_t size)
+{
+    if (!arena->registered && arena_count < MEM_ARENA_REGISTRY_MAX)
+    {
+        arenas[arena_count++] = arena;
+        arena->registered = true;
+    }
+
+    uint32_t need = MEM_ARENA_ROUND((uint32_t)size);
+    if (size == 0 || size > arena->size || need > arena->size - arena->used)
+    {
+        arena->fails++;
+        return NULL;
+    }
+
+    void *block = arena->base + arena->used;
+    arena->used += need;
+    arena->allocs++;
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+    return block;
+}
+
+void memArenaReset(MemArena_t *arena)
+{
+    arena->used = 0;
+    arena->owner = NULL;
+    arena->resets++;
+}
+
+static void poolBuild(MemPool_t *pool)
+{
+    // Każdy wolny blok trzyma w pierwszym słowie adres następnego
+    pool->free_list = NULL;
+    for (int i = pool->blocks - 1; i >= 0; i--)
+    {
+        void **block = (void **)(pool->base + (uint32_t)i * pool->block_size);
+        *block = pool->free_list;
+        pool->free_list = block;
+    }
+    pool->used = 0;
+    pool->ready = true;
+
+    if (pool_count < MEM_ARENA_REGISTRY_MAX)
+        pools[pool_count++] = pool;
+}
+
+void *memPoolAlloc(MemPool_t *pool)
+{
+    if (!pool->ready)
+        poolBuild(pool);
+
+    void **block = (void **)pool->free_list;
+    if (block == NULL)
+    {
+        pool->fails++;
+        return NULL;
+    }
+
+    pool->free_list = *block;
+    pool->used++;
+    if (pool->used > pool->peak)
+        pool->peak = pool->used;
+    return block;
+}
+
+bool memPoolFree(MemPool_t *pool, void *block)
+{
+    uint8_t *p = (uint8_t *)block;
+    uint32_t span = (uint32_t)pool->blocks * pool->block_size;
+
+    // Tylko blok tej puli, na granicy bloku i aktualnie wydany
+    if (!pool->ready || p < pool->base || p >= pool->base + span ||
+        (uint32_t)(p - pool->base) % pool->block_size != 0 || pool->used == 0)
+    {
+        return false;
+    }
+
+    *(void **)block = pool->free_list;
+    pool->free_list = block;
+    pool->used--;
+    return true;
+}
+
+void *memScratchGet(const void *owner, size_t size, bool *fresh)
+{
+    static void *block;
+
+    bool is_new = (gait_scratch.owner != owner || block == NULL);
+    if (is_new)
+    {
+        // Zmiana chodu - stan poprzedniego zwolniony w całości
+        memArenaReset(&gait_scratch);
+        block = memArenaAlloc(&gait_scratch, size);
+        if (block == NULL)
+        {
+            printf("❌ gait_scratch: stan %u B > %lu B\n", (unsigned)size, gait_scratch.size);
+            return NULL;
+        }
+        memset(block, 0, size);
+        gait_scratch.owner = owner;
+    }
+
+    if (fresh != NULL)
+        *fresh = is_new;
+    return block;
+}
+
+void memArenaReport(void)
+{
+    printf("\n=== ARENY I PULE ===\n");
+    for (uint8_t i = 0; i < arena_count; i++)
+    {
+        const MemArena_t *a = arenas[i];
+        printf("Arena %-14s teraz %5lu B, szczyt %5lu / %5lu B, alokacje %lu, odmowy %lu, resety %lu\n",
+               a->name, a->used, a->peak, a->size, a->allocs, a->fails, a->resets);
+    }
+    for (uint8_t i = 0; i < pool_count; i++)
+    {
+        const MemPool_t *p = pools[i];
+        printf("Pula  %-14s bloki %u/%u (szczyt %u) po %lu B, odmowy %lu\n",
+               p->name, p->used, p->blocks, p->peak, p->block_size, p->fails);
+    }
+    if (arena_count == 0 && pool_count == 0)
+        printf("(brak alokacji)\n");
+}
@@ -0,0 +1,124 @@
+/*
+ * mem_monitor.c - Pomiar zużycia stosu i sterty
+ *
+ * Malowanie wolnego RAM przy starcie + skan high-water,
+ * stertę śledzi _sbrk() w sysmem.c.
+ */
+
+#include "mem_monitor.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+
+// Symbole z STM32F446XX_FLASH.ld
+extern uint8_t _end;
+extern uint8_t _estack;
+extern uint32_t _Min_Stack_Size;
+extern uint32_t _Min_Heap_Size;
+
+// sysmem.c
+uint8_t *_sbrk_heap_end(void);
+uint8_t *_sbrk_heap_peak(void);
+
+#define PAINT_GUARD 64 // Bajty poniżej SP zostawione dla ramki memMonitorPaintStack()
+
+static uint32_t *paint_bottom = NULL; // Najniższe pomalowane słowo
+static uint32_t *paint_top = NULL;    // Pierwsze słowo powyżej obszaru malowania
+static uint32_t *stack_low = NULL;    // Najgłębszy znaleziony punkt stosu (maleje)
+static int32_t warned_min = INT32_MAX;
+
+static uint32_t *alignUp(const uint8_t *addr)
+{
+    return (uint32_t *)(((uintptr_t)addr + 3U) & ~(uintptr_t)3U);
+}
+
+void memMonitorPaintStack(void)
+{
+    uint32_t *p = alignUp(_sbrk_heap_end());
+    uint32_t *top = (uint32_t *)(uintptr_t)((__get_MSP() - PAINT_GUARD) & ~3U);
+
+    paint_bottom = p;
+    paint_top = top;
+    stack_low = top;
+
+    while (p < top)
+    {
+        *p++ = MEM_PAINT_PATTERN;
+    }
+}
+
+void memMonitorSample(MemStats_t *stats)
+{
+    uint8_t *heap_peak = _sbrk_heap_peak();
+    uint32_t *deepest;
+
+    if (paint_bottom == NULL)
+    {
+        // Brak malowania - znamy tylko bieżący SP
+        deepest = (uint32_t *)(uintptr_t)__get_MSP();
+    }
+    else
+    {
+        // Szukaj od dołu, powyżej sterty, do ostatnio znalezionego minimum
+        uint32_t *p = alignUp(heap_peak);
+        if (p < paint_bottom)
+            p = paint_bottom;
+        while (p < stack_low && *p == MEM_PAINT_PATTERN)
+        {
+            p++;
+        }
+        if (p < stack_low)
+            stack_low = p;
+        deepest = stack_low;
+    }
+
+    stats->stack_reserved = (uint32_t)(uintptr_t)&_Min_Stack_Size;
+    stats->stack_peak = (uint32_t)((uintptr_t)&_estack - (uintptr_t)deepest);
+    stats->stack_margin = (int32_t)stats->stack_reserved - (int32_t)stats->stack_peak;
+
+    stats->heap_reserved = (uint32_t)(uintptr_t)&_Min_Heap_Size;
+    stats->heap_used = (uint32_t)(_sbrk_heap_end() - &_end);
+    stats->heap_peak = (uint32_t)(heap_peak - &_end);
+    stats->heap_margin = (int32_t)stats->heap_reserved - (int32_t)stats->heap_peak;
+
+    stats->gap = ((uint8_t *)deepest > heap_peak) ? (uint32_t)((uint8_t *)deepest - heap_peak) : 0;
+}
+
+bool memMonitorCheck(void)
+{
+    MemStats_t s;
+    memMonitorSample(&s);
+
+    int32_t worst = s.stack_margin;
+    if (s.heap_margin < worst)
+        worst = s.heap_margin;
+    if ((int32_t)s.gap < worst)
+        worst = (int32_t)s.gap;
+
+    if (worst >= MEM_MONITOR_WARN_BYTES)
+    {
+        return true;
+    }
+
+    if (worst < warned_min)
+    {
+        warned_min = worst;
+        printf("⚠️  PAMIĘĆ: stos %lu/%lu B (zapas %ld), sterta %lu/%lu B (zapas %ld), luka %lu B\n",
+               s.stack_peak, s.stack_reserved, (long)s.stack_margin,
+               s.heap_peak, s.heap_reserved, (long)s.heap_margin, s.gap);
+    }
+    return false;
+}
+
+void memMonitorReport(void)
+{
+    MemStats_t s;
+    memMonitorSample(&s);
+
+    printf("\n=== PAMIĘĆ ===\n");
+    printf("Stos:   szczyt %lu B / rezerwa %lu B (zapas %ld B)%s\n",
+           s.stack_peak, s.stack_reserved, (long)s.stack_margin,
+           (paint_bottom == NULL) ? " [bez malowania]" : "");
+    printf("Sterta: teraz %lu B, szczyt %lu B / rezerwa %lu B (zapas %ld B)\n",
+           s.heap_used, s.heap_peak, s.heap_reserved, (long)s.heap_margin);
+    printf("Luka sterta-stos: %lu B\n", s.gap);
+}
@@ -0,0 +1,129 @@
+/*
+ * metrics.c - Statyczny rejestr liczników, wskaźników i histogramów
+ */
+
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+static Metric_t registry[METRICS_MAX];
+static uint8_t registry_count = 0;
+
+static Metric_t *registerMetric(const char *name, const char *unit, MetricType_t type)
+{
+    Metric_t *existing = metricsFind(name);
+    if (existing != NULL)
+    {
+        return (existing->type == type) ? existing : NULL;
+    }
+
+    if (registry_count >= METRICS_MAX)
+    {
+        printf("⚠️  Rejestr metryk pełny - '%s' pominięta\n", name);
+        return NULL;
+    }
+
+    Metric_t *m = &registry[registry_count++];
+    memset(m, 0, sizeof(*m));
+    m->name = name;
+    m->unit = unit;
+    m->type = type;
+    return m;
+}
+
+Metric_t *metricsRegisterCounter(const char *name, const char *unit)
+{
+    return registerMetric(name, unit, METRIC_COUNTER);
+}
+
+Metric_t *metricsRegisterGauge(const char *name, const char *unit)
+{
+    return registerMetric(name, unit, METRIC_GAUGE);
+}
+
+Metric_t *metricsRegisterHistogram(const char *name, const char *unit,
+                                   const uint32_t *bounds, uint8_t n_bounds)
+{
+    if (bounds == NULL || n_bounds == 0 || n_bounds >= METRIC_HIST_BUCKETS)
+    {
+        return NULL;
+    }
+
+    Metric_t *m = registerMetric(name, unit, METRIC_HISTOGRAM);
+    if (m != NULL)
+    {
+        m->bounds = bounds;
+        m->n_bounds = n_bounds;
+    }
+    return m;
+}
+
+Metric_t *metricsFind(const char *name)
+{
+    for (uint8_t i = 0; i < registry_count; i++)
+    {
+        if (strcmp(registry[i].name, name) == 0)
+            return &registry[i];
+    }
+    return NULL;
+}
+
+void metricObserve(Metric_t *metric, uint32_t value)
+{
+    if (metric == NULL)
+    {
+        return;
+    }
+
+    uint8_t b = 0;
+    while (b < metric->n_bounds && value > metric->bounds[b])
+    {
+        b++;
+    }
+    metric->buckets[b]++;
+    metric->count++;
+    metric->sum += value;
+    if (value > metric->max)
+        metric->max = value;
+}
+
+void metricsReset(void)
+{
+    for (uint8_t i = 0; i < registry_count; i++)
+    {
+        Metric_t *m = &registry[i];
+        m->count = m->sum = m->max = 0;
+        m->gauge = 0.0f;
+        memset(m->buckets, 0, sizeof(m->buckets));
+    }
+}
+
+void metricsDump(void)
+{
+    printf("\n=== METRYKI (%u/%u) ===\n", registry_count, METRICS_MAX);
+
+    for (uint8_t i = 0; i < registry_count; i++)
+    {
+        const Metric_t *m = &registry[i];
+        const char *unit = (m->unit != NULL) ? m->unit : "";
+
+        switch (m->type)
+        {
+        case METRIC_COUNTER:
+            printf("%-20s %lu %s\n", m->name, m->count, unit);
+            break;
+        case METRIC_GAUGE:
+            printf("%-20s %.2f %s\n", m->name, m->gauge, unit);
+            break;
+        case METRIC_HISTOGRAM:
+            printf("%-20s n=%lu śr=%lu max=%lu %s |", m->name, m->count,
+                   (m->count > 0) ? m->sum / m->count : 0, m->max, unit);
+            for (uint8_t b = 0; b < m->n_bounds; b++)
+            {
+                printf(" <=%lu:%lu", m->bounds[b], m->buckets[b]);
+            }
+            printf(" >%lu:%lu\n", m->bounds[m->n_bounds - 1], m->buckets[m->n_bounds]);
+            break;
+        }
+    }
+}
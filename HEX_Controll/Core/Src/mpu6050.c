@@ -0,0 +1,83 @@
+/*
+ * mpu6050.c - MPU-6050 IMU driver for STM32 HAL
+ *
+ * Minimal setup for body levelling: wake up, ranges, DLPF, burst read.
+ */
+
+#include "mpu6050.h"
+#include "trace.h"
+
+#define MPU6050_TIMEOUT_MS 5
+
+static bool writeReg(MPU6050_Handle_t *handle, uint8_t reg, uint8_t value)
+{
+	return HAL_I2C_Mem_Write(handle->hi2c, handle->address << 1, reg, I2C_MEMADD_SIZE_8BIT,
+							 &value, 1, MPU6050_TIMEOUT_MS) == HAL_OK;
+}
+
+bool MPU6050_Init(MPU6050_Handle_t *handle, I2C_HandleTypeDef *hi2c, uint8_t address)
+{
+	if (handle == NULL || hi2c == NULL)
+	{
+		return false;
+	}
+
+	handle->hi2c = hi2c;
+	handle->address = address;
+	handle->ready = false;
+
+	// Identify the chip before touching any register
+	uint8_t who_am_i = 0;
+	if (HAL_I2C_Mem_Read(hi2c, address << 1, MPU6050_WHO_AM_I, I2C_MEMADD_SIZE_8BIT,
+						 &who_am_i, 1, MPU6050_TIMEOUT_MS) != HAL_OK ||
+		who_am_i != MPU6050_WHO_AM_I_VALUE)
+	{
+		return false;
+	}
+
+	// Wake up, PLL with X gyro reference (more stable than internal 8 MHz)
+	if (!writeReg(handle, MPU6050_PWR_MGMT_1, 0x01))
+	{
+		return false;
+	}
+	HAL_Delay(10);
+
+	if (!writeReg(handle, MPU6050_CONFIG, 0x03) ||      // DLPF 44 Hz
+		!writeReg(handle, MPU6050_SMPLRT_DIV, 0x09) ||  // 1 kHz / (1 + 9) = 100 Hz
+		!writeReg(handle, MPU6050_GYRO_CONFIG, 0x08) || // +-500 dps
+		!writeReg(handle, MPU6050_ACCEL_CONFIG, 0x00))  // +-2 g
+	{
+		return false;
+	}
+
+	handle->ready = true;
+	return true;
+}
+
+bool MPU6050_Read(MPU6050_Handle_t *handle, ImuSample_t *sample)
+{
+	if (handle == NULL || !handle->ready || sample == NULL)
+	{
+		return false;
+	}
+
+	// ACCEL_XOUT_H .. GYRO_ZOUT_L, big-endian, temperature in the middle
+	uint8_t raw[14];
+	TRACE_BEGIN(TRACE_EV_IMU, handle->address);
+	HAL_StatusTypeDef status = HAL_I2C_Mem_Read(handle->hi2c, handle->address << 1, MPU6050_ACCEL_XOUT_H,
+												I2C_MEMADD_SIZE_8BIT, raw, sizeof(raw), MPU6050_TIMEOUT_MS);
+	TRACE_END(TRACE_EV_IMU, handle->address);
+	if (status != HAL_OK)
+	{
+		return false;
+	}
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		int16_t accel = (int16_t)((raw[2 * axis] << 8) | raw[2 * axis + 1]);
+		int16_t gyro = (int16_t)((raw[8 + 2 * axis] << 8) | raw[8 + 2 * axis + 1]);
+		sample->accel_g[axis] = (float)accel / MPU6050_ACCEL_LSB_PER_G;
+		sample->gyro_dps[axis] = (float)gyro / MPU6050_GYRO_LSB_PER_DPS;
+	}
+	return true;
+}
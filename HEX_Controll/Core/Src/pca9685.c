@@ -9,6 +9,11 @@
  */
 
 #include "pca9685.h"
+#include "trace.h"
+#include "dwt_timer.h"
+
+// Emergency stop - channel writes refused while set (PCA9685_LockOutputs())
+static volatile bool outputs_locked;
 
 /**
  * @brief Initialize PCA9685 controller (NO SOFTWARE RESET)
@@ -114,17 +119,26 @@ bool PCA9685_TestPWMRange(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pw
 		return false;
 	}
 
-	// Test minimum position
-	PCA9685_SetPWM(handle, channel, pwm_min);
+	// Test minimum position (stops when a write is refused, e.g. emergency stop)
+	if (!PCA9685_SetPWM(handle, channel, pwm_min))
+	{
+		return false;
+	}
 	HAL_Delay(2000);
 
 	// Test center position
 	uint16_t pwm_mid = pwm_min + ((pwm_max - pwm_min) / 2);
-	PCA9685_SetPWM(handle, channel, pwm_mid);
+	if (!PCA9685_SetPWM(handle, channel, pwm_mid))
+	{
+		return false;
+	}
 	HAL_Delay(2000);
 
 	// Test maximum position
-	PCA9685_SetPWM(handle, channel, pwm_max);
+	if (!PCA9685_SetPWM(handle, channel, pwm_max))
+	{
+		return false;
+	}
 	HAL_Delay(2000);
 
 	return true;
@@ -142,7 +156,7 @@ bool PCA9685_TestPWMRange(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pw
  */
 bool PCA9685_SetPWM(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pwm_value)
 {
-	if (handle == NULL || !handle->ready || channel > 15)
+	if (handle == NULL || !handle->ready || channel > 15 || outputs_locked)
 	{
 		return false;
 	}
@@ -168,12 +182,77 @@ bool PCA9685_SetPWM(PCA9685_Handle_t *handle, uint8_t channel, uint16_t pwm_valu
 
 	// Write all 4 registers in one transaction (auto-increment enabled)
 	// This replicates: HAL_I2C_Mem_Write(&hi2c1, address<<1, base_reg, 1, pwm_data, 4, 1000)
-	if (HAL_I2C_Mem_Write(handle->hi2c, handle->address << 1, base_reg, 1, pwm_data, 4, 1000) != HAL_OK)
+	uint8_t trace_bus = (handle->hi2c->Instance == I2C1) ? TRACE_EV_I2C1 : TRACE_EV_I2C2;
+	(void)trace_bus;
+	TRACE_BEGIN(trace_bus, channel);
+	HAL_StatusTypeDef status = HAL_I2C_Mem_Write(handle->hi2c, handle->address << 1, base_reg, 1, pwm_data, 4, 1000);
+	TRACE_END(trace_bus, channel);
+
+	return status == HAL_OK;
+}
+
+/**
+ * @brief Fill LEDn_ON/OFF registers for consecutive channels (ON = 0, OFF = pwm)
+ */
+static void encodePWM(const uint16_t *pwm_values, uint8_t count, uint8_t *pwm_data)
+{
+	for (uint8_t i = 0; i < count; i++)
+	{
+		uint16_t pwm_value = (pwm_values[i] > 4095) ? 4095 : pwm_values[i];
+		pwm_data[4 * i + 0] = 0x00;					 // ON_L
+		pwm_data[4 * i + 1] = 0x00;					 // ON_H
+		pwm_data[4 * i + 2] = pwm_value & 0xFF;		 // OFF_L
+		pwm_data[4 * i + 3] = (pwm_value >> 8) & 0xFF; // OFF_H
+	}
+}
+
+/**
+ * @brief Set consecutive channels in one I2C transaction
+ * Same register layout as PCA9685_SetPWM(), relies on auto-increment (MODE1 bit 5)
+ */
+bool PCA9685_SetPWMMulti(PCA9685_Handle_t *handle, uint8_t first_channel,
+						 const uint16_t *pwm_values, uint8_t count)
+{
+	if (handle == NULL || !handle->ready || pwm_values == NULL ||
+		count == 0 || first_channel + count > 16 || outputs_locked)
 	{
 		return false;
 	}
 
-	return true;
+	uint8_t pwm_data[4 * 16];
+	encodePWM(pwm_values, count, pwm_data);
+
+	uint8_t base_reg = PCA9685_LED0_ON_L + (4 * first_channel);
+	uint8_t trace_bus = (handle->hi2c->Instance == I2C1) ? TRACE_EV_I2C1 : TRACE_EV_I2C2;
+	(void)trace_bus;
+	TRACE_BEGIN(trace_bus, first_channel);
+	HAL_StatusTypeDef status = HAL_I2C_Mem_Write(handle->hi2c, handle->address << 1, base_reg, 1,
+												 pwm_data, 4 * count, 1000);
+	TRACE_END(trace_bus, first_channel);
+
+	return status == HAL_OK;
+}
+
+/**
+ * @brief Start the same transaction as PCA9685_SetPWMMulti() in interrupt mode
+ * Completion is reported through HAL_I2C_MemTxCpltCallback() / HAL_I2C_ErrorCallback()
+ */
+bool PCA9685_SetPWMMultiIT(PCA9685_Handle_t *handle, uint8_t first_channel,
+						   const uint16_t *pwm_values, uint8_t count, uint8_t *tx_buffer)
+{
+	if (handle == NULL || !handle->ready || pwm_values == NULL || tx_buffer == NULL ||
+		count == 0 || first_channel + count > 16 || outputs_locked)
+	{
+		return false;
+	}
+
+	// tx_buffer is read by the I2C ISR - it must outlive this call
+	encodePWM(pwm_values, count, tx_buffer);
+
+	uint8_t base_reg = PCA9685_LED0_ON_L + (4 * first_channel);
+	HAL_StatusTypeDef status = HAL_I2C_Mem_Write_IT(handle->hi2c, handle->address << 1, base_reg, 1,
+													tx_buffer, 4 * count);
+	return status == HAL_OK;
 }
 
 /**
@@ -189,4 +268,108 @@ bool PCA9685_SetChannelOff(PCA9685_Handle_t *handle, uint8_t channel)
 
 	// Set PWM to 0 (no pulse)
 	return PCA9685_SetPWM(handle, channel, 0);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Transaction limit: DWT cycles, or loop passes if CYCCNT is not running
+ * Every pass takes several cycles, so timeout_cycles passes also end the wait
+ */
+static bool expired(uint32_t start, uint32_t timeout_cycles, uint32_t *passes)
+{
+	return dwtCycles() - start > timeout_cycles || ++(*passes) > timeout_cycles;
+}
+
+/**
+ * @brief Wait until (SR1 & flags) != 0, or NACK / timeout
+ */
+static bool waitSR1(I2C_TypeDef *i2c, uint32_t flags, uint32_t start, uint32_t timeout_cycles, uint32_t *passes)
+{
+	while ((i2c->SR1 & flags) == 0)
+	{
+		if ((i2c->SR1 & I2C_SR1_AF) != 0 || expired(start, timeout_cycles, passes))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Full-off all channels with one 3-byte transaction, register level (ISR safe)
+ */
+bool PCA9685_AllOffFromISR(PCA9685_Handle_t *handle, uint32_t timeout_cycles)
+{
+	if (handle == NULL || handle->hi2c == NULL)
+	{
+		return false;
+	}
+
+	I2C_HandleTypeDef *hi2c = handle->hi2c;
+	I2C_TypeDef *i2c = hi2c->Instance;
+	uint32_t start = dwtCycles();
+	uint32_t passes = 0;
+
+	// Stop servicing any HAL interrupt transfer in flight
+	i2c->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITERREN | I2C_CR2_ITBUFEN);
+
+	// Bus owned by an unfinished transfer - release it with STOP
+	if ((i2c->SR2 & I2C_SR2_BUSY) != 0)
+	{
+		i2c->CR1 |= I2C_CR1_STOP;
+		while ((i2c->SR2 & I2C_SR2_BUSY) != 0)
+		{
+			if (expired(start, timeout_cycles, &passes))
+			{
+				return false;
+			}
+		}
+	}
+
+	i2c->SR1 = (uint32_t)~(I2C_SR1_AF | I2C_SR1_ARLO | I2C_SR1_BERR); // rc_w0 - clear errors only
+	i2c->CR1 &= ~I2C_CR1_POS;
+	i2c->CR1 |= I2C_CR1_START;
+
+	bool ok = waitSR1(i2c, I2C_SR1_SB, start, timeout_cycles, &passes);
+	if (ok)
+	{
+		i2c->DR = (uint8_t)(handle->address << 1);
+		ok = waitSR1(i2c, I2C_SR1_ADDR, start, timeout_cycles, &passes);
+	}
+	if (ok)
+	{
+		(void)i2c->SR1; // ADDR cleared by reading SR1 then SR2
+		(void)i2c->SR2;
+		i2c->DR = PCA9685_ALL_LED_OFF_H;
+		ok = waitSR1(i2c, I2C_SR1_TXE, start, timeout_cycles, &passes);
+	}
+	if (ok)
+	{
+		i2c->DR = PCA9685_LED_FULL;
+		ok = waitSR1(i2c, I2C_SR1_BTF, start, timeout_cycles, &passes);
+	}
+
+	i2c->CR1 |= I2C_CR1_STOP;
+	i2c->SR1 = (uint32_t)~I2C_SR1_AF;
+
+	// The interrupted HAL transfer is over - leave the handle usable
+	hi2c->State = HAL_I2C_STATE_READY;
+	hi2c->Mode = HAL_I2C_MODE_NONE;
+	hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+	hi2c->XferCount = 0;
+	__HAL_UNLOCK(hi2c);
+
+	return ok;
+}
+
+/**
+ * @brief Refuse (or allow again) channel writes on every controller
+ */
+void PCA9685_LockOutputs(bool locked)
+{
+	outputs_locked = locked;
+}
+
+bool PCA9685_OutputsLocked(void)
+{
+	return outputs_locked;
+}
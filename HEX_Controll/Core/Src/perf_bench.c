@@ -0,0 +1,248 @@
+/*
+ * perf_bench.c - Pomiar czasu ramki chodu przy starcie
+ *
+ * Odtwarza pracę jednej ramki tripodGaitCycle() bez wysyłania
+ * nic do serw: IK + mapowanie dla wszystkich nóg, osobno czas magistral.
+ */
+
+#include "perf_bench.h"
+#include "hexapod_kinematics.h"
+#include "tripod_gait.h"
+#include "leg_config.h"
+#include "dwt_timer.h"
+#include "robot_description.h"
+#include <stdio.h>
+
+#if HEX_PERF_BENCHMARK
+
+#define BENCH_POINTS TRIPOD_FAST_POINTS // Jak tripodGaitCycle() bez kadencji
+#define PLACEMENT_CALLS 600 // Wywołań IK na jeden wariant umieszczenia
+#define BATCH_FRAMES 200    // Ramek IK wszystkich nóg: noga po nodze vs partia
+
+typedef bool (*BenchIKFunc_t)(int, float, float, float, float *, float *, float *);
+
+// Wynik mapowania - volatile, żeby kompilator nie usunął obliczeń
+static volatile uint16_t bench_pwm_sink;
+
+/**
+ * @brief Kąt stawu -> PWM, jak legOutputSetJoints()
+ */
+static uint16_t benchAngleToPwm(const ServoPwmLimits_t *limits, float deg)
+{
+    return legConfigAngleToPwm(limits, 90.0f + deg);
+}
+
+/**
+ * @brief Jedna noga w ramce: trajektoria, IK, mapowanie
+ */
+static bool benchLeg(int leg_number, bool swing, float t, float smooth_t)
+{
+    // Pozycje bazowe - jak w tripod_gait.c (robot_description.h)
+    float base_x = robot_description.stance_x[leg_number - 1];
+    float base_y = robot_description.stance_y[leg_number - 1];
+    float step = tripod_cfg->step_length;
+
+    float y, z = ROBOT_STANCE_Z;
+    if (swing)
+    {
+        y = base_y + step + (-2.0f * step) * smooth_t;
+        z -= 4.0f * tripod_cfg->lift_height * t * (1.0f - t);
+    }
+    else
+    {
+        y = base_y - step + (2.0f * step) * smooth_t;
+    }
+
+    float q1, q2, q3;
+    if (!computeLegIK(leg_number, base_x, y, z, &q1, &q2, &q3))
+    {
+        return false;
+    }
+
+    const ServoPwmLimits_t *limits = leg_config->servo[leg_number - 1];
+    bench_pwm_sink = benchAngleToPwm(&limits[0], q1 * 180.0f / M_PI + leg_config->legs[leg_number - 1].hip_offset_deg);
+    bench_pwm_sink = benchAngleToPwm(&limits[1], q2 * 180.0f / M_PI);
+    bench_pwm_sink = benchAngleToPwm(&limits[2], q3 * 180.0f / M_PI);
+    return true;
+}
+
+/**
+ * @brief Odczyt 4 rejestrów każdego z 9 kanałów na jednym PCA9685
+ *
+ * @return Czas w cyklach lub 0 gdy brak kontrolera
+ */
+static uint32_t benchBus(PCA9685_Handle_t *pca)
+{
+    if (pca == NULL || !pca->ready)
+    {
+        return 0;
+    }
+
+    uint8_t regs[4];
+    uint32_t start = dwtCycles();
+    for (uint8_t channel = 0; channel < 9; channel++)
+    {
+        HAL_I2C_Mem_Read(pca->hi2c, pca->address << 1, PCA9685_LED0_ON_L + 4 * channel,
+                         I2C_MEMADD_SIZE_8BIT, regs, sizeof(regs), 10);
+    }
+    return dwtCycles() - start;
+}
+
+/**
+ * @brief Średni koszt IK [cykle] dla danej kopii funkcji
+ */
+static uint32_t benchIKCall(BenchIKFunc_t ik)
+{
+    float q1, q2, q3;
+    uint32_t start = dwtCycles();
+    for (int i = 0; i < PLACEMENT_CALLS; i++)
+    {
+        int leg = 1 + i % HEX_LEG_COUNT;
+        float y = robot_description.stance_y[leg - 1] + (float)(i % 9) - 4.0f;
+        ik(leg, robot_description.stance_x[leg - 1], y, ROBOT_STANCE_Z, &q1, &q2, &q3);
+    }
+    return (dwtCycles() - start) / PLACEMENT_CALLS;
+}
+
+/**
+ * @brief IK z flash vs z SRAM przy różnych ustawieniach ART
+ *
+ * Cache są wyłączane, czyszczone i włączane zgodnie z RM0390
+ * (reset I/D-cache tylko gdy wyłączone). Na koniec przywracane jest ACR.
+ */
+static void benchPlacement(void)
+{
+    static const struct
+    {
+        const char *name;
+        uint32_t acr_bits;
+    } configs[] = {
+        {"ART pełny (PRFT+I+D)", FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN},
+        {"tylko I-cache", FLASH_ACR_ICEN},
+        {"bez ART", 0},
+    };
+    const uint32_t art_mask = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN;
+    uint32_t saved_acr = FLASH->ACR;
+
+    printf("\n=== IK: flash vs SRAM (%d wywołań, cykle/IK) ===\n", PLACEMENT_CALLS);
+    printf("%-22s %8s %8s\n", "konfiguracja", "flash", "SRAM");
+
+    for (unsigned c = 0; c < sizeof(configs) / sizeof(configs[0]); c++)
+    {
+        FLASH->ACR &= ~art_mask;
+        FLASH->ACR |= FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+        FLASH->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+        FLASH->ACR |= configs[c].acr_bits;
+
+        uint32_t flash_cycles = benchIKCall(computeLegIKFlash);
+        uint32_t sram_cycles = benchIKCall(computeLegIK);
+        printf("%-22s %8lu %8lu  -> %s\n", configs[c].name, flash_cycles, sram_cycles,
+               (sram_cycles < flash_cycles) ? "SRAM" : "flash");
+    }
+
+    FLASH->ACR = saved_acr;
+}
+
+/**
+ * @brief IK wszystkich nóg ramki: computeLegIK() po kolei vs computeLegIKBatch()
+ */
+static void benchBatch(void)
+{
+    LegIKBatch_t batch;
+    float q1, q2, q3;
+    uint32_t single = 0, batched = 0;
+
+    for (int i = 0; i < BATCH_FRAMES; i++)
+    {
+        float dy = (float)(i % 9) - 4.0f;
+        batch.count = HEX_LEG_COUNT;
+        for (int k = 0; k < HEX_LEG_COUNT; k++)
+        {
+            batch.leg[k] = (uint8_t)(k + 1);
+            batch.x[k] = robot_description.stance_x[k];
+            batch.y[k] = robot_description.stance_y[k] + dy;
+            batch.z[k] = ROBOT_STANCE_Z;
+        }
+
+        uint32_t start = dwtCycles();
+        for (int k = 0; k < HEX_LEG_COUNT; k++)
+            computeLegIK(batch.leg[k], batch.x[k], batch.y[k], batch.z[k], &q1, &q2, &q3);
+        single += dwtCycles() - start;
+
+        start = dwtCycles();
+        computeLegIKBatch(&batch);
+        batched += dwtCycles() - start;
+    }
+
+    printf("\n=== IK %d nóg w ramce (%d ramek, cykle/ramka) ===\n", HEX_LEG_COUNT, BATCH_FRAMES);
+    printf("noga po nodze %lu, partia %lu\n", single / BATCH_FRAMES, batched / BATCH_FRAMES);
+}
+
+void perfBenchmarkRun(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, PerfBenchResult_t *result)
+{
+    PerfBenchResult_t r = {.compute_min = UINT32_MAX};
+    uint64_t compute_sum = 0;
+
+    dwtTimerInit();
+
+    // Obliczenia: PERF_BENCH_CYCLES x (faza 1 + faza 2)
+    for (int cycle = 0; cycle < PERF_BENCH_CYCLES; cycle++)
+    {
+        for (int phase = 0; phase < 2; phase++)
+        {
+            for (int i = 0; i <= BENCH_POINTS; i++)
+            {
+                float t = (float)i / (float)BENCH_POINTS;
+                float smooth_t = t * t * (3.0f - 2.0f * t);
+                // Faza 1: grupa A swing, faza 2: grupa B swing
+                uint32_t start = dwtCycles();
+                bool ok = true;
+                for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+                    ok &= benchLeg(leg, robot_description.group[leg - 1] == phase, t, smooth_t);
+                uint32_t cycles = dwtCycles() - start;
+
+                if (!ok)
+                    r.ik_failures++;
+                if (cycles < r.compute_min)
+                    r.compute_min = cycles;
+                if (cycles > r.compute_max)
+                    r.compute_max = cycles;
+                compute_sum += cycles;
+                r.frames++;
+            }
+        }
+    }
+    r.compute_avg = (uint32_t)(compute_sum / r.frames);
+
+    // Magistrala: kilka ramek, magistrale po kolei (tak jak dziś w chodzie)
+    uint64_t bus_sum = 0;
+    const int bus_frames = 5;
+    for (int i = 0; i < bus_frames; i++)
+    {
+        bus_sum += benchBus(pca1);
+        bus_sum += benchBus(pca2);
+    }
+    r.bus_avg = (uint32_t)(bus_sum / bus_frames);
+
+    uint32_t frame_us = dwtCyclesToUs(r.compute_avg + r.bus_avg);
+
+    printf("\n=== PERF BENCHMARK (ramka tripod, %lu ramek) ===\n", r.frames);
+    printf("Obliczenia: min %lu us, śr %lu us, max %lu us\n",
+           dwtCyclesToUs(r.compute_min), dwtCyclesToUs(r.compute_avg), dwtCyclesToUs(r.compute_max));
+    printf("Magistrale I2C: %lu us/ramka (%d x 4 bajty)\n", dwtCyclesToUs(r.bus_avg), 3 * HEX_LEG_COUNT);
+    printf("Ramka razem: %lu us -> max %lu ramek/s\n", frame_us, frame_us ? 1000000UL / frame_us : 0);
+    if (r.ik_failures)
+    {
+        printf("⚠️  IK nieudane w %lu ramkach\n", r.ik_failures);
+    }
+
+    benchPlacement();
+    benchBatch();
+
+    if (result != NULL)
+    {
+        *result = r;
+    }
+}
+
+#endif // HEX_PERF_BENCHMARK
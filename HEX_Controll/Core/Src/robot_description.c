@@ -0,0 +1,38 @@
+/*
+ * robot_description.c - Dane chodów z tabeli nóg (ROBOT_LEG_TABLE)
+ */
+
+#include "robot_description.h"
+
+#define STANCE_X(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) sx,
+#define STANCE_Y(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) sy,
+#define WAVE_X(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) wx,
+#define WAVE_Y(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) wy,
+#define GROUP(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) group,
+#define RIGHT(ox, oy, right, sx, sy, wx, wy, group, device, channel, hip) right,
+
+const RobotDescription_t robot_description = {
+    .stance_x = {ROBOT_LEG_TABLE(STANCE_X)},
+    .stance_y = {ROBOT_LEG_TABLE(STANCE_Y)},
+    .wave_x = {ROBOT_LEG_TABLE(WAVE_X)},
+    .wave_y = {ROBOT_LEG_TABLE(WAVE_Y)},
+    .group = {ROBOT_LEG_TABLE(GROUP)},
+    .right = {ROBOT_LEG_TABLE(RIGHT)},
+};
+
+int robotGroupLegs(uint8_t group, int legs[HEX_LEG_COUNT])
+{
+    int n = 0;
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        if (robot_description.group[leg - 1] == group)
+            legs[n++] = leg;
+    }
+    return n;
+}
+
+int robotLegRow(int leg_number)
+{
+    float y = robot_description.stance_y[leg_number - 1];
+    return (y < 0.0f) ? -1 : (y > 0.0f) ? 1 : 0;
+}
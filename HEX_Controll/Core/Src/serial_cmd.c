@@ -0,0 +1,376 @@
+/*
+ * serial_cmd.c - Odbiór linii z UART2 w przerwaniu i tablica komend
+ */
+
+#include "serial_cmd.h"
+#include "metrics.h"
+#include "control_frame.h"
+#include "foot_contact.h"
+#include "mem_monitor.h"
+#include "mem_arena.h"
+#include "flight_rec.h"
+#include "tripod_gait.h"
+#include "leg_output.h"
+#include "servo_bus.h"
+#include "servo_frame.h"
+#include "servo_estop.h"
+#include "bus_load.h"
+#include "config_params.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RX_RING_SIZE 64 // Potęga 2
+
+typedef struct
+{
+    const char *name;
+    const char *help;
+    SerialCmdHandler_t handler;
+} SerialCmd_t;
+
+static UART_HandleTypeDef *uart = NULL;
+static uint8_t rx_byte;
+static uint8_t rx_ring[RX_RING_SIZE];
+static volatile uint8_t rx_head; // Zapis w ISR
+static volatile uint8_t rx_tail; // Odczyt w serialCmdPoll()
+static volatile uint32_t rx_overflows;
+
+static char line[SERIAL_CMD_LINE_MAX + 1];
+static uint8_t line_len;
+static bool line_overflow;
+
+static SerialCmd_t commands[SERIAL_CMD_MAX];
+static uint8_t command_count;
+
+static void cmdHelp(const char *args)
+{
+    (void)args;
+    printf("Komendy:\n");
+    for (uint8_t i = 0; i < command_count; i++)
+    {
+        printf("  %-10s %s\n", commands[i].name, commands[i].help);
+    }
+}
+
+static void cmdMetrics(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+    {
+        metricsReset();
+        printf("Metryki wyzerowane\n");
+        return;
+    }
+    metricsDump();
+}
+
+static void cmdFrame(const char *args)
+{
+    (void)args;
+    controlFrameReport();
+}
+
+static void cmdFeet(const char *args)
+{
+    (void)args;
+    footContactReport();
+}
+
+static void cmdMem(const char *args)
+{
+    (void)args;
+    memMonitorReport();
+    memArenaReport();
+}
+
+static void cmdRec(const char *args)
+{
+    (void)args;
+    flightRecDump();
+}
+
+static void cmdTorque(const char *args)
+{
+    (void)args;
+    tripodPrintTorque(TRIPOD_FORWARD);
+}
+
+static void cmdOrder(const char *args)
+{
+    if (strcmp(args, "call") == 0)
+        leg_output_order = LEG_ORDER_CALL;
+    else if (strcmp(args, "swing") == 0)
+        leg_output_order = LEG_ORDER_SWING_FIRST;
+    else if (strcmp(args, "reset") == 0)
+        legOutputResetTiming();
+    else if (*args != '\0')
+    {
+        printf("Użycie: order [call|swing|reset]\n");
+        return;
+    }
+    legOutputReport();
+}
+
+static void busLoadReport(void)
+{
+    static BusLoadResult_t result; // ~0.5 KB - nie na stosie komendy
+    uint8_t device_bus[LEG_CONFIG_MAX_DEVICES] = {0};
+    for (uint8_t d = 0; d < servoBusDeviceCount(); d++)
+        device_bus[d] = servoBusDeviceBus(d);
+
+    printf("\n=== OBCIĄŻENIE MAGISTRAL W FAZACH (model, swing najpierw) ===\n");
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        const LegMapping_t *m = &leg_config->legs[leg - 1];
+        printf("noga %d: PCA %u kanały %u-%u, magistrala %u\n", leg, m->device, m->base_channel,
+               m->base_channel + 2, device_bus[m->device]);
+    }
+    for (int gait = 0; gait < BUS_LOAD_GAITS; gait++)
+    {
+        busLoadAnalyse(leg_config, device_bus, (BusLoadGait_t)gait, &result);
+        busLoadPrint(&result);
+    }
+}
+
+static void busWire(const char *args)
+{
+    // Trzy liczby i nic więcej - brakujące pole nie może stać się zerem zapisanym do flash
+    long fields[3] = {0};
+    const char *p = args;
+    bool parsed = true;
+    for (int i = 0; i < 3 && parsed; i++)
+    {
+        char *end;
+        fields[i] = strtol(p, &end, 10);
+        parsed = (end != p);
+        p = end;
+    }
+    while (*p == ' ')
+        p++;
+
+    long leg = fields[0], device = fields[1], channel = fields[2];
+    if (!parsed || *p != '\0' || !legNumberValid((int)leg) || device < 0 ||
+        device >= servoBusDeviceCount() || channel < 0 || channel > 13)
+    {
+        printf("Użycie: bus wire <noga> <PCA 0..%u> <kanał biodra 0..13>\n", servoBusDeviceCount() - 1);
+        return;
+    }
+
+    // Kopia aktywnej konfiguracji - configParamsSave() sprawdza nakładanie kanałów
+    LegConfig_t updated = *leg_config;
+    updated.legs[leg - 1].device = (uint8_t)device;
+    updated.legs[leg - 1].base_channel = (uint8_t)channel;
+    if (!configParamsSave(CONFIG_TYPE_LEG_CONFIG, &updated))
+    {
+        printf("❌ Okablowanie odrzucone (kanały zajęte?) albo zapis nieudany\n");
+        return;
+    }
+    printf("Noga %ld: PCA %ld kanały %ld-%ld - zapisano\n", leg, device, channel, channel + 2);
+    busLoadReport();
+}
+
+static void cmdBus(const char *args)
+{
+    if (strcmp(args, "reset") == 0)
+        servoBusResetStats();
+    else if (strcmp(args, "load") == 0)
+    {
+        busLoadReport();
+        return;
+    }
+    else if (strncmp(args, "wire ", 5) == 0)
+    {
+        busWire(args + 5);
+        return;
+    }
+    else if (*args != '\0')
+    {
+        printf("Użycie: bus [reset|load|wire <noga> <PCA> <kanał>]\n");
+        return;
+    }
+    servoBusReport();
+}
+
+static void cmdPwm(const char *args)
+{
+    (void)args;
+    // Dzierżawa - ramka nie wróci do puli w trakcie wypisywania
+    const ServoFrame_t *f = servoFrameLeaseLatest();
+    if (f == NULL)
+    {
+        printf("Brak ramki PWM\n");
+        return;
+    }
+
+    printf("Ramka PWM %lu (odmowy puli %lu)\n", f->seq, servoFrameAcquireFails());
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        const uint16_t *pwm = servoFrameLegPwm(f, leg);
+        if (pwm == NULL)
+            continue;
+        printf("  noga %d: %4u %4u %4u%s\n", leg, pwm[0], pwm[1], pwm[2],
+               (f->bus_err & LEG_BIT(leg)) ? "  (błąd zapisu)" : "");
+    }
+    servoFrameRelease(f);
+}
+
+static void cmdEstop(const char *args)
+{
+    if (strcmp(args, "clear") == 0)
+        servoEstopRelease();
+    else if (*args == '\0')
+        servoEstopTrigger();
+    else if (strcmp(args, "status") != 0)
+    {
+        printf("Użycie: estop [clear|status]\n");
+        return;
+    }
+    servoEstopReport();
+}
+
+void serialCmdInit(UART_HandleTypeDef *huart)
+{
+    uart = huart;
+    rx_head = rx_tail = 0;
+    line_len = 0;
+    line_overflow = false;
+
+    serialCmdRegister("help", "lista komend", cmdHelp);
+    serialCmdRegister("metrics", "zrzut metryk, 'metrics reset' zeruje", cmdMetrics);
+    serialCmdRegister("frame", "ramki i poziomowanie", cmdFrame);
+    serialCmdRegister("feet", "kontakt stóp", cmdFeet);
+    serialCmdRegister("mem", "stos, sterta, areny i pule", cmdMem);
+    serialCmdRegister("rec", "ostatnie ramki chodu (CSV)", cmdRec);
+    serialCmdRegister("order", "kolejność zapisów nóg: call|swing|reset", cmdOrder);
+    serialCmdRegister("torque", "momenty stance tripodu (przód)", cmdTorque);
+    serialCmdRegister("estop", "stop awaryjny serw, 'estop clear' zwalnia, 'estop status'", cmdEstop);
+    serialCmdRegister("pwm", "PWM nóg z ostatniej ramki", cmdPwm);
+    serialCmdRegister("bus", "magistrale: flush, 'bus reset', 'bus load' fazy chodu, 'bus wire' okablowanie", cmdBus);
+
+    HAL_NVIC_SetPriority(USART2_IRQn, 5, 0);
+    HAL_NVIC_EnableIRQ(USART2_IRQn);
+    HAL_UART_Receive_IT(uart, &rx_byte, 1);
+}
+
+bool serialCmdRegister(const char *name, const char *help, SerialCmdHandler_t handler)
+{
+    for (uint8_t i = 0; i < command_count; i++)
+    {
+        if (strcmp(commands[i].name, name) == 0)
+        {
+            commands[i].help = help;
+            commands[i].handler = handler;
+            return true;
+        }
+    }
+
+    if (command_count >= SERIAL_CMD_MAX)
+    {
+        return false;
+    }
+    commands[command_count].name = name;
+    commands[command_count].help = help;
+    commands[command_count].handler = handler;
+    command_count++;
+    return true;
+}
+
+static void execute(char *text)
+{
+    while (*text == ' ')
+        text++;
+    if (*text == '\0')
+        return;
+
+    char *args = text;
+    while (*args != '\0' && *args != ' ')
+        args++;
+    if (*args != '\0')
+    {
+        *args++ = '\0';
+        while (*args == ' ')
+            args++;
+    }
+
+    for (uint8_t i = 0; i < command_count; i++)
+    {
+        if (strcmp(commands[i].name, text) == 0)
+        {
+            commands[i].handler(args);
+            return;
+        }
+    }
+    printf("Nieznana komenda '%s' - 'help'\n", text);
+}
+
+void serialCmdPoll(void)
+{
+    while (rx_tail != rx_head)
+    {
+        char c = (char)rx_ring[rx_tail];
+        rx_tail = (rx_tail + 1) & (RX_RING_SIZE - 1);
+
+        if (c == '\r' || c == '\n')
+        {
+            line[line_len] = '\0';
+            if (line_overflow)
+                printf("⚠️  Linia za długa (max %d znaków)\n", SERIAL_CMD_LINE_MAX);
+            else
+                execute(line);
+            line_len = 0;
+            line_overflow = false;
+        }
+        else if (line_len < SERIAL_CMD_LINE_MAX)
+        {
+            line[line_len++] = c;
+        }
+        else
+        {
+            line_overflow = true;
+        }
+    }
+
+    if (rx_overflows > 0)
+    {
+        printf("⚠️  Bufor UART przepełniony (%lu znaków utraconych)\n", rx_overflows);
+        rx_overflows = 0;
+    }
+}
+
+void serialCmdWait(uint32_t ms)
+{
+    uint32_t start = HAL_GetTick();
+    while ((HAL_GetTick() - start) < ms)
+    {
+        serialCmdPoll();
+    }
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != uart)
+    {
+        return;
+    }
+
+    uint8_t next = (rx_head + 1) & (RX_RING_SIZE - 1);
+    if (next != rx_tail)
+    {
+        rx_ring[rx_head] = rx_byte;
+        rx_head = next;
+    }
+    else
+    {
+        rx_overflows++;
+    }
+    HAL_UART_Receive_IT(uart, &rx_byte, 1);
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    // Overrun/ramka - HAL przerywa odbiór, wznów go
+    if (huart == uart)
+    {
+        HAL_UART_Receive_IT(uart, &rx_byte, 1);
+    }
+}
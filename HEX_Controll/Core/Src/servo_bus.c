@@ -0,0 +1,340 @@
+/*
+ * servo_bus.c - Tablica kontrolerów PCA9685 i równoległy zapis po magistralach I2C
+ */
+
+#include "servo_bus.h"
+#include "dwt_timer.h"
+#include "servo_frame.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct
+{
+    PCA9685_Handle_t *pca;
+    uint8_t bus;
+    uint16_t dirty; // Kanały czekające na flush (kopia ServoFrame_t::pending)
+    bool ok;              // Wynik ostatniego flush
+    uint32_t done_cycles; // Koniec ostatniej transakcji (DWT)
+} ServoBusDevice_t;
+
+typedef struct
+{
+    I2C_HandleTypeDef *hi2c;
+    uint8_t devices[SERVO_BUS_MAX_DEVICES]; // Indeksy urządzeń na tej magistrali
+    uint8_t device_count;
+    uint8_t cursor;      // Następne urządzenie do sprawdzenia w flush
+    uint8_t current;     // Urządzenie bieżącej transakcji
+    volatile bool busy;  // Flush tej magistrali w toku
+    uint32_t done_cycles;
+    uint8_t tx[4 * SERVO_BUS_CHANNELS]; // Czytany przez ISR w trakcie transferu
+} ServoBus_t;
+
+static ServoBusDevice_t devices[SERVO_BUS_MAX_DEVICES];
+static uint8_t device_count;
+static ServoBus_t buses[SERVO_BUS_MAX_BUSES];
+static uint8_t bus_count;
+static ServoBusFlushStats_t stats;
+static const ServoFrame_t *flush_frame; // Dzierżawa na czas flush - ISR czyta PWM w miejscu
+
+_Static_assert(SERVO_FRAME_CHANNELS == SERVO_BUS_CHANNELS, "servo_bus: kanały ramki != PCA9685");
+_Static_assert(SERVO_FRAME_DEVICES >= SERVO_BUS_MAX_DEVICES, "servo_bus: ramka bez wszystkich urządzeń");
+
+static void enableBusIrq(I2C_HandleTypeDef *hi2c)
+{
+    IRQn_Type ev, er;
+    if (hi2c->Instance == I2C1)
+    {
+        ev = I2C1_EV_IRQn;
+        er = I2C1_ER_IRQn;
+    }
+    else if (hi2c->Instance == I2C2)
+    {
+        ev = I2C2_EV_IRQn;
+        er = I2C2_ER_IRQn;
+    }
+    else
+    {
+        ev = I2C3_EV_IRQn;
+        er = I2C3_ER_IRQn;
+    }
+
+    HAL_NVIC_SetPriority(ev, 5, 0);
+    HAL_NVIC_SetPriority(er, 5, 0);
+    HAL_NVIC_EnableIRQ(ev);
+    HAL_NVIC_EnableIRQ(er);
+}
+
+int servoBusAddDevice(PCA9685_Handle_t *pca)
+{
+    if (pca == NULL || pca->hi2c == NULL || device_count >= SERVO_BUS_MAX_DEVICES)
+    {
+        return -1;
+    }
+
+    uint8_t bus = 0;
+    while (bus < bus_count && buses[bus].hi2c != pca->hi2c)
+        bus++;
+
+    if (bus == bus_count)
+    {
+        if (bus_count >= SERVO_BUS_MAX_BUSES)
+        {
+            return -1;
+        }
+        buses[bus].hi2c = pca->hi2c;
+        bus_count++;
+        enableBusIrq(pca->hi2c);
+    }
+
+    ServoBusDevice_t *dev = &devices[device_count];
+    memset(dev, 0, sizeof(*dev));
+    dev->pca = pca;
+    dev->bus = bus;
+    dev->ok = true;
+    buses[bus].devices[buses[bus].device_count++] = device_count;
+
+    return device_count++;
+}
+
+PCA9685_Handle_t *servoBusDevice(uint8_t device)
+{
+    return (device < device_count) ? devices[device].pca : NULL;
+}
+
+uint8_t servoBusDeviceCount(void)
+{
+    return device_count;
+}
+
+uint8_t servoBusDeviceBus(uint8_t device)
+{
+    return (device < device_count) ? devices[device].bus : 0;
+}
+
+uint8_t servoBusCount(void)
+{
+    return bus_count;
+}
+
+bool servoBusWrite(uint8_t device, uint8_t channel, const uint16_t *pwm, uint8_t count)
+{
+    if (device >= device_count)
+    {
+        return false;
+    }
+    return PCA9685_SetPWMMulti(devices[device].pca, channel, pwm, count);
+}
+
+/**
+ * @brief Wystartuj następną serię kanałów magistrali (wątek główny i ISR)
+ *
+ * Seria = ciągłe brudne kanały jednego urządzenia. Bez serii do wysłania
+ * magistrala kończy flush.
+ */
+static void startNext(ServoBus_t *bus)
+{
+    while (bus->cursor < bus->device_count)
+    {
+        uint8_t index = bus->devices[bus->cursor];
+        ServoBusDevice_t *dev = &devices[index];
+        if (dev->dirty == 0)
+        {
+            bus->cursor++;
+            continue;
+        }
+
+        uint8_t first = (uint8_t)__builtin_ctz(dev->dirty);
+        uint8_t count = 0;
+        while (first + count < SERVO_BUS_CHANNELS && (dev->dirty & (1U << (first + count))))
+            count++;
+        dev->dirty &= (uint16_t)~(((1U << count) - 1U) << first);
+
+        bus->current = index;
+        ServoBusStats_t *s = &stats.bus[bus - buses];
+        s->transfers++;
+        s->bytes += 4U * count;
+        if (PCA9685_SetPWMMultiIT(dev->pca, first, &flush_frame->pwm[index][first], count, bus->tx))
+        {
+            return; // Dalej z HAL_I2C_MemTxCpltCallback()
+        }
+
+        // Magistrala zajęta albo kontroler niegotowy - seria stracona
+        dev->ok = false;
+        dev->done_cycles = dwtCycles();
+        s->errors++;
+    }
+
+    bus->done_cycles = dwtCycles();
+    bus->busy = false;
+}
+
+static ServoBus_t *findBus(I2C_HandleTypeDef *hi2c)
+{
+    for (uint8_t i = 0; i < bus_count; i++)
+    {
+        if (buses[i].hi2c == hi2c)
+            return &buses[i];
+    }
+    return NULL;
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+    ServoBus_t *bus = findBus(hi2c);
+    if (bus == NULL || !bus->busy)
+    {
+        return;
+    }
+    devices[bus->current].done_cycles = dwtCycles();
+    startNext(bus);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+    ServoBus_t *bus = findBus(hi2c);
+    if (bus == NULL || !bus->busy)
+    {
+        return;
+    }
+    devices[bus->current].ok = false;
+    devices[bus->current].done_cycles = dwtCycles();
+    stats.bus[bus - buses].errors++;
+    startNext(bus);
+}
+
+bool servoBusFlushFrame(const ServoFrame_t *frame)
+{
+    bool any = false;
+    for (uint8_t i = 0; i < device_count; i++)
+    {
+        devices[i].dirty = frame->pending[i];
+        if (devices[i].dirty != 0)
+        {
+            devices[i].ok = true;
+            any = true;
+        }
+    }
+    if (!any)
+    {
+        return true;
+    }
+
+    flush_frame = servoFrameLease(frame);
+
+    uint32_t start = dwtCycles();
+    for (uint8_t b = 0; b < bus_count; b++)
+    {
+        buses[b].cursor = 0;
+        buses[b].done_cycles = start;
+        buses[b].busy = true;
+        startNext(&buses[b]);
+    }
+
+    uint32_t tick = HAL_GetTick();
+    bool pending = true;
+    while (pending)
+    {
+        pending = false;
+        for (uint8_t b = 0; b < bus_count; b++)
+            pending = pending || buses[b].busy;
+
+        if (pending && HAL_GetTick() - tick > SERVO_BUS_FLUSH_TIMEOUT_MS)
+        {
+            // Zawieszona magistrala - porzuć jej resztę, następna ramka spróbuje znowu
+            for (uint8_t b = 0; b < bus_count; b++)
+            {
+                ServoBus_t *bus = &buses[b];
+                if (!bus->busy)
+                    continue;
+                bus->busy = false;
+                bus->done_cycles = dwtCycles();
+                devices[bus->current].ok = false;
+                for (uint8_t d = 0; d < bus->device_count; d++)
+                {
+                    ServoBusDevice_t *dev = &devices[bus->devices[d]];
+                    if (dev->dirty != 0)
+                        dev->ok = false;
+                    dev->dirty = 0;
+                }
+                stats.bus[b].errors++;
+                HAL_I2C_Master_Abort_IT(bus->hi2c, devices[bus->current].pca->address << 1);
+            }
+            stats.timeouts++;
+            pending = false;
+        }
+    }
+
+    uint32_t wall_us = 0;
+    for (uint8_t b = 0; b < bus_count; b++)
+    {
+        uint32_t busy_us = dwtCyclesToUs(buses[b].done_cycles - start);
+        ServoBusStats_t *s = &stats.bus[b];
+        s->busy_us_sum += busy_us;
+        if (busy_us > s->busy_us_max)
+            s->busy_us_max = busy_us;
+        stats.serial_us_sum += busy_us;
+        if (busy_us > wall_us)
+            wall_us = busy_us;
+    }
+    stats.flushes++;
+    stats.wall_us_sum += wall_us;
+    if (wall_us > stats.wall_us_max)
+        stats.wall_us_max = wall_us;
+
+    servoFrameRelease(flush_frame);
+    flush_frame = NULL;
+
+    bool ok = true;
+    for (uint8_t i = 0; i < device_count; i++)
+        ok = ok && devices[i].ok;
+    return ok;
+}
+
+bool servoBusDeviceResult(uint8_t device, uint32_t *done_cycles)
+{
+    if (device >= device_count)
+    {
+        return false;
+    }
+    if (done_cycles != NULL)
+        *done_cycles = devices[device].done_cycles;
+    return devices[device].ok;
+}
+
+void servoBusGetStats(ServoBusFlushStats_t *out)
+{
+    *out = stats;
+}
+
+void servoBusResetStats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void servoBusReport(void)
+{
+    printf("\n=== MAGISTRALE SERW (%u kontrolerów, %u magistrale) ===\n", device_count, bus_count);
+    for (uint8_t i = 0; i < device_count; i++)
+    {
+        const PCA9685_Handle_t *pca = devices[i].pca;
+        printf("PCA %u: I2C%d, adres 0x%02X, magistrala %u%s\n", i,
+               (pca->hi2c->Instance == I2C1) ? 1 : (pca->hi2c->Instance == I2C2) ? 2 : 3,
+               pca->address, devices[i].bus, pca->ready ? "" : " (niegotowy)");
+    }
+
+    if (stats.flushes == 0)
+    {
+        printf("Brak zapisów buforowanych\n");
+        return;
+    }
+
+    printf("Flush: %lu, śr %lu us / max %lu us, po kolei byłoby śr %lu us, przekroczenia czasu %lu\n",
+           stats.flushes, stats.wall_us_sum / stats.flushes, stats.wall_us_max,
+           stats.serial_us_sum / stats.flushes, stats.timeouts);
+    for (uint8_t b = 0; b < bus_count; b++)
+    {
+        const ServoBusStats_t *s = &stats.bus[b];
+        printf("  magistrala %u: %lu transakcji, %lu B, zajęta śr %lu us / max %lu us, błędy %lu\n",
+               b, s->transfers, s->bytes, s->busy_us_sum / stats.flushes, s->busy_us_max, s->errors);
+    }
+}
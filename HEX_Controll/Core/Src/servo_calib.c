@@ -0,0 +1,463 @@
+/*
+ * servo_calib.c - Przemiatanie PWM wszystkich serw naraz i zapis limitów z potwierdzeń operatora
+ */
+
+#include "servo_calib.h"
+#include "servo_frame.h"
+#include "servo_bus.h"
+#include "servo_estop.h"
+#include "serial_cmd.h"
+#include "config_params.h"
+#include "leg_config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if HEX_SERVO_CALIB
+
+ServoCalibConfig_t servo_calib_config = {
+    .pattern = SERVO_CALIB_PATTERN_JOINT, // Jeden staw na raz - łatwiej patrzeć na 6 serw niż na 18
+    .legs = (LegMask_t)((1ULL << HEX_LEG_COUNT) - 1U),
+    .joints = SERVO_CALIB_JOINTS_ALL,
+    .center_pwm = (LEG_CONFIG_PWM_MIN_DEFAULT + LEG_CONFIG_PWM_MAX_DEFAULT) / 2,
+    .floor_pwm = 90, // ~0.45 ms przy 50 Hz - poniżej typowego zakresu serw
+    .ceil_pwm = 560, // ~2.7 ms
+    .step_pwm = 4,
+    .dwell_ms = 150,
+};
+
+static const char *const joint_names[3] = {"hip", "knee", "ankle"};
+
+static uint16_t pwm[HEX_LEG_COUNT][3];
+static uint16_t found_min[HEX_LEG_COUNT][3];
+static uint16_t found_max[HEX_LEG_COUNT][3];
+static uint8_t moving[HEX_LEG_COUNT]; // Bity stawów przemiatanych w tej fazie
+static uint8_t marked_min[HEX_LEG_COUNT];
+static uint8_t marked_max[HEX_LEG_COUNT];
+
+static bool running;
+static bool phase_max;
+static bool paused;
+static bool skip_phase;
+static bool abort_run;
+static bool dirty; // PWM zmienione komendą - wysłać bez czekania na krok
+
+static bool anyMoving(void)
+{
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        if (moving[i] != 0)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief PWM kalibrowanych nóg - jedna ramka, wszystkie magistrale równolegle
+ */
+static bool writeLegs(void)
+{
+    if (servoEstopActive())
+    {
+        return false;
+    }
+
+    const ServoCalibConfig_t *cfg = &servo_calib_config;
+    ServoFrame_t *frame = servoFrameAcquire();
+    bool ok = true;
+
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        if (!(cfg->legs & LEG_BIT(leg)))
+            continue;
+
+        const LegMapping_t *m = &leg_config->legs[leg - 1];
+        uint16_t *channels = (frame != NULL) ? servoFrameChannels(frame, m->device, m->base_channel) : NULL;
+        if (channels != NULL)
+        {
+            memcpy(channels, pwm[leg - 1], sizeof(pwm[0]));
+            servoFrameMarkLeg(frame, leg, m->device, m->base_channel, true);
+        }
+        else
+        {
+            // Pusta pula - noga od razu, jak poza ramką
+            ok = servoBusWrite(m->device, m->base_channel, pwm[leg - 1], 3) && ok;
+        }
+    }
+
+    if (frame != NULL)
+    {
+        ok = servoBusFlushFrame(frame) && ok;
+        servoFramePublish(frame);
+    }
+    return ok;
+}
+
+/**
+ * @brief Zaznacz limit ruchomych serw z maski i zatrzymaj je
+ */
+static uint8_t markServos(LegMask_t legs, uint8_t joints)
+{
+    uint8_t count = 0;
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        if (!(legs & LEG_BIT(leg)))
+            continue;
+
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            uint8_t bit = (uint8_t)(1U << j);
+            if (!(joints & bit) || !(moving[leg - 1] & bit))
+                continue;
+
+            if (phase_max)
+            {
+                found_max[leg - 1][j] = pwm[leg - 1][j];
+                marked_max[leg - 1] |= bit;
+            }
+            else
+            {
+                found_min[leg - 1][j] = pwm[leg - 1][j];
+                marked_min[leg - 1] |= bit;
+            }
+            moving[leg - 1] &= (uint8_t)~bit;
+            printf("KALIBRACJA: noga %d %-5s pwm_%s = %u\n", leg, joint_names[j],
+                   phase_max ? "max" : "min", pwm[leg - 1][j]);
+            count++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Ruchome serwa o @p steps kroków w stronę granicy (ujemne - cofnięcie)
+ */
+static void stepServos(int steps)
+{
+    const ServoCalibConfig_t *cfg = &servo_calib_config;
+    int delta = steps * (int)cfg->step_pwm * (phase_max ? 1 : -1);
+
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            if (!(moving[i] & (1U << j)))
+                continue;
+
+            int value = (int)pwm[i][j] + delta;
+            if (value < (int)cfg->floor_pwm)
+                value = cfg->floor_pwm;
+            if (value > (int)cfg->ceil_pwm)
+                value = cfg->ceil_pwm;
+            pwm[i][j] = (uint16_t)value;
+        }
+    }
+}
+
+/**
+ * @brief Ruchome serwa, które stały już na granicy - koniec bez zaznaczenia
+ */
+static void dropAtBound(void)
+{
+    const ServoCalibConfig_t *cfg = &servo_calib_config;
+    uint16_t bound = phase_max ? cfg->ceil_pwm : cfg->floor_pwm;
+
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            uint8_t bit = (uint8_t)(1U << j);
+            if ((moving[i] & bit) && pwm[i][j] == bound)
+            {
+                moving[i] &= (uint8_t)~bit;
+                printf("KALIBRACJA: noga %d %-5s doszła do %u bez zaznaczenia - stary limit\n",
+                       i + 1, joint_names[j], bound);
+            }
+        }
+    }
+}
+
+static void printStatus(void)
+{
+    if (!running)
+    {
+        printf("Kalibracja nieaktywna\n");
+        return;
+    }
+
+    printf("KALIBRACJA: faza %s%s\n", phase_max ? "MAX" : "MIN", paused ? " (wstrzymana)" : "");
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        if (!(servo_calib_config.legs & LEG_BIT(i + 1)))
+            continue;
+
+        printf("  noga %d:", i + 1);
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            uint8_t bit = (uint8_t)(1U << j);
+            printf("  %s %3u%s [", joint_names[j], pwm[i][j], (moving[i] & bit) ? "*" : " ");
+            if (marked_min[i] & bit)
+                printf("%3u", found_min[i][j]);
+            else
+                printf("  -");
+            if (marked_max[i] & bit)
+                printf("..%3u]", found_max[i][j]);
+            else
+                printf("..  -]");
+        }
+        printf("\n");
+    }
+}
+
+static int parseJoint(const char *name)
+{
+    for (int j = 0; j < 3; j++)
+    {
+        if (strcmp(name, joint_names[j]) == 0)
+            return j;
+    }
+    return -1;
+}
+
+static void cmdCalib(const char *args)
+{
+    if (!running || *args == '\0' || strcmp(args, "status") == 0)
+    {
+        printStatus();
+        return;
+    }
+
+    if (strncmp(args, "mark ", 5) == 0)
+    {
+        const char *target = args + 5;
+        LegMask_t legs = 0;
+        uint8_t joints = SERVO_CALIB_JOINTS_ALL;
+
+        if (strcmp(target, "all") == 0)
+        {
+            legs = servo_calib_config.legs;
+        }
+        else
+        {
+            char *end;
+            long leg = strtol(target, &end, 10);
+            while (*end == ' ')
+                end++;
+            int joint = (*end != '\0') ? parseJoint(end) : 0;
+            if (end == target || !legNumberValid((int)leg) || joint < 0)
+            {
+                printf("Użycie: calib mark all|<noga 1..%d> [hip|knee|ankle]\n", HEX_LEG_COUNT);
+                return;
+            }
+            legs = LEG_BIT(leg);
+            if (*end != '\0')
+                joints = (uint8_t)(1U << joint);
+        }
+
+        if (markServos(legs, joints) == 0)
+            printf("Żadne ruchome serwo nie pasuje\n");
+    }
+    else if (strncmp(args, "back", 4) == 0)
+    {
+        int steps = (args[4] == ' ') ? atoi(args + 5) : 1;
+        stepServos(-(steps > 0 ? steps : 1));
+        dirty = true;
+    }
+    else if (strcmp(args, "pause") == 0)
+        paused = true;
+    else if (strcmp(args, "go") == 0)
+        paused = false;
+    else if (strcmp(args, "skip") == 0)
+        skip_phase = true;
+    else if (strcmp(args, "abort") == 0)
+        abort_run = true;
+    else
+        printf("Użycie: calib [status|mark ...|back [n]|pause|go|skip|abort]\n");
+}
+
+/**
+ * @brief Jedna faza (MIN albo MAX) jednej grupy wzorca
+ */
+static void runPhase(LegMask_t legs, uint8_t joints, bool max)
+{
+    const ServoCalibConfig_t *cfg = &servo_calib_config;
+
+    phase_max = max;
+    paused = false;
+    skip_phase = false;
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        moving[leg - 1] = (legs & LEG_BIT(leg)) ? joints : 0;
+        for (uint8_t j = 0; j < 3; j++)
+            pwm[leg - 1][j] = cfg->center_pwm;
+    }
+
+    printf("KALIBRACJA: faza %s - 'calib mark ...', gdy serwo stoi na %s\n",
+           max ? "MAX" : "MIN", max ? "180°" : "0°");
+    writeLegs();
+    serialCmdWait(1000); // Dojazd ze środka poprzedniej fazy
+
+    uint32_t last = HAL_GetTick();
+    while (anyMoving() && !skip_phase && !abort_run)
+    {
+        serialCmdPoll();
+        if (servoEstopActive())
+        {
+            printf("❌ KALIBRACJA: stop awaryjny - przerwana\n");
+            abort_run = true;
+            break;
+        }
+
+        if (!paused && HAL_GetTick() - last >= cfg->dwell_ms)
+        {
+            last = HAL_GetTick();
+            dropAtBound();
+            stepServos(1);
+            dirty = true;
+        }
+        if (dirty)
+        {
+            dirty = false;
+            if (!writeLegs())
+                printf("⚠️  KALIBRACJA: błąd zapisu PWM\n");
+        }
+    }
+    memset(moving, 0, sizeof(moving));
+}
+
+/**
+ * @brief Zaznaczone limity -> kopia *leg_config -> jeden zapis do magazynu
+ */
+static bool commitLimits(bool persist, ServoCalibResult_t *r)
+{
+    LegConfig_t updated = *leg_config;
+
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            uint8_t bit = (uint8_t)(1U << j);
+            if (!((marked_min[i] | marked_max[i]) & bit))
+                continue;
+
+            ServoPwmLimits_t *limits = &updated.servo[i][j];
+            uint16_t new_min = (marked_min[i] & bit) ? found_min[i][j] : limits->pwm_min;
+            uint16_t new_max = (marked_max[i] & bit) ? found_max[i][j] : limits->pwm_max;
+            if (new_min >= new_max)
+            {
+                printf("⚠️  noga %d %-5s: %u..%u odrzucone - zostaje %u..%u\n", i + 1, joint_names[j],
+                       new_min, new_max, limits->pwm_min, limits->pwm_max);
+                r->rejected++;
+                continue;
+            }
+
+            printf("  noga %d %-5s: %3u..%3u -> %3u..%3u\n", i + 1, joint_names[j],
+                   limits->pwm_min, limits->pwm_max, new_min, new_max);
+            limits->pwm_min = new_min;
+            limits->pwm_max = new_max;
+            if (marked_min[i] & bit)
+                r->marked_min++;
+            if (marked_max[i] & bit)
+                r->marked_max++;
+        }
+    }
+
+    if (r->marked_min + r->marked_max == 0)
+    {
+        printf("Brak zaznaczonych limitów - konfiguracja bez zmian\n");
+        return true;
+    }
+    if (!persist)
+    {
+        return true;
+    }
+
+    r->saved = configParamsSave(CONFIG_TYPE_LEG_CONFIG, &updated);
+    printf("%s\n", r->saved ? "Zapisano do flash" : "❌ Zapis do flash nieudany");
+    return r->saved;
+}
+
+bool servoCalibRun(bool persist, ServoCalibResult_t *result)
+{
+    const ServoCalibConfig_t *cfg = &servo_calib_config;
+    ServoCalibResult_t r = {0};
+
+    // Grupy wzorca: nogi + stawy przemiatane razem
+    LegMask_t group_legs[3];
+    uint8_t group_joints[3];
+    uint8_t groups = 0;
+    switch (cfg->pattern)
+    {
+    case SERVO_CALIB_PATTERN_JOINT:
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            if (cfg->joints & (1U << j))
+            {
+                group_legs[groups] = cfg->legs;
+                group_joints[groups++] = (uint8_t)(1U << j);
+            }
+        }
+        break;
+    case SERVO_CALIB_PATTERN_TRIPOD:
+        for (uint8_t g = 0; g < 2; g++)
+        {
+            group_legs[groups] = 0;
+            for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+            {
+                if (robot_description.group[leg - 1] == g)
+                    group_legs[groups] |= LEG_BIT(leg) & cfg->legs;
+            }
+            group_joints[groups] = cfg->joints;
+            if (group_legs[groups] != 0)
+                groups++;
+        }
+        break;
+    default:
+        group_legs[0] = cfg->legs;
+        group_joints[0] = cfg->joints;
+        groups = 1;
+        break;
+    }
+
+    memset(marked_min, 0, sizeof(marked_min));
+    memset(marked_max, 0, sizeof(marked_max));
+    abort_run = false;
+    dirty = false;
+    running = true;
+    serialCmdRegister("calib", "kalibracja PWM: mark all|<noga> [staw], back, pause, go, skip, abort", cmdCalib);
+
+    printf("\n=== KALIBRACJA PWM: %u grup(y), %u..%u..%u krok %u co %lu ms ===\n",
+           groups, cfg->floor_pwm, cfg->center_pwm, cfg->ceil_pwm, cfg->step_pwm, cfg->dwell_ms);
+
+    for (uint8_t g = 0; g < groups && !abort_run; g++)
+    {
+        runPhase(group_legs[g], group_joints[g], false);
+        if (!abort_run)
+            runPhase(group_legs[g], group_joints[g], true);
+    }
+
+    running = false;
+    r.aborted = abort_run;
+    bool ok = false;
+    if (r.aborted)
+    {
+        printf("KALIBRACJA przerwana - konfiguracja bez zmian\n");
+    }
+    else
+    {
+        for (int i = 0; i < HEX_LEG_COUNT; i++)
+        {
+            for (uint8_t j = 0; j < 3; j++)
+                pwm[i][j] = cfg->center_pwm;
+        }
+        writeLegs();
+        printf("\n=== KALIBRACJA: wynik ===\n");
+        ok = commitLimits(persist, &r);
+    }
+
+    if (result != NULL)
+        *result = r;
+    return ok;
+}
+
+#endif // HEX_SERVO_CALIB
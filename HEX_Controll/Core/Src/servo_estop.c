@@ -0,0 +1,135 @@
+/*
+ * servo_estop.c - Awaryjne zwolnienie serw: OE + ALL_LED_OFF na każdym PCA, zatrzask zapisów
+ */
+
+#include "servo_estop.h"
+#include "servo_bus.h"
+#include "dwt_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+static PCA9685_Handle_t *fallback[2]; // pca1/pca2, gdy servo_bus pusty
+static ServoEstopStats_t stats;
+
+static void setOutputEnable(bool enabled)
+{
+#if SERVO_ESTOP_USE_OE
+    // OE aktywne niskie: wysoki stan = wyjścia PWM wyłączone
+    HAL_GPIO_WritePin(SERVO_ESTOP_OE_PORT, SERVO_ESTOP_OE_PIN, enabled ? GPIO_PIN_RESET : GPIO_PIN_SET);
+#else
+    (void)enabled;
+#endif
+}
+
+void servoEstopInit(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
+{
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    fallback[0] = pca1;
+    fallback[1] = pca2;
+    dwtTimerInit(); // Limit PCA9685_AllOffFromISR() w cyklach - przed włączeniem EXTI
+    PCA9685_LockOutputs(false);
+
+#if SERVO_ESTOP_USE_OE
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    HAL_GPIO_WritePin(SERVO_ESTOP_OE_PORT, SERVO_ESTOP_OE_PIN, GPIO_PIN_RESET);
+    GPIO_InitStruct.Pin = SERVO_ESTOP_OE_PIN;
+    GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(SERVO_ESTOP_OE_PORT, &GPIO_InitStruct);
+#endif
+
+    // B1 na Nucleo: PC13, zwiera do GND, pull-up na płytce
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    GPIO_InitStruct.Pin = GPIO_PIN_13;
+    GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, SERVO_ESTOP_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    if (GPIO_Pin == GPIO_PIN_13)
+    {
+        servoEstopTrigger();
+    }
+}
+
+void servoEstopTrigger(void)
+{
+    uint32_t start = dwtCycles();
+
+    // Zatrzask przed I2C - żaden zapis kanału z pętli głównej po powrocie z ISR już nie przejdzie
+    PCA9685_LockOutputs(true);
+    setOutputEnable(false);
+    stats.oe_us = SERVO_ESTOP_USE_OE ? dwtCyclesToUs(dwtCycles() - start) : 0;
+
+    uint32_t timeout = SERVO_ESTOP_TIMEOUT_US * (SystemCoreClock / 1000000U);
+    uint8_t count = servoBusDeviceCount();
+    if (count == 0)
+        count = 2;
+    if (count > SERVO_ESTOP_MAX_DEVICES)
+        count = SERVO_ESTOP_MAX_DEVICES;
+
+    bool all_ok = true;
+    for (uint8_t d = 0; d < count; d++)
+    {
+        PCA9685_Handle_t *pca = (servoBusDeviceCount() > 0) ? servoBusDevice(d) : fallback[d];
+        bool ok = PCA9685_AllOffFromISR(pca, timeout);
+        stats.device_ok[d] = ok;
+        stats.device_us[d] = dwtCyclesToUs(dwtCycles() - start);
+        all_ok = all_ok && ok;
+    }
+
+    stats.devices = count;
+    stats.total_us = dwtCyclesToUs(dwtCycles() - start);
+    if (stats.total_us > stats.worst_us)
+        stats.worst_us = stats.total_us;
+    stats.triggers++;
+    if (!all_ok)
+        stats.failures++;
+}
+
+void servoEstopRelease(void)
+{
+    setOutputEnable(true);
+    PCA9685_LockOutputs(false);
+}
+
+bool servoEstopActive(void)
+{
+    return PCA9685_OutputsLocked();
+}
+
+void servoEstopGetStats(ServoEstopStats_t *out)
+{
+    __disable_irq();
+    *out = stats;
+    __enable_irq();
+}
+
+void servoEstopReport(void)
+{
+    ServoEstopStats_t s;
+    servoEstopGetStats(&s);
+
+    printf("\n=== STOP AWARYJNY: %s ===\n", servoEstopActive() ? "AKTYWNY (zapisy kanałów zablokowane)" : "zwolniony");
+    printf("Wyzwolenia: %lu, nieudane: %lu, OE: %s\n", s.triggers, s.failures,
+           SERVO_ESTOP_USE_OE ? "sterowane" : "brak");
+    if (s.triggers == 0)
+    {
+        return;
+    }
+
+    if (SERVO_ESTOP_USE_OE)
+        printf("  OE wysoko po %lu us\n", s.oe_us);
+    for (uint8_t d = 0; d < s.devices; d++)
+    {
+        printf("  PCA %u: ALL_LED_OFF %s po %lu us\n", d, s.device_ok[d] ? "OK" : "BŁĄD", s.device_us[d]);
+    }
+    printf("  Całość: %lu us (najgorzej %lu us)\n", s.total_us, s.worst_us);
+}
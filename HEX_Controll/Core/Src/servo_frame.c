@@ -0,0 +1,102 @@
+/*
+ * servo_frame.c - Pula ramek PWM z dzierżawami zapisującego i czytelników
+ */
+
+#include "servo_frame.h"
+#include "mem_arena.h"
+#include <string.h>
+
+MEM_POOL_DEFINE(frame_pool, "servo_frame", ServoFrame_t, SERVO_FRAME_POOL_SIZE);
+
+static ServoFrame_t *latest; // Ostatnia opublikowana - dzierżawa modułu
+static uint32_t next_seq;
+
+ServoFrame_t *servoFrameAcquire(void)
+{
+    ServoFrame_t *frame = MEM_POOL_NEW(&frame_pool, ServoFrame_t);
+    if (frame == NULL)
+    {
+        return NULL;
+    }
+
+    // Obraz kanałów zostaje nieokreślony - czytane tylko kanały z pending/leg_slot
+    frame->seq = next_seq++;
+    memset(frame->pending, 0, sizeof(frame->pending));
+    memset(frame->leg_slot, SERVO_FRAME_NO_SLOT, sizeof(frame->leg_slot));
+    frame->legs = 0;
+    frame->bus_err = 0;
+    frame->leases = 1;
+    frame->published = false;
+    return frame;
+}
+
+uint16_t *servoFrameChannels(ServoFrame_t *frame, uint8_t device, uint8_t channel)
+{
+    if (frame->published || device >= SERVO_FRAME_DEVICES || channel + 3 > SERVO_FRAME_CHANNELS)
+    {
+        return NULL;
+    }
+    return &frame->pwm[device][channel];
+}
+
+void servoFrameMarkLeg(ServoFrame_t *frame, int leg_number, uint8_t device, uint8_t channel, bool pending)
+{
+    if (frame->published || !legNumberValid(leg_number) ||
+        device >= SERVO_FRAME_DEVICES || channel + 3 > SERVO_FRAME_CHANNELS)
+    {
+        return;
+    }
+
+    frame->leg_slot[leg_number - 1] = (uint8_t)(device * SERVO_FRAME_CHANNELS + channel);
+    frame->legs |= LEG_BIT(leg_number);
+    if (pending)
+        frame->pending[device] |= (uint16_t)(0x7U << channel);
+}
+
+const uint16_t *servoFrameLegPwm(const ServoFrame_t *frame, int leg_number)
+{
+    if (!legNumberValid(leg_number) || !(frame->legs & LEG_BIT(leg_number)))
+    {
+        return NULL;
+    }
+    uint8_t slot = frame->leg_slot[leg_number - 1];
+    return &frame->pwm[slot / SERVO_FRAME_CHANNELS][slot % SERVO_FRAME_CHANNELS];
+}
+
+const ServoFrame_t *servoFrameLease(const ServoFrame_t *frame)
+{
+    // Licznik dzierżaw nie jest częścią danych tylko do odczytu
+    ((ServoFrame_t *)frame)->leases++;
+    return frame;
+}
+
+void servoFrameRelease(const ServoFrame_t *frame)
+{
+    ServoFrame_t *f = (ServoFrame_t *)frame;
+    if (f == NULL || f->leases == 0)
+    {
+        return;
+    }
+    if (--f->leases == 0)
+        memPoolFree(&frame_pool, f);
+}
+
+void servoFramePublish(ServoFrame_t *frame)
+{
+    frame->published = true;
+
+    // Dzierżawa zapisującego przechodzi na "ostatnią"; poprzednia oddana
+    ServoFrame_t *previous = latest;
+    latest = frame;
+    servoFrameRelease(previous);
+}
+
+const ServoFrame_t *servoFrameLeaseLatest(void)
+{
+    return (latest != NULL) ? servoFrameLease(latest) : NULL;
+}
+
+uint32_t servoFrameAcquireFails(void)
+{
+    return frame_pool.fails;
+}
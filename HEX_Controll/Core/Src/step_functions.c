@@ -44,7 +44,7 @@ static float lerp(float start, float end, float t)
  * 4. Powrót do pozycji bazowej (opcjonalnie)
  *
  * @param pca: Uchwyt PCA9685
- * @param leg_number: Numer nogi (1-6)
+ * @param leg_number: Numer nogi (1..HEX_LEG_COUNT)
  * @param step_length: Długość kroku [cm]
  * @param lift_height: Wysokość podniesienia [cm]
  * @param step_duration_ms: Czas całego kroku [ms]
@@ -55,7 +55,7 @@ bool testSingleStep(PCA9685_Handle_t *pca, int leg_number,
                     float step_length, float lift_height,
                     uint32_t step_duration_ms, int num_points)
 {
-    if (leg_number < 1 || leg_number > 6 || num_points < 10)
+    if (!legNumberValid(leg_number) || num_points < 10)
     {
         printf("Błędne parametry kroku!\n");
         return false;
@@ -67,40 +67,10 @@ bool testSingleStep(PCA9685_Handle_t *pca, int leg_number,
     printf("Czas kroku: %lu ms\n", step_duration_ms);
     printf("Punkty interpolacji: %d\n", num_points);
 
-    // Pozycja bazowa dla nogi (z ROS)
-    float base_x, base_y, base_z = -24.0f; // Sprawdzona wysokość
-
-    // Ustaw pozycje bazowe na podstawie numeru nogi
-    switch (leg_number)
-    {
-    case 1:
-        base_x = 18.0f;
-        base_y = -15.0f;
-        break; // Lewa przednia
-    case 2:
-        base_x = -18.0f;
-        base_y = -15.0f;
-        break; // Prawa przednia
-    case 3:
-        base_x = 22.0f;
-        base_y = 0.0f;
-        break; // Lewa środkowa
-    case 4:
-        base_x = -22.0f;
-        base_y = 0.0f;
-        break; // Prawa środkowa
-    case 5:
-        base_x = 18.0f;
-        base_y = 15.0f;
-        break; // Lewa tylna
-    case 6:
-        base_x = -18.0f;
-        base_y = 15.0f;
-        break; // Prawa tylna
-    default:
-        printf("Nieprawidłowy numer nogi!\n");
-        return false;
-    }
+    // Pozycja bazowa dla nogi (z ROS, robot_description.h)
+    float base_x = robot_description.stance_x[leg_number - 1];
+    float base_y = robot_description.stance_y[leg_number - 1];
+    float base_z = ROBOT_STANCE_Z; // Sprawdzona wysokość
 
     printf("Pozycja bazowa: (%.1f, %.1f, %.1f)\n", base_x, base_y, base_z);
 
@@ -29,6 +29,11 @@
  */
 static uint8_t *__sbrk_heap_end = NULL;
 
+/**
+ * Highest heap end ever returned by _sbrk (for mem_monitor.c)
+ */
+static uint8_t *__sbrk_heap_peak = NULL;
+
 /**
  * @brief _sbrk() allocates memory to the newlib heap and is used by malloc
  *        and others from the C library
@@ -75,5 +80,30 @@ void *_sbrk(ptrdiff_t incr)
   prev_heap_end = __sbrk_heap_end;
   __sbrk_heap_end += incr;
 
+  if (__sbrk_heap_end > __sbrk_heap_peak)
+  {
+    __sbrk_heap_peak = __sbrk_heap_end;
+  }
+
   return (void *)prev_heap_end;
 }
+
+/**
+ * @brief Current heap end (first byte above the newlib heap)
+ * @return '_end' if the heap has not been used yet
+ */
+uint8_t *_sbrk_heap_end(void)
+{
+  extern uint8_t _end; /* Symbol defined in the linker script */
+  return (NULL == __sbrk_heap_end) ? &_end : __sbrk_heap_end;
+}
+
+/**
+ * @brief Highest heap end reached since reset
+ * @return '_end' if the heap has not been used yet
+ */
+uint8_t *_sbrk_heap_peak(void)
+{
+  extern uint8_t _end; /* Symbol defined in the linker script */
+  return (NULL == __sbrk_heap_peak) ? &_end : __sbrk_heap_peak;
+}
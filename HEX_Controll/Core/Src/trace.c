@@ -0,0 +1,112 @@
+/*
+ * trace.c - Bufor zdarzeń czasowych pętli sterowania
+ *
+ * Zdarzenia zapisywane są makrami TRACE_BEGIN/END (trace.h),
+ * tutaj tylko sterowanie nagrywaniem i zrzut przez UART.
+ */
+
+#include "trace.h"
+#include "stm32f4xx_hal.h"
+#include <stdio.h>
+
+static const char *const trace_event_names[TRACE_EV_COUNT] = {
+    [TRACE_EV_FRAME] = "frame",
+    [TRACE_EV_PHASE] = "phase",
+    [TRACE_EV_IK] = "ik",
+    [TRACE_EV_MAPPING] = "mapping",
+    [TRACE_EV_I2C1] = "i2c1",
+    [TRACE_EV_I2C2] = "i2c2",
+    [TRACE_EV_DELAY] = "delay",
+    [TRACE_EV_IMU] = "imu",
+};
+
+#if HEX_TRACE_ENABLE
+
+TraceEvent_t trace_buffer[TRACE_BUFFER_SIZE];
+volatile uint32_t trace_head = 0;
+volatile bool trace_active = false;
+bool trace_ring = false;
+
+void traceStart(bool ring)
+{
+    dwtTimerInit();
+    trace_active = false;
+    trace_head = 0;
+    trace_ring = ring;
+    trace_active = true;
+}
+
+void traceStop(void)
+{
+    trace_active = false;
+}
+
+void traceDump(void)
+{
+    bool was_active = trace_active;
+    trace_active = false;
+
+    uint32_t head = trace_head;
+    uint32_t count = (head > TRACE_BUFFER_SIZE) ? TRACE_BUFFER_SIZE : head;
+    uint32_t first = head - count;
+    uint32_t dropped = trace_ring ? first : 0;
+
+    printf("#TRACE v1 cpu_hz=%lu events=%lu dropped=%lu\n",
+           SystemCoreClock, count, dropped);
+    for (int i = 0; i < TRACE_EV_COUNT; i++)
+    {
+        printf("#NAME %d %s\n", i, trace_event_names[i]);
+    }
+
+    for (uint32_t i = first; i < head; i++)
+    {
+        const TraceEvent_t *ev = &trace_buffer[i % TRACE_BUFFER_SIZE];
+        printf("E %lu %c %u %u\n", ev->cycles, ev->phase, ev->id, ev->arg);
+    }
+    printf("#END\n");
+
+    trace_active = was_active;
+}
+
+/**
+ * @brief HAL_Delay z zapisem zdarzenia delay (nadpisuje __weak z HAL)
+ *
+ * Implementacja identyczna z stm32f4xx_hal.c, dodane tylko TRACE_*.
+ */
+void HAL_Delay(uint32_t Delay)
+{
+    TRACE_BEGIN(TRACE_EV_DELAY, Delay);
+
+    uint32_t tickstart = HAL_GetTick();
+    uint32_t wait = Delay;
+
+    if (wait < HAL_MAX_DELAY)
+    {
+        wait += (uint32_t)(uwTickFreq);
+    }
+
+    while ((HAL_GetTick() - tickstart) < wait)
+    {
+    }
+
+    TRACE_END(TRACE_EV_DELAY, Delay);
+}
+
+#else
+
+void traceStart(bool ring)
+{
+    (void)ring;
+}
+
+void traceStop(void)
+{
+}
+
+void traceDump(void)
+{
+    (void)trace_event_names;
+    printf("Trace wyłączony (zbuduj z HEX_TRACE_ENABLE=1)\n");
+}
+
+#endif // HEX_TRACE_ENABLE
@@ -2,9 +2,10 @@
  * tripod_gait.c - Tripod gait dla hexapoda
  *
  * Tripod = najbardziej stabilny chód hexapoda
- * - Zawsze 3 nogi na ziemi (trójkąt stabilności)
- * - Grupa A: nogi 1,4,5 (lewa przednia, prawa środkowa, lewa tylna)
- * - Grupa B: nogi 2,3,6 (prawa przednia, lewa środkowa, prawa tylna)
+ * - Zawsze połowa nóg na ziemi (trójkąt stabilności)
+ * - Grupy z robot_description.h - domyślnie:
+ *   Grupa A: nogi 1,4,5 (lewa przednia, prawa środkowa, lewa tylna)
+ *   Grupa B: nogi 2,3,6 (prawa przednia, lewa środkowa, prawa tylna)
  *
  * Fazy:
  * 1. Grupa A robi SWING (krok do przodu) + Grupa B robi STANCE (przesuw robota)
@@ -14,6 +15,20 @@
 #include "tripod_gait.h"
 #include <stdio.h>
 #include <math.h>
+#include "trace.h"
+#include "leg_output.h"
+#include "control_frame.h"
+#include "foot_contact.h"
+#include "metrics.h"
+#include "serial_cmd.h"
+#include "leg_torque.h"
+#include "joint_interp.h"
+#include "body_leveling.h"
+#include "flight_rec.h"
+#include <string.h>
+#include "hot_path.h"
+#include "robot_description.h"
+#include "mem_arena.h"
 
 // Konfiguracja tripod gait - BEZPIECZNE CZASY Z DUŻĄ PŁYNNOŚCIĄ
 TripodConfig_t tripod_config = {
@@ -21,37 +36,28 @@ TripodConfig_t tripod_config = {
     .lift_height = 4.0f,       // Wysokość podniesienia [cm]
     .swing_duration_ms = 150,  // 150ms swing - BEZPIECZNE dla serw
     .stance_duration_ms = 150, // 150ms stance - BEZPIECZNE dla serw
-    .swing_points = 150,       // DUŻO punktów dla płynności
-    .stance_points = 150,      // DUŻO punktów dla płynności
+    .swing_points = 30,        // Punkty na fazę przy kadencji - ramka co 150/30 = 5 ms
+    .stance_points = 30,       // Fazy równoczesne - jak swing_points
     .step_height_base = -24.0f // Bazowa wysokość stania [cm]
 };
 
-// Pozycje bazowe nóg - PRZYWRÓCONE ORYGINALNE z ROS
-static const float base_positions[6][3] = {
-    {18.0f, -15.0f, -24.0f},  // Noga 1 - lewa przednia (przywrócone)
-    {-18.0f, -15.0f, -24.0f}, // Noga 2 - prawa przednia (przywrócone)
-    {22.0f, 0.0f, -24.0f},    // Noga 3 - lewa środkowa (bez zmian)
-    {-22.0f, 0.0f, -24.0f},   // Noga 4 - prawa środkowa (bez zmian)
-    {18.0f, 15.0f, -24.0f},   // Noga 5 - lewa tylna (bez zmian)
-    {-18.0f, 15.0f, -24.0f}   // Noga 6 - prawa tylna (bez zmian)
-};
+// Aktywna konfiguracja - RAM lub rekord z config_store (configParamsLoad)
+const TripodConfig_t *tripod_cfg = &tripod_config;
 
-// Mapowanie kanałów PCA9685 z offsetami biodra z URDF
-typedef struct
-{
-    uint8_t base_channel; // Bazowy kanał (hip = base, knee = base+1, ankle = base+2)
-    float hip_offset_deg; // Offset biodra [stopnie] - Z URDF JOINT LIMITS
-    bool is_left_side;    // true = I2C1 (lewe nogi), false = I2C2 (prawe nogi)
-} LegMapping_t;
-
-static const LegMapping_t leg_mapping[6] = {
-    {0, 37.5f, true},   // Noga 1: I2C1, kanały 0-2, offset +37.5°
-    {0, -37.5f, false}, // Noga 2: I2C2, kanały 0-2, offset -37.5°
-    {3, 0.0f, true},    // Noga 3: I2C1, kanały 3-5, bez offsetu - TWOJA TESTOWA
-    {3, 0.0f, false},   // Noga 4: I2C2, kanały 3-5, bez offsetu
-    {6, -37.5f, true},  // Noga 5: I2C1, kanały 6-8, offset -37.5°
-    {6, 37.5f, false}   // Noga 6: I2C2, kanały 6-8, offset +37.5°
-};
+// Krok bieżącego cyklu - tripod_cfg->step_length albo mniej po planowaniu momentów
+static float cycle_step_length;
+static TripodDirection_t cycle_direction;
+
+// Tory kątów nóg w bieżącej fazie (joint_interp.h) i ich stride - w arenie chodu
+static JointTrack_t *leg_tracks;
+static uint8_t swing_stride = 1;
+static uint8_t stance_stride = 1;
+
+// Linia z kątami każdej nogi w każdej ramce (~8 ms na UART na nogę)
+static bool tripod_verbose = true;
+
+// Kadencja z konfiguracji - domyślnie stałe punkty bez pauzy
+static bool tripod_paced = HEX_TRIPOD_PACED;
 
 /**
  * @brief Interpolacja kubiczna (smooth step)
@@ -73,78 +79,16 @@ static float lerp(float start, float end, float t)
     return start + (end - start) * t;
 }
 
-/**
- * @brief Ustaw kanały serw dla nogi z offsetem biodra
- */
-static void setLegJointsWithOffset(int leg_number, float q1, float q2, float q3,
-                                   PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
-{
-    if (leg_number < 1 || leg_number > 6)
-    {
-        printf("❌ Nieprawidłowy numer nogi: %d\n", leg_number);
-        return;
-    }
-
-    // Pobierz mapowanie dla nogi
-    const LegMapping_t *mapping = &leg_mapping[leg_number - 1];
-
-    // Wybierz odpowiednią PCA
-    PCA9685_Handle_t *pca_to_use = mapping->is_left_side ? pca1 : pca2;
-
-    if (pca_to_use == NULL)
-    {
-        printf("⚠️  PCA dla nogi %d niedostępne (kanały %d-%d)\n",
-               leg_number, mapping->base_channel, mapping->base_channel + 2);
-        return;
-    }
-
-    // Konwersja radianów na stopnie z offsetem
-    float hip_deg = (q1 * 180.0f / M_PI) + mapping->hip_offset_deg;
-    float knee_deg = q2 * 180.0f / M_PI;
-    float ankle_deg = q3 * 180.0f / M_PI;
-
-    // USUNIĘTO INWERSJĘ KOLAN - wszystkie nogi mają ten sam kierunek
-
-    // Mapowanie na pozycje serw (90° = neutralne)
-    float servo_hip = 90.0f + hip_deg;
-    float servo_knee = 90.0f + knee_deg;
-    float servo_ankle = 90.0f + ankle_deg;
-
-    // Ograniczenia serw
-    if (servo_hip < 0.0f)
-        servo_hip = 0.0f;
-    if (servo_hip > 180.0f)
-        servo_hip = 180.0f;
-    if (servo_knee < 0.0f)
-        servo_knee = 0.0f;
-    if (servo_knee > 180.0f)
-        servo_knee = 180.0f;
-    if (servo_ankle < 0.0f)
-        servo_ankle = 0.0f;
-    if (servo_ankle > 180.0f)
-        servo_ankle = 180.0f;
-
-    printf("Noga %d [kanały %d-%d]: IK[%.1f°, %.1f°, %.1f°] + offset[%.1f°] -> Servo[%.1f°, %.1f°, %.1f°]\n",
-           leg_number, mapping->base_channel, mapping->base_channel + 2,
-           hip_deg - mapping->hip_offset_deg, knee_deg, ankle_deg, mapping->hip_offset_deg,
-           servo_hip, servo_knee, servo_ankle);
-
-    // Ustaw serwa
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 0, servo_hip);   // Hip
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 1, servo_knee);  // Knee
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 2, servo_ankle); // Ankle
-}
-
 /**
  * @brief Oblicz docelową pozycję dla kroku w danym kierunku
  */
-static void calculateTargetPosition(int leg_number, TripodDirection_t direction,
-                                    float *target_x, float *target_y, float *target_z)
+HOT_FUNC static void calculateTargetPosition(int leg_number, TripodDirection_t direction, float step_length,
+                                             float *target_x, float *target_y, float *target_z)
 {
-    // Pozycja bazowa
-    float base_x = base_positions[leg_number - 1][0];
-    float base_y = base_positions[leg_number - 1][1];
-    float base_z = base_positions[leg_number - 1][2];
+    // Pozycja bazowa (robot_description.h)
+    float base_x = robot_description.stance_x[leg_number - 1];
+    float base_y = robot_description.stance_y[leg_number - 1];
+    float base_z = ROBOT_STANCE_Z;
 
     *target_x = base_x;
     *target_y = base_y;
@@ -154,38 +98,24 @@ static void calculateTargetPosition(int leg_number, TripodDirection_t direction,
     switch (direction)
     {
     case TRIPOD_FORWARD:
-        *target_y = base_y - tripod_config.step_length; // Do przodu (Y-)
+        *target_y = base_y - step_length; // Do przodu (Y-)
         break;
     case TRIPOD_BACKWARD:
-        *target_y = base_y + tripod_config.step_length; // Do tyłu (Y+)
+        *target_y = base_y + step_length; // Do tyłu (Y+)
         break;
     case TRIPOD_LEFT:
-        *target_x = base_x + tripod_config.step_length; // W lewo (X+)
+        *target_x = base_x + step_length; // W lewo (X+)
         break;
     case TRIPOD_RIGHT:
-        *target_x = base_x - tripod_config.step_length; // W prawo (X-)
+        *target_x = base_x - step_length; // W prawo (X-)
         break;
     case TRIPOD_TURN_LEFT:
-        // Obrót w lewo - przednie nogi w lewo, tylne w prawo
-        if (leg_number == 1 || leg_number == 2)
-        {
-            *target_x = base_x + tripod_config.step_length; // Przednie w lewo
-        }
-        else if (leg_number == 5 || leg_number == 6)
-        {
-            *target_x = base_x - tripod_config.step_length; // Tylne w prawo
-        }
+        // Obrót w lewo - przednie nogi (rząd -1) w lewo, tylne (rząd 1) w prawo, środkowe w miejscu
+        *target_x = base_x - (float)robotLegRow(leg_number) * step_length;
         break;
     case TRIPOD_TURN_RIGHT:
         // Obrót w prawo - przednie nogi w prawo, tylne w lewo
-        if (leg_number == 1 || leg_number == 2)
-        {
-            *target_x = base_x - tripod_config.step_length; // Przednie w prawo
-        }
-        else if (leg_number == 5 || leg_number == 6)
-        {
-            *target_x = base_x + tripod_config.step_length; // Tylne w lewo
-        }
+        *target_x = base_x + (float)robotLegRow(leg_number) * step_length;
         break;
     default:
         break;
@@ -193,144 +123,347 @@ static void calculateTargetPosition(int leg_number, TripodDirection_t direction,
 }
 
 /**
- * @brief Wykonaj jeden punkt swing phase dla nogi
+ * @brief Oblicz tylną pozycję stopy (koniec stance, początek swing)
  */
-static void executeSwingPoint(int leg_number, TripodDirection_t direction,
-                              float t, float smooth_t, PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
+HOT_FUNC static void calculateRearPosition(int leg_number, TripodDirection_t direction, float step_length,
+                                           float *rear_x, float *rear_y)
 {
-    float base_x = base_positions[leg_number - 1][0];
-    float base_y = base_positions[leg_number - 1][1];
-    float base_z = base_positions[leg_number - 1][2];
+    float base_x = robot_description.stance_x[leg_number - 1];
+    float base_y = robot_description.stance_y[leg_number - 1];
 
-    // Pozycja startowa (tylna)
-    float start_x = base_x;
-    float start_y = base_y;
+    *rear_x = base_x;
+    *rear_y = base_y;
 
     switch (direction)
     {
     case TRIPOD_FORWARD:
-        start_y = base_y + tripod_config.step_length;
+        *rear_y = base_y + step_length;
         break;
     case TRIPOD_BACKWARD:
-        start_y = base_y - tripod_config.step_length;
+        *rear_y = base_y - step_length;
         break;
     case TRIPOD_LEFT:
-        start_x = base_x - tripod_config.step_length;
+        *rear_x = base_x - step_length;
         break;
     case TRIPOD_RIGHT:
-        start_x = base_x + tripod_config.step_length;
+        *rear_x = base_x + step_length;
         break;
     case TRIPOD_TURN_LEFT:
-        if (leg_number == 1 || leg_number == 2)
-        {
-            start_x = base_x - tripod_config.step_length;
-        }
-        else if (leg_number == 5 || leg_number == 6)
-        {
-            start_x = base_x + tripod_config.step_length;
-        }
+        *rear_x = base_x + (float)robotLegRow(leg_number) * step_length;
         break;
     case TRIPOD_TURN_RIGHT:
-        if (leg_number == 1 || leg_number == 2)
-        {
-            start_x = base_x + tripod_config.step_length;
-        }
-        else if (leg_number == 5 || leg_number == 6)
-        {
-            start_x = base_x - tripod_config.step_length;
-        }
+        *rear_x = base_x - (float)robotLegRow(leg_number) * step_length;
         break;
     default:
         break;
     }
+}
+
+/**
+ * @brief Pozycja stopy na łuku swing (t liniowe 0..1)
+ */
+HOT_FUNC static void swingFoot(int leg_number, float t, float foot[3])
+{
+    float base_z = ROBOT_STANCE_Z;
+    float smooth_t = cubicInterpolation(t);
+
+    // Pozycja startowa (tylna)
+    float start_x, start_y;
+    calculateRearPosition(leg_number, cycle_direction, cycle_step_length, &start_x, &start_y);
 
     // Pozycja docelowa (przednia)
     float target_x, target_y, target_z;
-    calculateTargetPosition(leg_number, direction, &target_x, &target_y, &target_z);
+    calculateTargetPosition(leg_number, cycle_direction, cycle_step_length, &target_x, &target_y, &target_z);
 
     // Interpolacja pozycji
-    float current_x = lerp(start_x, target_x, smooth_t);
-    float current_y = lerp(start_y, target_y, smooth_t);
+    foot[0] = lerp(start_x, target_x, smooth_t);
+    foot[1] = lerp(start_y, target_y, smooth_t);
 
-    // Trajektoria łuku
-    float arc_height = 4.0f * tripod_config.lift_height * t * (1.0f - t);
-    float current_z = base_z - arc_height;
-
-    // Oblicz IK i ustaw serwa
-    float q1, q2, q3;
-    if (computeLegIK(leg_number, current_x, current_y, current_z, &q1, &q2, &q3))
-    {
-        setLegJointsWithOffset(leg_number, q1, q2, q3, pca1, pca2);
-    }
+    // Trajektoria łuku - start z wysokości podłoża z poprzedniego przyziemienia
+    float arc_height = 4.0f * tripod_cfg->lift_height * t * (1.0f - t);
+    foot[2] = lerp(footSwingStartZ(leg_number, base_z), base_z, smooth_t) - arc_height;
 }
 
 /**
- * @brief Wykonaj jeden punkt stance phase dla nogi
+ * @brief Pozycja stopy w fazie stance (t liniowe 0..1)
  */
-static void executeStancePoint(int leg_number, TripodDirection_t direction,
-                               float t, float smooth_t, PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
+HOT_FUNC static void stanceFoot(int leg_number, float t, float foot[3])
 {
-    float base_x = base_positions[leg_number - 1][0];
-    float base_y = base_positions[leg_number - 1][1];
-    float base_z = base_positions[leg_number - 1][2];
+    float base_z = ROBOT_STANCE_Z;
+    float smooth_t = cubicInterpolation(t);
 
     // Pozycja startowa (przednia)
     float start_x, start_y, start_z;
-    calculateTargetPosition(leg_number, direction, &start_x, &start_y, &start_z);
+    calculateTargetPosition(leg_number, cycle_direction, cycle_step_length, &start_x, &start_y, &start_z);
 
     // Pozycja końcowa (tylna)
-    float end_x = base_x;
-    float end_y = base_y;
+    float end_x, end_y;
+    calculateRearPosition(leg_number, cycle_direction, cycle_step_length, &end_x, &end_y);
 
-    switch (direction)
+    // Interpolacja pozycji (po ziemi)
+    foot[0] = lerp(start_x, end_x, smooth_t);
+    foot[1] = lerp(start_y, end_y, smooth_t);
+    foot[2] = footGroundZ(leg_number, base_z); // Zawsze na ziemi (zmierzonej przy przyziemieniu)
+}
+
+/**
+ * @brief Jeden punkt fazy dla grupy nóg: kąty z toru albo IK całej partii
+ *
+ * Nogi z ważnym torem interpolacji dostają kąty od razu, pozostałe idą
+ * jednym computeLegIKBatch() (legOutputMoveFeet()).
+ */
+HOT_FUNC static void outputGroup(const int legs[], int count, bool swing, int point, float t,
+                                 PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
+{
+    LegIKBatch_t batch;
+    batch.count = 0;
+
+    for (int i = 0; i < count; i++)
     {
-    case TRIPOD_FORWARD:
-        end_y = base_y + tripod_config.step_length;
-        break;
-    case TRIPOD_BACKWARD:
-        end_y = base_y - tripod_config.step_length;
-        break;
-    case TRIPOD_LEFT:
-        end_x = base_x - tripod_config.step_length;
-        break;
-    case TRIPOD_RIGHT:
-        end_x = base_x + tripod_config.step_length;
-        break;
-    case TRIPOD_TURN_LEFT:
-        if (leg_number == 1 || leg_number == 2)
+        int leg = legs[i];
+        float foot[3], q[3];
+
+        if (swing)
         {
-            end_x = base_x - tripod_config.step_length;
+            legOutputMarkSwing(leg);
+            swingFoot(leg, t, foot);
+
+            // Po kontakcie stopa nie schodzi niżej - faza trwa dalej razem ze stance drugiej grupy
+            footSwingUpdate(leg, t, &foot[2]);
         }
-        else if (leg_number == 5 || leg_number == 6)
+        else
         {
-            end_x = base_x + tripod_config.step_length;
+            stanceFoot(leg, t, foot);
         }
-        break;
-    case TRIPOD_TURN_RIGHT:
-        if (leg_number == 1 || leg_number == 2)
+
+        if (jointTrackSample(&leg_tracks[leg - 1], (uint16_t)point, q))
+        {
+            flightRecFoot(leg, foot[0], foot[1], foot[2]);
+            legOutputSetJoints(leg, q[0], q[1], q[2], pca1, pca2, tripod_verbose);
+            continue;
+        }
+
+        batch.leg[batch.count] = (uint8_t)leg;
+        batch.x[batch.count] = foot[0];
+        batch.y[batch.count] = foot[1];
+        batch.z[batch.count] = foot[2];
+        batch.count++;
+    }
+
+    if (batch.count > 0)
+    {
+        legOutputMoveFeet(&batch, pca1, pca2, tripod_verbose);
+    }
+}
+
+/**
+ * @brief Dobierz stride interpolacji stawów dla obu torów (wynik zapamiętany)
+ *
+ * Granica błędu sprawdzana na torach z bieżącym krokiem i podłożem;
+ * wynik to najmniejszy stride po wszystkich nogach.
+ */
+static void planInterpolation(int points)
+{
+    static bool cached = false;
+    static TripodDirection_t cached_direction;
+    static float cached_step;
+    static int cached_points;
+    static JointInterpConfig_t cached_cfg;
+
+    if (cached && cached_direction == cycle_direction && cached_step == cycle_step_length &&
+        cached_points == points && memcmp(&cached_cfg, &joint_interp_config, sizeof(cached_cfg)) == 0)
+    {
+        return;
+    }
+
+    float swing_err = 0.0f, stance_err = 0.0f;
+    swing_stride = stance_stride = UINT8_MAX;
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        float err;
+        uint8_t stride = jointInterpPlanStride(leg, swingFoot, (uint16_t)points, &err);
+        if (stride < swing_stride)
+            swing_stride = stride;
+        if (err > swing_err)
+            swing_err = err;
+
+        stride = jointInterpPlanStride(leg, stanceFoot, (uint16_t)points, &err);
+        if (stride < stance_stride)
+            stance_stride = stride;
+        if (err > stance_err)
+            stance_err = err;
+    }
+
+    printf("Interpolacja stawów: IK co %u (swing) / %u (stance) punktów, błąd %.2f / %.2f mm\n",
+           swing_stride, stance_stride, swing_err * 10.0f, stance_err * 10.0f);
+
+    cached = true;
+    cached_direction = cycle_direction;
+    cached_step = cycle_step_length;
+    cached_points = points;
+    memcpy(&cached_cfg, &joint_interp_config, sizeof(cached_cfg));
+}
+
+/**
+ * @brief Przygotuj tory nóg na fazę
+ *
+ * Poziomowanie zmienia cel stopy z ramki na ramkę, a czujnik kontaktu
+ * przycina łuk swing - wtedy pełne IK w każdym punkcie.
+ */
+static void beginPhaseTracks(uint8_t swing_group, int points)
+{
+    bool leveling = bodyLevelingEnabled();
+    bool swing_interp = swing_stride > 1 && !leveling &&
+                        footContactGetSource() == FOOT_CONTACT_SOURCE_NONE;
+    bool stance_interp = stance_stride > 1 && !leveling;
+
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        JointTrack_t *track = &leg_tracks[leg - 1];
+        if (robot_description.group[leg - 1] == swing_group)
         {
-            end_x = base_x + tripod_config.step_length;
+            jointTrackBegin(track, leg, swingFoot, (uint16_t)points, swing_stride);
+            track->valid = track->valid && swing_interp;
         }
-        else if (leg_number == 5 || leg_number == 6)
+        else
         {
-            end_x = base_x - tripod_config.step_length;
+            jointTrackBegin(track, leg, stanceFoot, (uint16_t)points, stance_stride);
+            track->valid = track->valid && stance_interp;
         }
-        break;
-    default:
-        break;
     }
+}
 
-    // Interpolacja pozycji (po ziemi)
-    float current_x = lerp(start_x, end_x, smooth_t);
-    float current_y = lerp(start_y, end_y, smooth_t);
-    float current_z = base_z; // Zawsze na ziemi
+/**
+ * @brief Oceń momenty w stawach nóg podporowych obu faz dla danego kroku
+ */
+static void evaluateStanceTorque(TripodDirection_t direction, float step_length, LegTorqueReport_t *report)
+{
+    int samples = (leg_torque_config.samples < 2) ? 2 : leg_torque_config.samples;
+
+    legTorqueReportInit(report);
+    for (int phase = 0; phase < 2; phase++)
+    {
+        // Stance w fazie 1 to grupa B, w fazie 2 grupa A
+        int legs[HEX_LEG_COUNT];
+        int n = robotGroupLegs((uint8_t)(1 - phase), legs);
+
+        for (int k = 0; k < samples; k++)
+        {
+            float s = (float)k / (float)(samples - 1);
+            float feet[HEX_LEG_COUNT][3];
+
+            for (int i = 0; i < n; i++)
+            {
+                int leg = legs[i];
+                float front_x, front_y, front_z, rear_x, rear_y;
+                calculateTargetPosition(leg, direction, step_length, &front_x, &front_y, &front_z);
+                calculateRearPosition(leg, direction, step_length, &rear_x, &rear_y);
+
+                feet[i][0] = lerp(front_x, rear_x, s);
+                feet[i][1] = lerp(front_y, rear_y, s);
+                feet[i][2] = front_z;
+            }
+            legTorqueAccumulate(report, legs, (const float(*)[3])feet, n);
+        }
+    }
+}
+
+/**
+ * @brief Zaplanuj krok cyklu w budżecie momentu serw (wynik zapamiętany)
+ */
+static float planStepLength(TripodDirection_t direction)
+{
+    static bool cached = false;
+    static TripodDirection_t cached_direction;
+    static float cached_step, cached_result;
+    static LegTorqueConfig_t cached_model;
+    static Metric_t *util_metric = NULL;
+
+    float step = tripod_cfg->step_length;
+    if (leg_torque_config.policy == LEG_TORQUE_OFF)
+    {
+        return step;
+    }
+    if (cached && cached_direction == direction && cached_step == step &&
+        memcmp(&cached_model, &leg_torque_config, sizeof(cached_model)) == 0)
+    {
+        return cached_result;
+    }
+
+    if (util_metric == NULL)
+        util_metric = metricsRegisterGauge("torque_util", "%");
+
+    LegTorqueReport_t report;
+    evaluateStanceTorque(direction, step, &report);
+    metricSet(util_metric, report.utilization * 100.0f);
+
+    float result = step;
+    if (!legTorqueWithinBudget(&report))
+    {
+        printf("⚠️  Krok %.1f cm poza budżetem momentu serw\n", step);
+        legTorquePrint(&report);
+
+        LegTorqueReport_t standing;
+        evaluateStanceTorque(direction, 0.0f, &standing);
 
-    // Oblicz IK i ustaw serwa
-    float q1, q2, q3;
-    if (computeLegIK(leg_number, current_x, current_y, current_z, &q1, &q2, &q3))
+        if (!legTorqueWithinBudget(&standing))
+        {
+            // Przekracza już stanie w miejscu - krótszy krok nic nie da
+            printf("⚠️  Pozycja bazowa poza budżetem - zmień wysokość stania, krok bez zmian\n");
+        }
+        else if (leg_torque_config.policy == LEG_TORQUE_SCALE)
+        {
+            // Bisekcja - moment rośnie z wychyleniem stopy od pozycji bazowej
+            float lo = 0.0f, hi = step;
+            for (int it = 0; it < 8; it++)
+            {
+                float mid = 0.5f * (lo + hi);
+                evaluateStanceTorque(direction, mid, &report);
+                if (legTorqueWithinBudget(&report))
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            result = lo;
+            evaluateStanceTorque(direction, result, &report);
+            metricSet(util_metric, report.utilization * 100.0f);
+            printf("Krok cyklu ograniczony do %.2f cm (wykorzystanie %.0f%%)\n",
+                   result, report.utilization * 100.0f);
+        }
+    }
+
+    cached = true;
+    cached_direction = direction;
+    cached_step = step;
+    cached_result = result;
+    memcpy(&cached_model, &leg_torque_config, sizeof(cached_model));
+    return result;
+}
+
+void tripodPrintTorque(TripodDirection_t direction)
+{
+    LegTorqueReport_t report;
+    evaluateStanceTorque(direction, tripod_cfg->step_length, &report);
+    printf("\n=== TRIPOD: MOMENTY STANCE (krok %.1f cm) ===\n", tripod_cfg->step_length);
+    legTorquePrint(&report);
+    printf("Krok planowany: %.2f cm\n", planStepLength(direction));
+}
+
+/**
+ * @brief Histogram czasu cyklu (rejestracja przy pierwszym cyklu)
+ */
+static Metric_t *cycleMetric(void)
+{
+    static const uint32_t bounds_ms[] = {50, 75, 100, 150, 200, 300, 500};
+    static Metric_t *metric = NULL;
+    static bool registered = false;
+
+    if (!registered)
     {
-        setLegJointsWithOffset(leg_number, q1, q2, q3, pca1, pca2);
+        metric = metricsRegisterHistogram("tripod_cycle_ms", "ms", bounds_ms, sizeof(bounds_ms) / sizeof(bounds_ms[0]));
+        registered = true;
     }
+    return metric;
 }
 
 /**
@@ -345,72 +478,81 @@ bool tripodGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, TripodDirec
                                                                    : (direction == TRIPOD_TURN_LEFT)  ? "OBRÓT LEWO"
                                                                                                       : "OBRÓT PRAWO");
 
-    // DRASTYCZNE ZMNIEJSZENIE PUNKTÓW dla prędkości
-    int fast_points = 30; // Zamiast 120! Wciąż płynnie ale 4x szybciej
-
-    printf("FAST MODE: używam %d punktów zamiast %d/%d\n",
-           fast_points, tripod_config.swing_points, tripod_config.stance_points);
-    printf("I2C1: %s, I2C2: %s\n",
-           (pca1 != NULL) ? "CONNECTED" : "NULL",
-           (pca2 != NULL) ? "CONNECTED" : "NULL");
-
-    // FAZA 1: Grupa A (1,4,5) SWING równocześnie z Grupa B (2,3,6) STANCE
-    printf("\n--- FAZA 1: Grupa A swing + Grupa B stance (FAST) ---\n");
-
-    uint32_t start_time = HAL_GetTick();
-
-    // BEZ DELAY - maksymalna prędkość
-    for (int i = 0; i <= fast_points; i++)
+    // Tory nóg w gait_scratch - inny chód w międzyczasie zwolnił arenę
+    leg_tracks = memScratchGet(&leg_tracks, sizeof(JointTrack_t) * HEX_LEG_COUNT, NULL);
+    if (leg_tracks == NULL)
     {
-        float t = (float)i / (float)fast_points;
-        float smooth_t = cubicInterpolation(t);
-
-        // === GRUPA A - SWING (1,4,5) ===
-        executeSwingPoint(1, direction, t, smooth_t, pca1, pca2);
-        executeSwingPoint(4, direction, t, smooth_t, pca1, pca2);
-        executeSwingPoint(5, direction, t, smooth_t, pca1, pca2);
-
-        // === GRUPA B - STANCE (2,3,6) ===
-        executeStancePoint(2, direction, t, smooth_t, pca1, pca2);
-        executeStancePoint(3, direction, t, smooth_t, pca1, pca2); // TWOJA TESTOWA
-        executeStancePoint(6, direction, t, smooth_t, pca1, pca2);
-
-        // BEZ HAL_Delay() - pure speed!
+        return false;
     }
 
-    uint32_t phase1_time = HAL_GetTick() - start_time;
-    printf("Faza 1 wykonana w %lu ms\n", phase1_time);
-
-    // FAZA 2: Grupa B (2,3,6) SWING równocześnie z Grupa A (1,4,5) STANCE
-    printf("\n--- FAZA 2: Grupa B swing + Grupa A stance (FAST) ---\n");
+    // Krok w budżecie momentu serw (leg_torque.h)
+    cycle_step_length = planStepLength(direction);
+    cycle_direction = direction;
+
+    // Grupy z robot_description.h (domyślnie A = 1,4,5, B = 2,3,6)
+    int group_legs[2][HEX_LEG_COUNT];
+    int group_count[2];
+    group_count[0] = robotGroupLegs(0, group_legs[0]);
+    group_count[1] = robotGroupLegs(1, group_legs[1]);
+
+    // Kadencja: punkty na fazę i okres ramki z konfiguracji (cadence_tune.h) albo
+    // stałe punkty bez pauzy - maksymalna prędkość
+    int points = TRIPOD_FAST_POINTS;
+    uint32_t period_us = 0;
+    if (tripod_paced)
+    {
+        points = (tripod_cfg->swing_points > 0) ? tripod_cfg->swing_points : 1;
+        period_us = tripod_cfg->swing_duration_ms * 1000U / (uint32_t)points;
+    }
 
-    start_time = HAL_GetTick();
+    printf("Kadencja: %d punktów na fazę, ramka co %lu us\n", points, period_us);
+    planInterpolation(points);
+    controlFrameSetPeriod(period_us);
+    printf("I2C1: %s, I2C2: %s\n",
+           (pca1 != NULL) ? "CONNECTED" : "NULL",
+           (pca2 != NULL) ? "CONNECTED" : "NULL");
 
-    // BEZ DELAY - maksymalna prędkość
-    for (int i = 0; i <= fast_points; i++)
+    // FAZA 1: Grupa A swing + Grupa B stance, FAZA 2: odwrotnie
+    uint32_t phase_time[2];
+    for (int phase = 0; phase < 2; phase++)
     {
-        float t = (float)i / (float)fast_points;
-        float smooth_t = cubicInterpolation(t);
+        uint8_t swing_group = (uint8_t)phase;
+        uint8_t stance_group = (uint8_t)(1 - phase);
+        printf("\n--- FAZA %d: Grupa %c swing + Grupa %c stance ---\n",
+               phase + 1, 'A' + swing_group, 'A' + stance_group);
+
+        uint32_t start_time = HAL_GetTick();
+
+        for (int i = 0; i < group_count[swing_group]; i++)
+            footSwingBegin(group_legs[swing_group][i]);
+        beginPhaseTracks(swing_group, points);
+        TRACE_BEGIN(TRACE_EV_PHASE, phase + 1);
+        for (int i = 0; i <= points; i++)
+        {
+            TRACE_BEGIN(TRACE_EV_FRAME, i);
+            controlFrameBegin();
+            float t = (float)i / (float)points;
 
-        // === GRUPA B - SWING (2,3,6) ===
-        executeSwingPoint(2, direction, t, smooth_t, pca1, pca2);
-        executeSwingPoint(3, direction, t, smooth_t, pca1, pca2); // TWOJA TESTOWA
-        executeSwingPoint(6, direction, t, smooth_t, pca1, pca2);
+            // Swing przed stance - przy LEG_ORDER_SWING_FIRST i tak pierwszy na magistrali
+            outputGroup(group_legs[swing_group], group_count[swing_group], true, i, t, pca1, pca2);
+            outputGroup(group_legs[stance_group], group_count[stance_group], false, i, t, pca1, pca2);
 
-        // === GRUPA A - STANCE (1,4,5) ===
-        executeStancePoint(1, direction, t, smooth_t, pca1, pca2);
-        executeStancePoint(4, direction, t, smooth_t, pca1, pca2);
-        executeStancePoint(5, direction, t, smooth_t, pca1, pca2);
+            // Pauza do końca okresu ramki (bez pauzy, gdy ramka nie zdążyła)
+            controlFrameEnd(0);
+            TRACE_END(TRACE_EV_FRAME, i);
+        }
 
-        // BEZ HAL_Delay() - pure speed!
+        TRACE_END(TRACE_EV_PHASE, phase + 1);
+        phase_time[phase] = HAL_GetTick() - start_time;
+        printf("Faza %d wykonana w %lu ms\n", phase + 1, phase_time[phase]);
     }
 
-    uint32_t phase2_time = HAL_GetTick() - start_time;
-    uint32_t total_time = phase1_time + phase2_time;
+    uint32_t total_time = phase_time[0] + phase_time[1];
 
-    printf("Faza 2 wykonana w %lu ms\n", phase2_time);
+    controlFrameSetPeriod(0); // Inne chody odmierzają pauzy same
+    metricObserve(cycleMetric(), total_time);
     printf("✅ CAŁY CYKL: %lu ms (target: %lu ms)\n",
-           total_time, tripod_config.swing_duration_ms + tripod_config.stance_duration_ms);
+           total_time, tripod_cfg->swing_duration_ms + tripod_cfg->stance_duration_ms);
 
     return true;
 }
@@ -424,9 +566,9 @@ bool tripodGaitWalk(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
     printf("\n=== TRIPOD GAIT WALK START - PEŁNY HEXAPOD ===\n");
     printf("Liczba cykli: %d\n", num_cycles);
     printf("Konfiguracja: krok=%.1fcm, podniesienie=%.1fcm, swing/stance=%lums/%lums, punkty=%d/%d\n",
-           tripod_config.step_length, tripod_config.lift_height,
-           tripod_config.swing_duration_ms, tripod_config.stance_duration_ms,
-           tripod_config.swing_points, tripod_config.stance_points);
+           tripod_cfg->step_length, tripod_cfg->lift_height,
+           tripod_cfg->swing_duration_ms, tripod_cfg->stance_duration_ms,
+           tripod_cfg->swing_points, tripod_cfg->stance_points);
     printf("I2C Status: I2C1=%s, I2C2=%s\n",
            (pca1 != NULL) ? "OK" : "NULL",
            (pca2 != NULL) ? "OK" : "NULL");
@@ -442,7 +584,7 @@ bool tripodGaitWalk(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
             return false;
         }
 
-        HAL_Delay(100); // Krótka pauza między cyklami
+        serialCmdWait(100); // Krótka pauza między cyklami - obsługa komend UART
     }
 
     printf("\n✅ TRIPOD GAIT WALK ZAKOŃCZONY\n");
@@ -456,29 +598,48 @@ void setTripodConfig(float step_length, float lift_height,
                      uint32_t swing_duration, uint32_t stance_duration,
                      int swing_points, int stance_points)
 {
+    // Aktywny może być rekordem z flash - zmiany na kopii w RAM
+    if (tripod_cfg != &tripod_config)
+        tripod_config = *tripod_cfg;
+
     tripod_config.step_length = step_length;
     tripod_config.lift_height = lift_height;
     tripod_config.swing_duration_ms = swing_duration;
     tripod_config.stance_duration_ms = stance_duration;
     tripod_config.swing_points = swing_points;
     tripod_config.stance_points = stance_points;
+    tripod_cfg = &tripod_config;
 
     printf("✅ Konfiguracja tripod zaktualizowana: krok=%.1fcm, podniesienie=%.1fcm, swing/stance=%lums/%lums, punkty=%d/%d\n",
            step_length, lift_height, swing_duration, stance_duration, swing_points, stance_points);
 }
 
+bool tripodSetVerbose(bool verbose)
+{
+    bool previous = tripod_verbose;
+    tripod_verbose = verbose;
+    return previous;
+}
+
+bool tripodSetPaced(bool paced)
+{
+    bool previous = tripod_paced;
+    tripod_paced = paced;
+    return previous;
+}
+
 /**
  * @brief Wyświetl aktualną konfigurację
  */
 void printTripodConfig(void)
 {
     printf("\n=== KONFIGURACJA TRIPOD GAIT ===\n");
-    printf("Długość kroku: %.1f cm\n", tripod_config.step_length);
-    printf("Wysokość podniesienia: %.1f cm\n", tripod_config.lift_height);
-    printf("Czas swing: %lu ms\n", tripod_config.swing_duration_ms);
-    printf("Czas stance: %lu ms\n", tripod_config.stance_duration_ms);
-    printf("Punkty swing: %d\n", tripod_config.swing_points);
-    printf("Punkty stance: %d\n", tripod_config.stance_points);
-    printf("Wysokość bazowa: %.1f cm\n", tripod_config.step_height_base);
+    printf("Długość kroku: %.1f cm\n", tripod_cfg->step_length);
+    printf("Wysokość podniesienia: %.1f cm\n", tripod_cfg->lift_height);
+    printf("Czas swing: %lu ms\n", tripod_cfg->swing_duration_ms);
+    printf("Czas stance: %lu ms\n", tripod_cfg->stance_duration_ms);
+    printf("Punkty swing: %d\n", tripod_cfg->swing_points);
+    printf("Punkty stance: %d\n", tripod_cfg->stance_points);
+    printf("Wysokość bazowa: %.1f cm\n", tripod_cfg->step_height_base);
     printf("===============================\n");
 }
\ No newline at end of file
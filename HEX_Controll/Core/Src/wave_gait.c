@@ -1,18 +1,26 @@
 /*
  * wave_gait.c - Wave gait dla hexapoda
  *
- * Koncepcja: 6 nóg chodzących sekwencyjnie z fazą stance shift
- * Sekwencja: 1 → 2 → 3 → 4 → 5 → 6
+ * Koncepcja: N nóg (HEX_LEG_COUNT) chodzących sekwencyjnie z fazą stance shift
+ * Sekwencja: 1 → 2 → ... → N (hexapod: 1 → 2 → 3 → 4 → 5 → 6)
  *
  * SEKWENCJA:
  * 1. Noga X robi SWING (obecna pozycja → pozycja przednia), pozostałe STOJĄ
- * 2. FAZA STANCE: WSZYSTKIE nogi przesuwają się o 1/6 step_length do tyłu
+ * 2. FAZA STANCE: WSZYSTKIE nogi przesuwają się o 1/N step_length do tyłu
  * 3. Powtórz dla kolejnej nogi
  */
 
 #include "wave_gait.h"
 #include <stdio.h>
 #include <math.h>
+#include "trace.h"
+#include "leg_output.h"
+#include "control_frame.h"
+#include "foot_contact.h"
+#include "metrics.h"
+#include "serial_cmd.h"
+#include "robot_description.h"
+#include "mem_arena.h"
 
 // Konfiguracja wave gait
 WaveConfig_t wave_config = {
@@ -23,39 +31,15 @@ WaveConfig_t wave_config = {
     .step_height_base = -24.0f // Bazowa wysokość stania [cm]
 };
 
-// Pozycje bazowe nóg - PRZYBLIŻONE DO CIAŁA (zmniejszona dźwignia)
-static const float base_positions[6][3] = {
-    {15.0f, -12.0f, -24.0f},  // Noga 1 - lewa przednia (było 18.0f, -15.0f)
-    {-15.0f, -12.0f, -24.0f}, // Noga 2 - prawa przednia (było -18.0f, -15.0f)
-    {18.0f, 0.0f, -24.0f},    // Noga 3 - lewa środkowa (było 22.0f, bez zmian Y)
-    {-18.0f, 0.0f, -24.0f},   // Noga 4 - prawa środkowa (było -22.0f, bez zmian Y)
-    {15.0f, 12.0f, -24.0f},   // Noga 5 - lewa tylna (było 18.0f, 15.0f)
-    {-15.0f, 12.0f, -24.0f}   // Noga 6 - prawa tylna (było -18.0f, 15.0f)
-};
-
-// Śledzenie aktualnych pozycji Y każdej nogi
-static float leg_current_y[6];
-static bool positions_initialized = false;
+// Aktywna konfiguracja - RAM lub rekord z config_store (configParamsLoad)
+const WaveConfig_t *wave_cfg = &wave_config;
 
-// Sekwencja wave - nogi chodzą jedna po drugiej
-static const int wave_sequence[6] = {1, 2, 3, 4, 5, 6};
+// Pozycje bazowe nóg - PRZYBLIŻONE DO CIAŁA (zmniejszona dźwignia), kolumny wave w robot_description.h
+#define BASE_X(leg_index) (robot_description.wave_x[leg_index])
+#define BASE_Y(leg_index) (robot_description.wave_y[leg_index])
 
-// Mapowanie kanałów PCA9685 z offsetami biodra
-typedef struct
-{
-    uint8_t base_channel;
-    float hip_offset_deg;
-    bool is_left_side;
-} LegMapping_t;
-
-static const LegMapping_t leg_mapping[6] = {
-    {0, 37.5f, true},   // Noga 1: I2C1, kanały 0-2, offset +37.5°
-    {0, -37.5f, false}, // Noga 2: I2C2, kanały 0-2, offset -37.5°
-    {3, 0.0f, true},    // Noga 3: I2C1, kanały 3-5, bez offsetu
-    {3, 0.0f, false},   // Noga 4: I2C2, kanały 3-5, bez offsetu
-    {6, -37.5f, true},  // Noga 5: I2C1, kanały 6-8, offset -37.5°
-    {6, 37.5f, false}   // Noga 6: I2C2, kanały 6-8, offset +37.5°
-};
+// Śledzenie aktualnych pozycji Y każdej nogi - w arenie chodu (gait_scratch)
+static float *leg_current_y;
 
 /**
  * @brief Interpolacja kubiczna
@@ -78,66 +62,29 @@ static float lerp(float start, float end, float t)
 }
 
 /**
- * @brief Inicjalizacja pozycji nóg
+ * @brief Pozycje nóg z areny chodu - bazowe, gdy chód dopiero ją przejął
+ *
+ * @return false gdy stan nie mieści się w gait_scratch
  */
-static void initializeLegPositions(void)
+static bool initializeLegPositions(void)
 {
-    for (int i = 0; i < 6; i++)
+    bool fresh;
+    leg_current_y = memScratchGet(&leg_current_y, sizeof(float) * HEX_LEG_COUNT, &fresh);
+    if (leg_current_y == NULL)
     {
-        leg_current_y[i] = base_positions[i][1]; // Pozycje bazowe
+        return false;
     }
-    positions_initialized = true;
-    printf("🔧 Wave: Pozycje nóg zainicjalizowane\n");
-}
-
-/**
- * @brief Ustaw kanały serw dla nogi z offsetem biodra
- */
-static void setLegJointsWithOffset(int leg_number, float q1, float q2, float q3,
-                                   PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
-{
-    if (leg_number < 1 || leg_number > 6)
-        return;
-
-    const LegMapping_t *mapping = &leg_mapping[leg_number - 1];
-    PCA9685_Handle_t *pca_to_use = mapping->is_left_side ? pca1 : pca2;
-
-    if (pca_to_use == NULL)
+    if (!fresh)
     {
-        printf("⚠️  PCA dla nogi %d niedostępne\n", leg_number);
-        return;
+        return true; // Stan z poprzednich cykli tego chodu
     }
 
-    // Konwersja z offsetem
-    float hip_deg = (q1 * 180.0f / M_PI) + mapping->hip_offset_deg;
-    float knee_deg = q2 * 180.0f / M_PI;
-    float ankle_deg = q3 * 180.0f / M_PI;
-
-    // USUNIĘTO INWERSJĘ KOLAN - wszystkie nogi mają ten sam kierunek
-
-    // Mapowanie na serwa
-    float servo_hip = 90.0f + hip_deg;
-    float servo_knee = 90.0f + knee_deg;
-    float servo_ankle = 90.0f + ankle_deg;
-
-    // Ograniczenia
-    if (servo_hip < 0.0f)
-        servo_hip = 0.0f;
-    if (servo_hip > 180.0f)
-        servo_hip = 180.0f;
-    if (servo_knee < 0.0f)
-        servo_knee = 0.0f;
-    if (servo_knee > 180.0f)
-        servo_knee = 180.0f;
-    if (servo_ankle < 0.0f)
-        servo_ankle = 0.0f;
-    if (servo_ankle > 180.0f)
-        servo_ankle = 180.0f;
-
-    // Ustaw serwa
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 0, servo_hip);
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 1, servo_knee);
-    PCA9685_SetServoAngle(pca_to_use, mapping->base_channel + 2, servo_ankle);
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        leg_current_y[i] = BASE_Y(i); // Pozycje bazowe
+    }
+    printf("🔧 Wave: Pozycje nóg zainicjalizowane\n");
+    return true;
 }
 
 /**
@@ -149,130 +96,145 @@ static bool executeSwingPhase(int leg_number, WaveDirection_t direction,
     printf("\n--- FAZA SWING: Noga %d ---\n", leg_number);
     printf("SWING: noga %d | POZOSTAŁE: stoją bez ruchu\n", leg_number);
 
-    uint32_t step_delay = wave_config.step_duration_ms / wave_config.step_points;
+    uint32_t step_delay = wave_cfg->step_duration_ms / wave_cfg->step_points;
     if (step_delay == 0)
         step_delay = 1;
 
     int leg_index = leg_number - 1;
 
     // === FAZA SWING ===
-    for (int i = 0; i <= wave_config.step_points; i++)
+    float swing_last_y = leg_current_y[leg_index];
+    footSwingBegin(leg_number);
+    TRACE_BEGIN(TRACE_EV_PHASE, leg_number);
+    for (int i = 0; i <= wave_cfg->step_points; i++)
     {
-        float t = (float)i / (float)wave_config.step_points;
+        TRACE_BEGIN(TRACE_EV_FRAME, i);
+        controlFrameBegin();
+        float t = (float)i / (float)wave_cfg->step_points;
         float smooth_t = cubicInterpolation(t);
 
         // SWING dla jednej nogi
-        float base_x = base_positions[leg_index][0];
-        float base_y = base_positions[leg_index][1];
-        float base_z = base_positions[leg_index][2];
+        float base_x = BASE_X(leg_index);
+        float base_y = BASE_Y(leg_index);
+        float base_z = ROBOT_STANCE_Z;
 
         // Swing: z obecnej pozycji do pozycji przedniej
         float swing_start_y = leg_current_y[leg_index];       // Obecna pozycja
-        float swing_end_y = base_y - wave_config.step_length; // Pozycja przednia
+        float swing_end_y = base_y - wave_cfg->step_length; // Pozycja przednia
 
         float current_x = base_x;
         float current_y = lerp(swing_start_y, swing_end_y, smooth_t);
 
-        // Trajektoria łuku
-        float arc_height = 4.0f * wave_config.lift_height * t * (1.0f - t);
-        float current_z = base_z - arc_height;
+        // Trajektoria łuku - start z wysokości podłoża z poprzedniego przyziemienia
+        float arc_height = 4.0f * wave_cfg->lift_height * t * (1.0f - t);
+        float current_z = lerp(footSwingStartZ(leg_number, base_z), base_z, smooth_t) - arc_height;
+        footSwingUpdate(leg_number, t, &current_z);
 
         // Oblicz IK i ustaw serwa dla swing nogi
-        float q1, q2, q3;
-        if (computeLegIK(leg_number, current_x, current_y, current_z, &q1, &q2, &q3))
-        {
-            setLegJointsWithOffset(leg_number, q1, q2, q3, pca1, pca2);
-        }
-
-        // Zapisz pozycję końcową swing
-        if (i == wave_config.step_points)
-        {
-            leg_current_y[leg_index] = swing_end_y;
-            printf("SWING KONIEC Noga %d: y=%.1f\n", leg_number, swing_end_y);
-        }
-
-        // POZOSTAŁE NOGI: stoją w obecnych pozycjach (bez ruchu)
-        for (int leg = 1; leg <= 6; leg++)
+        legOutputMarkSwing(leg_number);
+        legOutputMoveFoot(leg_number, current_x, current_y, current_z, pca1, pca2, false);
+        swing_last_y = current_y;
+
+        // POZOSTAŁE NOGI: stoją w obecnych pozycjach (bez ruchu), IK jedną partią
+        LegIKBatch_t batch;
+        batch.count = 0;
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
         {
             if (leg == leg_number)
                 continue; // Pomiń swing leg
 
             int other_leg_index = leg - 1;
-            float other_current_x = base_positions[other_leg_index][0];
-            float other_current_y = leg_current_y[other_leg_index]; // Obecna pozycja (bez zmian)
-            float other_current_z = base_positions[other_leg_index][2];
-
-            if (computeLegIK(leg, other_current_x, other_current_y, other_current_z, &q1, &q2, &q3))
-            {
-                setLegJointsWithOffset(leg, q1, q2, q3, pca1, pca2);
-            }
+            batch.leg[batch.count] = (uint8_t)leg;
+            batch.x[batch.count] = BASE_X(other_leg_index);
+            batch.y[batch.count] = leg_current_y[other_leg_index]; // Obecna pozycja (bez zmian)
+            batch.z[batch.count] = footGroundZ(leg, ROBOT_STANCE_Z);
+            batch.count++;
         }
+        legOutputMoveFeet(&batch, pca1, pca2, false);
 
-        HAL_Delay(step_delay);
+        controlFrameEnd(step_delay); // Odczyt IMU mieści się w pauzie
+        TRACE_END(TRACE_EV_FRAME, i);
+
+        // Noga na ziemi - reszta łuku i jego pauz niepotrzebna
+        if (footSwingDown(leg_number))
+        {
+            printf("PRZYZIEMIENIE: swing zakończony po %d/%d punktach\n", i, wave_cfg->step_points);
+            break;
+        }
     }
 
+    TRACE_END(TRACE_EV_PHASE, leg_number);
+
+    // Zapisz pozycję końcową swing (koniec łuku albo przyziemienie)
+    leg_current_y[leg_index] = swing_last_y;
+    printf("SWING KONIEC Noga %d: y=%.1f\n", leg_number, swing_last_y);
+
     return true;
 }
 
 /**
- * @brief FAZA 2: Wykonaj STANCE SHIFT dla wszystkich nóg (1/6 zamiast 1/3)
+ * @brief FAZA 2: Wykonaj STANCE SHIFT dla wszystkich nóg (1/N zamiast 1/(N/2) w bipedal)
  */
 static bool executeStanceShift(WaveDirection_t direction,
                                PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2)
 {
-    printf("\n--- FAZA STANCE: Wszystkie nogi przesuwają się o 1/6 do tyłu ---\n");
+    printf("\n--- FAZA STANCE: Wszystkie nogi przesuwają się o 1/%d do tyłu ---\n", HEX_LEG_COUNT);
 
     int stance_points = 20;                     // Mniej punktów dla stance (szybsze)
     uint32_t stance_delay = 10 / stance_points; // 10ms całkowity czas stance
     if (stance_delay == 0)
         stance_delay = 1;
 
-    // KLUCZOWA RÓŻNICA: 1/6 zamiast 1/3 (bo 6 nóg zamiast 3 par)
-    float stance_shift = wave_config.step_length / 6.0f;
+    // KLUCZOWA RÓŻNICA: 1/N zamiast 1/(N/2) (bo N nóg zamiast N/2 par)
+    float stance_shift = wave_cfg->step_length / (float)HEX_LEG_COUNT;
 
     // Zapisz pozycje startowe stance
-    float stance_start_y[6];
-    for (int i = 0; i < 6; i++)
+    float stance_start_y[HEX_LEG_COUNT];
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
     {
         stance_start_y[i] = leg_current_y[i];
     }
 
     // === FAZA STANCE SHIFT ===
+    TRACE_BEGIN(TRACE_EV_PHASE, 0);
     for (int i = 0; i <= stance_points; i++)
     {
+        TRACE_BEGIN(TRACE_EV_FRAME, i);
+        controlFrameBegin();
         float t = (float)i / (float)stance_points;
         float smooth_t = cubicInterpolation(t);
+        LegIKBatch_t batch;
+        batch.count = 0;
 
-        // WSZYSTKIE NOGI przesuwają się o 1/6 do tyłu
-        for (int leg = 1; leg <= 6; leg++)
+        // WSZYSTKIE NOGI przesuwają się o 1/N do tyłu
+        for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
         {
             int leg_index = leg - 1;
 
-            float current_x = base_positions[leg_index][0];
-            float current_z = base_positions[leg_index][2];
-
-            // Stance shift: z obecnej pozycji o 1/6 do tyłu
+            // Stance shift: z obecnej pozycji o 1/N do tyłu
             float stance_end_y = stance_start_y[leg_index] + stance_shift;
-            float current_y = lerp(stance_start_y[leg_index], stance_end_y, smooth_t);
-
-            float q1, q2, q3;
-            if (computeLegIK(leg, current_x, current_y, current_z, &q1, &q2, &q3))
-            {
-                setLegJointsWithOffset(leg, q1, q2, q3, pca1, pca2);
-            }
+            batch.leg[batch.count] = (uint8_t)leg;
+            batch.x[batch.count] = BASE_X(leg_index);
+            batch.y[batch.count] = lerp(stance_start_y[leg_index], stance_end_y, smooth_t);
+            batch.z[batch.count] = footGroundZ(leg, ROBOT_STANCE_Z);
+            batch.count++;
 
             // Zapisz nową pozycję
             if (i == stance_points)
             {
                 leg_current_y[leg_index] = stance_end_y;
                 if (leg == 1)
-                    printf("STANCE SHIFT: +%.1f do tyłu (1/6)\n", stance_shift);
+                    printf("STANCE SHIFT: +%.1f do tyłu (1/%d)\n", stance_shift, HEX_LEG_COUNT);
             }
         }
+        legOutputMoveFeet(&batch, pca1, pca2, false);
 
-        HAL_Delay(stance_delay);
+        controlFrameEnd(stance_delay); // Odczyt IMU mieści się w pauzie
+        TRACE_END(TRACE_EV_FRAME, i);
     }
 
+    TRACE_END(TRACE_EV_PHASE, 0);
+
     return true;
 }
 
@@ -305,6 +267,23 @@ static bool executeLegStep(int leg_number, WaveDirection_t direction,
     return true;
 }
 
+/**
+ * @brief Histogram czasu cyklu (rejestracja przy pierwszym cyklu)
+ */
+static Metric_t *cycleMetric(void)
+{
+    static const uint32_t bounds_ms[] = {250, 500, 1000, 1500, 2000, 3000, 5000};
+    static Metric_t *metric = NULL;
+    static bool registered = false;
+
+    if (!registered)
+    {
+        metric = metricsRegisterHistogram("wave_cycle_ms", "ms", bounds_ms, sizeof(bounds_ms) / sizeof(bounds_ms[0]));
+        registered = true;
+    }
+    return metric;
+}
+
 /**
  * @brief Wykonaj jeden pełny cykl wave gait
  */
@@ -316,19 +295,19 @@ bool waveGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, WaveDirection
                                                : (direction == WAVE_LEFT)       ? "LEWO"
                                                                                 : "PRAWO");
 
-    // Inicjalizacja pozycji nóg
-    if (!positions_initialized)
+    // Inicjalizacja pozycji nóg (po zmianie chodu - od pozycji bazowych)
+    if (!initializeLegPositions())
     {
-        initializeLegPositions();
+        return false;
     }
 
     uint32_t cycle_start = HAL_GetTick();
 
-    // SEKWENCJA 6 KROKÓW NÓŻEK (każdy krok = swing + stance shift)
-    for (int step = 0; step < 6; step++)
+    // SEKWENCJA N KROKÓW NÓŻEK (każdy krok = swing + stance shift), nogi po kolei
+    for (int step = 0; step < HEX_LEG_COUNT; step++)
     {
-        int leg_number = wave_sequence[step];
-        printf("\n>>> KROK %d/6: Noga %d <<<\n", step + 1, leg_number);
+        int leg_number = step + 1;
+        printf("\n>>> KROK %d/%d: Noga %d <<<\n", step + 1, HEX_LEG_COUNT, leg_number);
 
         bool success = executeLegStep(leg_number, direction, pca1, pca2);
         if (!success)
@@ -342,9 +321,9 @@ bool waveGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, WaveDirection
 
     // Sprawdź pozycje końcowe
     printf("\n=== SPRAWDZENIE POZYCJI KOŃCOWYCH ===\n");
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
     {
-        float expected_y = base_positions[i][1];
+        float expected_y = BASE_Y(i);
         float actual_y = leg_current_y[i];
         float diff = fabsf(actual_y - expected_y);
 
@@ -353,6 +332,7 @@ bool waveGaitCycle(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2, WaveDirection
     }
 
     uint32_t total_time = HAL_GetTick() - cycle_start;
+    metricObserve(cycleMetric(), total_time);
     printf("\n✅ WAVE GAIT CYCLE ZAKOŃCZONY w %lu ms\n", total_time);
 
     return true;
@@ -378,7 +358,7 @@ bool waveGaitWalk(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
             return false;
         }
 
-        HAL_Delay(20); // Krótka pauza między cyklami
+        serialCmdWait(20); // Krótka pauza między cyklami - obsługa komend UART
     }
 
     printf("\n✅ WAVE GAIT WALK ZAKOŃCZONY\n");
@@ -391,10 +371,15 @@ bool waveGaitWalk(PCA9685_Handle_t *pca1, PCA9685_Handle_t *pca2,
 void setWaveConfig(float step_length, float lift_height,
                    uint32_t step_duration, int step_points)
 {
+    // Aktywny może być rekordem z flash - zmiany na kopii w RAM
+    if (wave_cfg != &wave_config)
+        wave_config = *wave_cfg;
+
     wave_config.step_length = step_length;
     wave_config.lift_height = lift_height;
     wave_config.step_duration_ms = step_duration;
     wave_config.step_points = step_points;
+    wave_cfg = &wave_config;
 
     printf("✅ Konfiguracja wave zaktualizowana: krok=%.1fcm, podniesienie=%.1fcm, czas=%lums, punkty=%d\n",
            step_length, lift_height, step_duration, step_points);
@@ -406,13 +391,13 @@ void setWaveConfig(float step_length, float lift_height,
 void printWaveConfig(void)
 {
     printf("\n=== KONFIGURACJA WAVE GAIT ===\n");
-    printf("Długość kroku: %.1f cm\n", wave_config.step_length);
-    printf("Wysokość podniesienia: %.1f cm\n", wave_config.lift_height);
-    printf("Czas swing: %lu ms\n", wave_config.step_duration_ms);
-    printf("Punkty interpolacji: %d\n", wave_config.step_points);
-    printf("Wysokość bazowa: %.1f cm\n", wave_config.step_height_base);
-    printf("ALGORYTM: WAVE (sekwencyjny swing + stance shift o 1/6)\n");
-    printf("SEKWENCJA: 1→2→3→4→5→6 (jedna noga na raz)\n");
-    printf("STABILNOŚĆ: Najwyższa (zawsze 5 nóg na ziemi)\n");
+    printf("Długość kroku: %.1f cm\n", wave_cfg->step_length);
+    printf("Wysokość podniesienia: %.1f cm\n", wave_cfg->lift_height);
+    printf("Czas swing: %lu ms\n", wave_cfg->step_duration_ms);
+    printf("Punkty interpolacji: %d\n", wave_cfg->step_points);
+    printf("Wysokość bazowa: %.1f cm\n", wave_cfg->step_height_base);
+    printf("ALGORYTM: WAVE (sekwencyjny swing + stance shift o 1/%d)\n", HEX_LEG_COUNT);
+    printf("SEKWENCJA: 1→...→%d (jedna noga na raz)\n", HEX_LEG_COUNT);
+    printf("STABILNOŚĆ: Najwyższa (zawsze %d nóg na ziemi)\n", HEX_LEG_COUNT - 1);
     printf("===============================\n");
 }
\ No newline at end of file
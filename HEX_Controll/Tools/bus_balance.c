@@ -0,0 +1,259 @@
+/*
+ * bus_balance.c - Okablowanie nóg minimalizujące najwolniejszą magistralę w fazach chodu (narzędzie hosta)
+ *
+ * Dla okablowania z leg_config_default (kolumny device/channel w
+ * ROBOT_LEG_TABLE) wypisuje obciążenie magistral w każdej fazie tripodu,
+ * bipedal i wave (bus_load.h). Potem przegląda wszystkie przypisania nóg
+ * do kontrolerów i kolejności kanałów (nogi na kontrolerze od kanału 0,
+ * co 3 - luka rozbija serię na dwie transakcje) i wybiera to z najmniejszą
+ * sumą najgorszych flush wybranych chodów (najwolniejsza ramka każdego
+ * chodu); remis - mniejsza suma po fazach, potem najmniej przełożonych nóg.
+ *
+ * Użycie:
+ *   make -C Tools bus_balance
+ *   ./Tools/bus_balance [-d kontrolery] [-b mag_kontrolera_0,mag_1,...] [-g tripod|bipedal|wave|all]
+ *
+ * Przykład: trzy kontrolery, 0 i 2 na I2C1, 1 na I2C2, tylko tripod:
+ *   ./Tools/bus_balance -d 3 -b 0,1,0 -g tripod
+ */
+
+#include "bus_load.h"
+#include "leg_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LEGS_PER_DEVICE (16 / 3) // Nogi na jednym PCA9685 (kanały 0..14)
+
+static uint8_t device_bus[LEG_CONFIG_MAX_DEVICES];
+static int device_count;
+static bool gait_enabled[BUS_LOAD_GAITS];
+
+static LegConfig_t best;
+static uint32_t best_worst = UINT32_MAX;
+static uint32_t best_sum = UINT32_MAX;
+static int best_moves = HEX_LEG_COUNT + 1;
+static unsigned long evaluated;
+
+static void score(const LegConfig_t *config, uint32_t *worst, uint32_t *sum)
+{
+    BusLoadResult_t result;
+    *worst = 0;
+    *sum = 0;
+    for (int g = 0; g < BUS_LOAD_GAITS; g++)
+    {
+        if (!gait_enabled[g])
+            continue;
+        busLoadAnalyse(config, device_bus, (BusLoadGait_t)g, &result);
+        *worst += result.worst_flush_us;
+        *sum += result.sum_flush_us;
+    }
+}
+
+static int moves(const LegConfig_t *config)
+{
+    int n = 0;
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        const LegMapping_t *a = &config->legs[i];
+        const LegMapping_t *b = &leg_config_default.legs[i];
+        n += (a->device != b->device || a->base_channel != b->base_channel);
+    }
+    return n;
+}
+
+static void evaluate(const int perm[HEX_LEG_COUNT], const int sizes[LEG_CONFIG_MAX_DEVICES])
+{
+    LegConfig_t candidate = leg_config_default;
+    int pos = 0;
+    for (int d = 0; d < device_count; d++)
+    {
+        for (int slot = 0; slot < sizes[d]; slot++)
+        {
+            LegMapping_t *m = &candidate.legs[perm[pos++] - 1];
+            m->device = (uint8_t)d;
+            m->base_channel = (uint8_t)(3 * slot);
+        }
+    }
+
+    uint32_t worst, sum;
+    score(&candidate, &worst, &sum);
+    int moved = moves(&candidate);
+    evaluated++;
+
+    if (worst < best_worst || (worst == best_worst && (sum < best_sum || (sum == best_sum && moved < best_moves))))
+    {
+        best = candidate;
+        best_worst = worst;
+        best_sum = sum;
+        best_moves = moved;
+    }
+}
+
+// Wszystkie podziały kolejności nóg na kontrolery (po najwyżej LEGS_PER_DEVICE)
+static void splitDevices(const int perm[HEX_LEG_COUNT], int sizes[LEG_CONFIG_MAX_DEVICES], int device, int left)
+{
+    if (device == device_count - 1)
+    {
+        if (left <= LEGS_PER_DEVICE)
+        {
+            sizes[device] = left;
+            evaluate(perm, sizes);
+        }
+        return;
+    }
+    for (int n = 0; n <= left && n <= LEGS_PER_DEVICE; n++)
+    {
+        sizes[device] = n;
+        splitDevices(perm, sizes, device + 1, left - n);
+    }
+}
+
+static bool nextPermutation(int *a, int n)
+{
+    int i = n - 2;
+    while (i >= 0 && a[i] >= a[i + 1])
+        i--;
+    if (i < 0)
+        return false;
+    int j = n - 1;
+    while (a[j] <= a[i])
+        j--;
+    int t = a[i];
+    a[i] = a[j];
+    a[j] = t;
+    for (int l = i + 1, r = n - 1; l < r; l++, r--)
+    {
+        t = a[l];
+        a[l] = a[r];
+        a[r] = t;
+    }
+    return true;
+}
+
+static void printWiring(const char *title, const LegConfig_t *config)
+{
+    BusLoadResult_t result;
+    uint32_t worst, sum;
+    score(config, &worst, &sum);
+
+    printf("\n=== %s: najgorsze flush chodów razem %u us, suma faz %u us ===\n", title, worst, sum);
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        const LegMapping_t *m = &config->legs[leg - 1];
+        printf("noga %d: PCA %u kanały %2u-%2u, magistrala %u\n", leg, m->device, m->base_channel,
+               m->base_channel + 2, device_bus[m->device]);
+    }
+    for (int g = 0; g < BUS_LOAD_GAITS; g++)
+    {
+        if (!gait_enabled[g])
+            continue;
+        busLoadAnalyse(config, device_bus, (BusLoadGait_t)g, &result);
+        busLoadPrint(&result);
+    }
+}
+
+static bool parseBuses(const char *text)
+{
+    int d = 0;
+    const char *p = text;
+    while (*p != '\0' && d < LEG_CONFIG_MAX_DEVICES)
+    {
+        char *end;
+        long bus = strtol(p, &end, 10);
+        if (end == p || bus < 0 || bus >= BUS_LOAD_MAX_BUSES)
+            return false;
+        device_bus[d++] = (uint8_t)bus;
+        p = (*end == ',') ? end + 1 : end;
+        if (*end != ',' && *end != '\0')
+            return false;
+    }
+    return d == device_count;
+}
+
+int main(int argc, char **argv)
+{
+    const char *buses = NULL;
+    int opt;
+
+    // Domyślnie: kontrolery z ROBOT_LEG_TABLE, każdy na własnej magistrali
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+    {
+        if (leg_config_default.legs[i].device + 1 > device_count)
+            device_count = leg_config_default.legs[i].device + 1;
+    }
+    for (int g = 0; g < BUS_LOAD_GAITS; g++)
+        gait_enabled[g] = true;
+
+    while ((opt = getopt(argc, argv, "d:b:g:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            device_count = atoi(optarg);
+            break;
+        case 'b':
+            buses = optarg;
+            break;
+        case 'g':
+            for (int g = 0; g < BUS_LOAD_GAITS; g++)
+                gait_enabled[g] = strcmp(optarg, "all") == 0 || strcmp(optarg, bus_load_gait_names[g]) == 0;
+            break;
+        default:
+            fprintf(stderr, "Użycie: %s [-d kontrolery] [-b mag_0,mag_1,...] [-g tripod|bipedal|wave|all]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (device_count < 1 || device_count > LEG_CONFIG_MAX_DEVICES ||
+        device_count * LEGS_PER_DEVICE < HEX_LEG_COUNT)
+    {
+        fprintf(stderr, "Kontrolery: 1..%d, razem co najmniej %d nóg\n", LEG_CONFIG_MAX_DEVICES, HEX_LEG_COUNT);
+        return 1;
+    }
+    for (int d = 0; d < device_count; d++)
+        device_bus[d] = (uint8_t)d;
+    if (buses != NULL && !parseBuses(buses))
+    {
+        fprintf(stderr, "-b: %d magistral (0..%d) po przecinku\n", device_count, BUS_LOAD_MAX_BUSES - 1);
+        return 1;
+    }
+    if (HEX_LEG_COUNT > 9)
+    {
+        fprintf(stderr, "%d nóg - przegląd permutacji za duży\n", HEX_LEG_COUNT);
+        return 1;
+    }
+
+    printf("Model: I2C %u kHz, obsługa transakcji %u us; 3 kanały = %u us\n",
+           BUS_LOAD_SCL_HZ / 1000U, BUS_LOAD_TX_OVERHEAD_US, busLoadTransactionUs(3));
+
+    bool fits = true;
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+        fits = fits && leg_config_default.legs[i].device < device_count;
+    if (fits)
+        printWiring("OBECNE (ROBOT_LEG_TABLE)", &leg_config_default);
+
+    int perm[HEX_LEG_COUNT];
+    int sizes[LEG_CONFIG_MAX_DEVICES];
+    for (int i = 0; i < HEX_LEG_COUNT; i++)
+        perm[i] = i + 1;
+    do
+    {
+        splitDevices(perm, sizes, 0, HEX_LEG_COUNT);
+    } while (nextPermutation(perm, HEX_LEG_COUNT));
+
+    printf("\nSprawdzono %lu okablowań\n", evaluated);
+    printWiring("NAJLEPSZE", &best);
+
+    printf("\nROBOT_LEG_TABLE (device, channel) albo 'bus wire <noga> <PCA> <kanał>' w firmware:\n");
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        const LegMapping_t *m = &best.legs[leg - 1];
+        const LegMapping_t *was = &leg_config_default.legs[leg - 1];
+        printf("  noga %d: %u, %2u%s\n", leg, m->device, m->base_channel,
+               (m->device != was->device || m->base_channel != was->base_channel) ? "  (zmiana)" : "");
+    }
+    return 0;
+}
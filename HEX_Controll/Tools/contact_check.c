@@ -0,0 +1,198 @@
+/*
+ * contact_check.c - Test przyziemienia stóp na symulowanym podłożu (narzędzie hosta)
+ *
+ * Swing jednej nogi jak w wave_gait.c (łuk lift_height, smoothstep,
+ * start z footSwingStartZ(), footSwingUpdate() w każdej ramce, koniec
+ * fazy po footSwingDown()) ze źródłem FOOT_CONTACT_SOURCE_SIM.
+ * Sprawdza:
+ *
+ * - podłoże wyżej niż base_z (footContactSimSetGround()) - przyziemienie
+ *   przed końcem łuku, ground_z = wysokość podłoża (±jedna ramka),
+ *   stopa po kontakcie nie schodzi niżej,
+ * - stance po przyziemieniu - footGroundZ() i start kolejnego swingu
+ *   na zmierzonej wysokości, pozostałe nogi dalej na base_z,
+ * - podłoże niżej niż base_z albo footContactSimClear() - swing do końca,
+ *   przyziemienie nieudane, stance wraca do base_z,
+ * - FOOT_CONTACT_SOURCE_NONE - zachowanie bez czujników.
+ *
+ * Kod wyjścia 0 = wszystkie przypadki poprawne.
+ *
+ * Użycie:
+ *   make -C Tools contact_check   (albo make -C Tools check)
+ *   ./Tools/contact_check [-p punkty] [-h uniesienie_cm]
+ */
+
+#include "foot_contact.h"
+#include "robot_description.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+
+#define SWING_LEG 3
+#define BASE_Z ROBOT_STANCE_Z
+
+static int points = 20;         // step_points wave_config
+static float lift_height = 4.0f;
+static int failures;
+
+typedef struct
+{
+    int frames;      // Ramki do końca fazy
+    float contact_z; // Największe z wysłane po kontakcie (łuk opada w stronę rosnącego z)
+    bool down;       // footSwingDown() po fazie
+} SwingRun_t;
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("   ❌ %s\n", what);
+        failures++;
+    }
+}
+
+static float smoothstep(float t)
+{
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Faza swing jak w wave_gait.c - przerwana po przyziemieniu
+static SwingRun_t runSwing(int leg)
+{
+    SwingRun_t run = {0, 0.0f, false};
+    bool contact = false;
+
+    footSwingBegin(leg);
+    float start_z = footSwingStartZ(leg, BASE_Z);
+    for (int i = 0; i <= points; i++)
+    {
+        float t = (float)i / (float)points;
+        float z = start_z + (BASE_Z - start_z) * smoothstep(t) - 4.0f * lift_height * t * (1.0f - t);
+        if (footSwingUpdate(leg, t, &z))
+        {
+            if (!contact || z > run.contact_z)
+                run.contact_z = z;
+            contact = true;
+        }
+        run.frames = i;
+        if (footSwingDown(leg))
+            break;
+    }
+    run.down = footSwingDown(leg);
+    return run;
+}
+
+static void checkRaisedGround(float ground)
+{
+    float frame_dz = 4.0f * lift_height / (float)points; // Największa zmiana z między ramkami (z zapasem)
+    FootState_t s;
+
+    footContactSetSource(FOOT_CONTACT_SOURCE_SIM, NULL);
+    footContactSimClear();
+    footContactSimSetGround(SWING_LEG, ground);
+
+    for (int step = 1; step <= 2; step++)
+    {
+        SwingRun_t run = runSwing(SWING_LEG);
+        footContactGetState(SWING_LEG, &s);
+        printf("podłoże %.1f cm, krok %d: przyziemienie %s po %d/%d ramkach (t=%.2f), ground_z %.2f cm, stance %.2f cm\n",
+               ground, step, run.down ? "tak" : "NIE", run.frames, points, s.touchdown_t, s.ground_z,
+               footGroundZ(SWING_LEG, BASE_Z));
+
+        expect(run.down && s.touched_down, "brak przyziemienia na podłożu wyżej niż base_z");
+        expect(run.frames < points && s.touchdown_t < 1.0f, "przyziemienie nie skróciło swingu");
+        expect(s.early_touchdowns == (uint32_t)step, "licznik wcześniejszych przyziemień");
+        expect(s.ground_valid && fabsf(s.ground_z - ground) <= frame_dz, "ground_z daleko od podłoża");
+        expect(run.contact_z <= s.ground_z, "stopa zeszła poniżej punktu kontaktu");
+
+        // Stance i kolejny swing na zmierzonej wysokości, inne nogi na base_z
+        expect(footGroundZ(SWING_LEG, BASE_Z) == s.ground_z, "stance nie na wysokości przyziemienia");
+        expect(footGroundZ(SWING_LEG + 1, BASE_Z) == BASE_Z, "stance innej nogi poza base_z");
+        footSwingBegin(SWING_LEG);
+        expect(footSwingStartZ(SWING_LEG, BASE_Z) == s.ground_z, "kolejny swing nie startuje z podłoża");
+        // footSwingBegin() tylko do sprawdzenia startu - runSwing() zacznie swing od nowa
+    }
+}
+
+static void checkNoContact(const char *name, bool clear)
+{
+    FootState_t s;
+
+    footContactSetSource(FOOT_CONTACT_SOURCE_SIM, NULL);
+    footContactSimClear();
+    footContactSimSetGround(SWING_LEG, BASE_Z - 2.0f); // Wyżej - najpierw przyziemienie
+    runSwing(SWING_LEG);
+    if (clear)
+        footContactSimClear();
+    else
+        footContactSimSetGround(SWING_LEG, BASE_Z + 2.0f); // Niżej niż koniec łuku
+
+    SwingRun_t run = runSwing(SWING_LEG);
+    footContactGetState(SWING_LEG, &s);
+    printf("%s: przyziemienie %s po %d/%d ramkach, bez kontaktu %lu, stance %.2f cm\n", name,
+           run.down ? "TAK" : "nie", run.frames, points, (unsigned long)s.missed_touchdowns,
+           footGroundZ(SWING_LEG, BASE_Z));
+
+    expect(!run.down && run.frames == points, "swing bez podłoża nie doszedł do końca łuku");
+    expect(s.missed_touchdowns == 1, "licznik swingów bez kontaktu");
+    expect(!s.ground_valid && footGroundZ(SWING_LEG, BASE_Z) == BASE_Z, "stance bez kontaktu poza base_z");
+}
+
+static void checkNoSource(void)
+{
+    footContactSetSource(FOOT_CONTACT_SOURCE_NONE, NULL);
+    footContactSimSetGround(SWING_LEG, BASE_Z - 2.0f);
+
+    SwingRun_t run = runSwing(SWING_LEG);
+    printf("bez czujników: przyziemienie %s po %d/%d ramkach, stance %.2f cm\n",
+           run.down ? "TAK" : "nie", run.frames, points, footGroundZ(SWING_LEG, BASE_Z));
+    expect(!run.down && run.frames == points, "bez czujników swing skrócony");
+    expect(footGroundZ(SWING_LEG, BASE_Z) == BASE_Z, "bez czujników stance poza base_z");
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "p:h:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            points = atoi(optarg);
+            break;
+        case 'h':
+            lift_height = strtof(optarg, NULL);
+            break;
+        default:
+            fprintf(stderr, "Użycie: %s [-p punkty] [-h uniesienie_cm]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (points < 4 || lift_height <= 1.0f)
+    {
+        fprintf(stderr, "Nieprawidłowe parametry\n");
+        return 1;
+    }
+
+    printf("Swing nogi %d: %d punktów, uniesienie %.1f cm, base_z %.1f cm, debounce %u ramek\n",
+           SWING_LEG, points, lift_height, BASE_Z, foot_contact_config.debounce_frames);
+
+    // Łuk schodzi od base_z - lift_height z powrotem do base_z: podłoże wyżej = mniejsze z.
+    // Kontakt widać ramkę później i potwierdza się po debounce_frames - podłoże tuż nad
+    // base_z daje przyziemienie dopiero w t = 1, więc przypadki z wyraźnie wyższym podłożem
+    checkRaisedGround(BASE_Z - lift_height * 0.6f);
+    checkRaisedGround(BASE_Z - lift_height * 0.75f);
+    checkNoContact("podłoże niżej", false);
+    checkNoContact("footContactSimClear", true);
+    checkNoSource();
+
+    if (failures > 0)
+    {
+        printf("BŁĘDY: %d\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * estop_check.c - Test zatrzasku stopu awaryjnego na zaślepce HAL (narzędzie hosta)
+ *
+ * pca9685.c i servo_estop.c z Tools/hal_stub zamiast HAL - zapisy I2C są
+ * tylko liczone, rejestry I2C to pola w RAM. Sprawdza:
+ *
+ * - przed wyzwoleniem zapisy kanałów przechodzą,
+ * - servoEstopTrigger() wysyła ALL_LED_OFF na oba kontrolery i zatrzaskuje
+ *   blokadę,
+ * - po wyzwoleniu każdy zapis kanału - SetPWM, SetPWMMulti, SetPWMMultiIT,
+ *   SetServoAngle (setAllto90(), test_positions), TestPWMRange,
+ *   SetChannelOff - zwraca false bez transakcji I2C,
+ * - servoEstopRelease() znowu przepuszcza zapisy,
+ * - servoEstopInit() włącza licznik DWT,
+ * - magistrala zajęta na stałe przy stojącym CYCCNT - wyzwolenie kończy
+ *   się błędem zamiast wisieć w ISR.
+ *
+ * Kod wyjścia 0 = wszystkie przypadki poprawne.
+ *
+ * Użycie:
+ *   make -C Tools estop_check   (albo make -C Tools check)
+ */
+
+#include "servo_estop.h"
+#include "servo_bus.h"
+
+#include <stdio.h>
+
+static I2C_HandleTypeDef hi2c1 = {.Instance = I2C1};
+static I2C_HandleTypeDef hi2c2 = {.Instance = I2C2};
+static PCA9685_Handle_t pca1, pca2;
+static int failures;
+
+// servo_bus pusty - servo_estop bierze pca1/pca2 z servoEstopInit()
+uint8_t servoBusDeviceCount(void)
+{
+    return 0;
+}
+
+PCA9685_Handle_t *servoBusDevice(uint8_t device)
+{
+    (void)device;
+    return NULL;
+}
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("   ❌ %s\n", what);
+        failures++;
+    }
+}
+
+// Kontroler odpowiada od razu: zapis SR1 (kasowanie błędów) ustawia SB/ADDR/TXE/BTF
+static void busIdle(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        hal_stub_i2c[i].SR1 = 0;
+        hal_stub_i2c[i].SR2 = 0;
+        hal_stub_i2c[i].DR = 0;
+    }
+}
+
+// Każdy zapis kanału, jaki robi firmware; zwraca liczbę zaakceptowanych
+static int writeAll(void)
+{
+    static uint8_t tx[4 * 3];
+    const uint16_t pwm[3] = {SERVO_PWM_MID, SERVO_PWM_MID, SERVO_PWM_MID};
+    int accepted = 0;
+
+    accepted += PCA9685_SetPWM(&pca1, 0, SERVO_PWM_MID);
+    accepted += PCA9685_SetPWMMulti(&pca2, 3, pwm, 3);
+    accepted += PCA9685_SetPWMMultiIT(&pca1, 6, pwm, 3, tx);
+    accepted += PCA9685_SetServoAngle(&pca2, 9, 90.0f);
+    accepted += PCA9685_TestPWMRange(&pca1, 12, SERVO_PWM_MIN, SERVO_PWM_MAX);
+    accepted += PCA9685_SetChannelOff(&pca2, 15);
+    return accepted;
+}
+
+// SDA trzymane nisko: BUSY nie schodzi, licznik cykli stoi - limit w przebiegach pętli
+static void checkStuckBus(void)
+{
+    ServoEstopStats_t stats;
+
+    hal_stub_dwt.CTRL = 0;
+    hal_stub_i2c[0].SR2 = I2C_SR2_BUSY;
+    hal_stub_i2c[1].SR2 = I2C_SR2_BUSY;
+    servoEstopTrigger();
+    servoEstopGetStats(&stats);
+    printf("magistrala zajęta, CYCCNT stoi: ALL_LED_OFF %s/%s, nieudane %lu\n",
+           stats.device_ok[0] ? "OK" : "błąd", stats.device_ok[1] ? "OK" : "błąd",
+           (unsigned long)stats.failures);
+    expect(!stats.device_ok[0] && !stats.device_ok[1] && stats.failures == 1, "wyzwolenie przy zajętej magistrali udane");
+    expect(servoEstopActive(), "zatrzask nieaktywny po nieudanym wyzwoleniu");
+    servoEstopRelease();
+    busIdle();
+}
+
+int main(void)
+{
+    PCA9685_Init(&pca1, &hi2c1, PCA9685_ADDRESS_1);
+    PCA9685_Init(&pca2, &hi2c2, PCA9685_ADDRESS_2);
+    busIdle();
+    servoEstopInit(&pca1, &pca2);
+    expect((hal_stub_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0, "servoEstopInit() nie włącza DWT");
+
+    uint32_t before = hal_stub_i2c_writes;
+    int accepted = writeAll();
+    printf("przed wyzwoleniem: %d/6 zapisów, %lu transakcji I2C\n", accepted,
+           (unsigned long)(hal_stub_i2c_writes - before));
+    expect(accepted == 6 && !servoEstopActive(), "zapisy przed wyzwoleniem odrzucone");
+
+    servoEstopTrigger();
+    ServoEstopStats_t stats;
+    servoEstopGetStats(&stats);
+    printf("wyzwolenie: %u kontrolery, ALL_LED_OFF %s/%s, zatrzask %s\n", stats.devices,
+           stats.device_ok[0] ? "OK" : "BŁĄD", stats.device_ok[1] ? "OK" : "BŁĄD",
+           servoEstopActive() ? "aktywny" : "NIEAKTYWNY");
+    expect(stats.devices == 2 && stats.device_ok[0] && stats.device_ok[1], "ALL_LED_OFF nieudane");
+    expect(I2C1->DR == PCA9685_LED_FULL && I2C2->DR == PCA9685_LED_FULL, "ostatni bajt to nie full off");
+    expect(servoEstopActive() && PCA9685_OutputsLocked(), "zatrzask nieaktywny po wyzwoleniu");
+
+    before = hal_stub_i2c_writes;
+    accepted = writeAll();
+    printf("po wyzwoleniu: %d/6 zapisów, %lu transakcji I2C\n", accepted,
+           (unsigned long)(hal_stub_i2c_writes - before));
+    expect(accepted == 0, "zapis po servoEstopTrigger() przyjęty");
+    expect(hal_stub_i2c_writes == before, "transakcja I2C po servoEstopTrigger()");
+
+    servoEstopRelease();
+    before = hal_stub_i2c_writes;
+    accepted = writeAll();
+    printf("po servoEstopRelease(): %d/6 zapisów, %lu transakcji I2C\n", accepted,
+           (unsigned long)(hal_stub_i2c_writes - before));
+    expect(accepted == 6 && !servoEstopActive(), "zapisy po zwolnieniu odrzucone");
+
+    checkStuckBus();
+
+    if (failures > 0)
+    {
+        printf("BŁĘDY: %d\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * hal_stub.c - Definicje zaślepki HAL dla testów hosta
+ */
+
+#include "stm32f4xx_hal.h"
+
+I2C_TypeDef hal_stub_i2c[2];
+GPIO_TypeDef hal_stub_gpio[3];
+DWT_Type hal_stub_dwt;
+CoreDebug_Type hal_stub_core_debug;
+uint32_t SystemCoreClock = 180000000U;
+uint32_t hal_stub_i2c_writes;
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t addr, uint32_t trials, uint32_t timeout)
+{
+    (void)hi2c;
+    (void)addr;
+    (void)trials;
+    (void)timeout;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t reg, uint16_t reg_size,
+                                    uint8_t *data, uint16_t size, uint32_t timeout)
+{
+    (void)hi2c;
+    (void)addr;
+    (void)reg;
+    (void)reg_size;
+    (void)data;
+    (void)size;
+    (void)timeout;
+    hal_stub_i2c_writes++;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t reg, uint16_t reg_size,
+                                       uint8_t *data, uint16_t size)
+{
+    return HAL_I2C_Mem_Write(hi2c, addr, reg, reg_size, data, size, 0);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init)
+{
+    (void)port;
+    (void)init;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+    if (state == GPIO_PIN_SET)
+        port->ODR |= pin;
+    else
+        port->ODR &= ~(uint32_t)pin;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub)
+{
+    (void)irq;
+    (void)preempt;
+    (void)sub;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type irq)
+{
+    (void)irq;
+}
+
+void HAL_Delay(uint32_t ms)
+{
+    (void)ms;
+}
+
+uint32_t HAL_GetTick(void)
+{
+    return 0;
+}
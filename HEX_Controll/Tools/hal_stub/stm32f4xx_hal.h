@@ -0,0 +1,156 @@
+/*
+ * stm32f4xx_hal.h - Minimalna zaślepka HAL dla testów hosta (Tools/)
+ *
+ * Tylko to, czego używają pca9685.c, servo_estop.c i dwt_timer.h.
+ * Rejestry I2C/DWT to zwykłe pola w RAM (hal_stub.c) - test ustawia
+ * flagi SR1/SR2 sam, licznik cykli stoi, dopóki test go nie zmieni.
+ * Zapisy przez HAL_I2C_Mem_Write*() są tylko liczone.
+ */
+
+#ifndef STM32F4XX_HAL_STUB_H
+#define STM32F4XX_HAL_STUB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef enum
+{
+    HAL_OK = 0,
+    HAL_ERROR,
+    HAL_BUSY,
+    HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+    HAL_UNLOCKED = 0,
+    HAL_LOCKED
+} HAL_LockTypeDef;
+
+#define __HAL_UNLOCK(h) ((h)->Lock = HAL_UNLOCKED)
+
+// --- I2C ---
+typedef struct
+{
+    volatile uint32_t CR1;
+    volatile uint32_t CR2;
+    volatile uint32_t DR;
+    volatile uint32_t SR1;
+    volatile uint32_t SR2;
+} I2C_TypeDef;
+
+#define I2C_CR1_START 0x0100U
+#define I2C_CR1_STOP 0x0200U
+#define I2C_CR1_POS 0x0800U
+#define I2C_CR2_ITERREN 0x0100U
+#define I2C_CR2_ITEVTEN 0x0200U
+#define I2C_CR2_ITBUFEN 0x0400U
+#define I2C_SR1_SB 0x0001U
+#define I2C_SR1_ADDR 0x0002U
+#define I2C_SR1_BTF 0x0004U
+#define I2C_SR1_TXE 0x0080U
+#define I2C_SR1_BERR 0x0100U
+#define I2C_SR1_ARLO 0x0200U
+#define I2C_SR1_AF 0x0400U
+#define I2C_SR2_BUSY 0x0002U
+
+#define HAL_I2C_STATE_READY 0x20U
+#define HAL_I2C_MODE_NONE 0x00U
+#define HAL_I2C_ERROR_NONE 0x00U
+
+typedef struct
+{
+    I2C_TypeDef *Instance;
+    volatile uint32_t State;
+    volatile uint32_t Mode;
+    volatile uint32_t ErrorCode;
+    volatile uint16_t XferCount;
+    HAL_LockTypeDef Lock;
+} I2C_HandleTypeDef;
+
+extern I2C_TypeDef hal_stub_i2c[2];
+#define I2C1 (&hal_stub_i2c[0])
+#define I2C2 (&hal_stub_i2c[1])
+
+extern uint32_t hal_stub_i2c_writes; // Udane HAL_I2C_Mem_Write*() od startu
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t addr, uint32_t trials, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t reg, uint16_t reg_size,
+                                    uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t addr, uint16_t reg, uint16_t reg_size,
+                                       uint8_t *data, uint16_t size);
+
+// --- GPIO / EXTI / NVIC ---
+typedef struct
+{
+    volatile uint32_t ODR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Pull;
+    uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+extern GPIO_TypeDef hal_stub_gpio[3];
+#define GPIOB (&hal_stub_gpio[1])
+#define GPIOC (&hal_stub_gpio[2])
+
+#define GPIO_PIN_5 0x0020U
+#define GPIO_PIN_13 0x2000U
+#define GPIO_MODE_OUTPUT_PP 0x01U
+#define GPIO_MODE_IT_FALLING 0x10210000U
+#define GPIO_NOPULL 0x00U
+#define GPIO_SPEED_FREQ_HIGH 0x02U
+
+#define __HAL_RCC_GPIOB_CLK_ENABLE() ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE() ((void)0)
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+typedef enum
+{
+    EXTI15_10_IRQn = 40
+} IRQn_Type;
+
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub);
+void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+// --- Czas ---
+extern uint32_t SystemCoreClock;
+
+void HAL_Delay(uint32_t ms);
+uint32_t HAL_GetTick(void);
+
+typedef struct
+{
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk 0x1U
+#define CoreDebug_DEMCR_TRCENA_Msk (1U << 24)
+
+extern DWT_Type hal_stub_dwt;
+extern CoreDebug_Type hal_stub_core_debug;
+#define DWT (&hal_stub_dwt)
+#define CoreDebug (&hal_stub_core_debug)
+
+#endif // STM32F4XX_HAL_STUB_H
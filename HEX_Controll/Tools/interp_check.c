@@ -0,0 +1,148 @@
+/*
+ * interp_check.c - Błąd i koszt interpolacji stawów względem pełnego IK (narzędzie hosta)
+ *
+ * Dla każdej nogi bierze nominalny tor tripodu do przodu (swing: łuk,
+ * stance: po ziemi, smoothstep jak w tripod_gait.c) i dla stride 1..max
+ * wypisuje największy błąd pozycji stopy z FK interpolowanych kątów,
+ * liczbę IK na fazę oraz czas na punkt w porównaniu z IK w każdym punkcie.
+ * Na końcu stride wybrany przez jointInterpPlanStride().
+ *
+ * Użycie:
+ *   make -C Tools interp_check
+ *   ./Tools/interp_check [-p punkty] [-s max_stride] [-e błąd_cm] [-l krok_cm] [-h uniesienie_cm]
+ */
+
+#include "joint_interp.h"
+#include "hexapod_kinematics.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPEAT 2000
+
+static float step_length = 4.0f;
+static float lift_height = 4.0f;
+
+static float smoothstep(float t)
+{
+    return t * t * (3.0f - 2.0f * t);
+}
+
+// Do przodu: przód toru = y - krok, tył = y + krok
+static void swingPath(int leg, float t, float foot[3])
+{
+    float bx = robot_description.stance_x[leg - 1];
+    float by = robot_description.stance_y[leg - 1];
+    float s = smoothstep(t);
+    foot[0] = bx;
+    foot[1] = (by + step_length) + ((by - step_length) - (by + step_length)) * s;
+    foot[2] = ROBOT_STANCE_Z - 4.0f * lift_height * t * (1.0f - t);
+}
+
+static void stancePath(int leg, float t, float foot[3])
+{
+    float bx = robot_description.stance_x[leg - 1];
+    float by = robot_description.stance_y[leg - 1];
+    float s = smoothstep(t);
+    foot[0] = bx;
+    foot[1] = (by - step_length) + ((by + step_length) - (by - step_length)) * s;
+    foot[2] = ROBOT_STANCE_Z;
+}
+
+static double secondsNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Czas na punkt [ns]: tor + IK w każdym punkcie (stride 1) albo tor + próbka Hermite'a
+static double timePerPoint(int leg, JointPathFn path, uint16_t points, uint8_t stride)
+{
+    volatile float sink = 0.0f;
+    double start = secondsNow();
+
+    for (int r = 0; r < REPEAT; r++)
+    {
+        JointTrack_t track;
+        jointTrackBegin(&track, leg, path, points, stride);
+        for (uint16_t i = 0; i <= points; i++)
+        {
+            float foot[3], q[3];
+            path(leg, (float)i / (float)points, foot);
+            if (stride == 1)
+                computeLegIK(leg, foot[0], foot[1], foot[2], &q[0], &q[1], &q[2]);
+            else
+                jointTrackSample(&track, i, q);
+            sink += q[0];
+        }
+    }
+    (void)sink;
+    return (secondsNow() - start) * 1e9 / ((double)REPEAT * (points + 1));
+}
+
+static void checkPhase(const char *name, JointPathFn path, uint16_t points)
+{
+    printf("\n=== %s (%u punktów, granica %.3f cm) ===\n", name, points, joint_interp_config.max_error_cm);
+    printf("noga stride   IK/faza   błąd[cm]   ns/punkt   zysk\n");
+
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        double full = timePerPoint(leg, path, points, 1);
+        for (uint8_t stride = 1; stride <= joint_interp_config.stride; stride++)
+        {
+            float err = jointTrackMaxError(leg, path, points, stride);
+            double t = (stride == 1) ? full : timePerPoint(leg, path, points, stride);
+            printf("%4d %6u %9u %10.4f %10.1f %5.1fx%s\n",
+                   leg, stride, (points + stride - 1) / stride + 1, err, t, full / t,
+                   err <= joint_interp_config.max_error_cm ? "" : "  (poza granicą)");
+        }
+
+        float err;
+        uint8_t chosen = jointInterpPlanStride(leg, path, points, &err);
+        printf("     -> wybrany stride %u (błąd %.4f cm)\n", chosen, err);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int points = 30; // fast_points w tripodGaitCycle()
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:s:e:l:h:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            points = atoi(optarg);
+            break;
+        case 's':
+            joint_interp_config.stride = (uint8_t)atoi(optarg);
+            break;
+        case 'e':
+            joint_interp_config.max_error_cm = strtof(optarg, NULL);
+            break;
+        case 'l':
+            step_length = strtof(optarg, NULL);
+            break;
+        case 'h':
+            lift_height = strtof(optarg, NULL);
+            break;
+        default:
+            fprintf(stderr, "Użycie: %s [-p punkty] [-s max_stride] [-e błąd_cm] [-l krok_cm] [-h uniesienie_cm]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (points < 1 || points > 1000 || joint_interp_config.stride < 1)
+    {
+        fprintf(stderr, "Nieprawidłowe parametry\n");
+        return 1;
+    }
+
+    checkPhase("SWING", swingPath, (uint16_t)points);
+    checkPhase("STANCE", stancePath, (uint16_t)points);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * leveling_check.c - Test poziomowania korpusu na symulowanym IMU (narzędzie hosta)
+ *
+ * Zamknięta pętla bez sprzętu: podłoże pochylone o zadany kąt, korpus
+ * przechylony o (podłoże - korekta), imuSimSetTilt() + imuSimRead()
+ * widzą ten przechył, bodyLevelingUpdate() co body_leveling_config.period_ms
+ * liczy nową korektę. Sprawdza dla kilku nachyleń (oba znaki, roll i pitch):
+ *
+ * - korekta zbiega do nachylenia podłoża, korpus do poziomu (±TOL_DEG),
+ * - znak korekty = znak nachylenia,
+ * - bodyLevelingApply() podnosi stopy po stronie uniesionej (lewa x > 0,
+ *   tył y > 0), więc korpus opada do poziomu,
+ * - nachylenie poza max_tilt_deg - korekta obcięta do granicy.
+ *
+ * Kod wyjścia 0 = wszystkie przypadki poprawne.
+ *
+ * Użycie:
+ *   make -C Tools leveling_check   (albo make -C Tools check)
+ *   ./Tools/leveling_check [-t czas_s] [-n szum_g]
+ */
+
+#include "body_leveling.h"
+#include "imu.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+
+#define TOL_DEG 0.2f
+
+static float settle_s = 5.0f;
+static float noise_g = 0.0f;
+static int failures;
+
+static void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        printf("   ❌ %s\n", what);
+        failures++;
+    }
+}
+
+// Pętla zamknięta przez symulowany czujnik, zwraca stan po settle_s
+static void runLoop(float ground_roll, float ground_pitch, BodyLevelingState_t *state)
+{
+    float dt = (float)body_leveling_config.period_ms / 1000.0f;
+    int steps = (int)(settle_s / dt);
+
+    bodyLevelingEnable(true);
+    imuSimSetNoise(noise_g, 0.0f);
+    bodyLevelingGetState(state);
+    for (int i = 0; i < steps; i++)
+    {
+        imuSimSetTilt(ground_roll - state->corr_roll_deg, ground_pitch - state->corr_pitch_deg);
+        ImuSample_t sample;
+        imuSimRead(&sample, dt);
+        bodyLevelingUpdate(&sample, dt);
+        bodyLevelingGetState(state);
+    }
+}
+
+static void checkConvergence(float ground_roll, float ground_pitch)
+{
+    BodyLevelingState_t s;
+    runLoop(ground_roll, ground_pitch, &s);
+
+    float body_roll = ground_roll - s.corr_roll_deg;
+    float body_pitch = ground_pitch - s.corr_pitch_deg;
+    printf("podłoże %+5.1f / %+5.1f°: korekta %+6.2f / %+6.2f°, korpus %+6.3f / %+6.3f°\n",
+           ground_roll, ground_pitch, s.corr_roll_deg, s.corr_pitch_deg, body_roll, body_pitch);
+
+    expect(fabsf(body_roll) <= TOL_DEG, "przechył korpusu nie zbiegł do poziomu");
+    expect(fabsf(body_pitch) <= TOL_DEG, "pochylenie korpusu nie zbiegło do poziomu");
+    expect(ground_roll == 0.0f || (s.corr_roll_deg > 0.0f) == (ground_roll > 0.0f), "zły znak korekty przechyłu");
+    expect(ground_pitch == 0.0f || (s.corr_pitch_deg > 0.0f) == (ground_pitch > 0.0f), "zły znak korekty pochylenia");
+
+    // Stopa po stronie uniesionej idzie w górę (z rośnie), po przeciwnej w dół
+    float x = 18.0f, y = 15.0f, z = -24.0f; // Lewa tylna
+    bodyLevelingApply(&x, &y, &z);
+    if (ground_roll != 0.0f && ground_pitch == 0.0f)
+        expect((z > -24.0f) == (ground_roll > 0.0f), "bodyLevelingApply: zły kierunek dla przechyłu");
+    if (ground_pitch != 0.0f && ground_roll == 0.0f)
+        expect((z > -24.0f) == (ground_pitch > 0.0f), "bodyLevelingApply: zły kierunek dla pochylenia");
+}
+
+static void checkSaturation(void)
+{
+    float limit = body_leveling_config.max_tilt_deg;
+    float ground = limit + 4.0f;
+    BodyLevelingState_t s;
+    runLoop(ground, -ground, &s);
+
+    printf("podłoże %+5.1f / %+5.1f°: korekta %+6.2f / %+6.2f° (granica %.1f°)\n",
+           ground, -ground, s.corr_roll_deg, s.corr_pitch_deg, limit);
+    expect(fabsf(s.corr_roll_deg - limit) <= 1e-4f, "korekta przechyłu poza granicą");
+    expect(fabsf(s.corr_pitch_deg + limit) <= 1e-4f, "korekta pochylenia poza granicą");
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "t:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            settle_s = strtof(optarg, NULL);
+            break;
+        case 'n':
+            noise_g = strtof(optarg, NULL);
+            break;
+        default:
+            fprintf(stderr, "Użycie: %s [-t czas_s] [-n szum_g]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("Poziomowanie: %lu ms, kp %.2f, ki %.2f, tau %.2f s, po %.1f s, szum %.3f g\n",
+           (unsigned long)body_leveling_config.period_ms, body_leveling_config.kp, body_leveling_config.ki,
+           body_leveling_config.filter_tau_s, settle_s, noise_g);
+
+    static const float cases[][2] = {{5.0f, 0.0f}, {-5.0f, 0.0f}, {0.0f, 4.0f}, {0.0f, -4.0f}, {3.0f, -6.0f}, {0.0f, 0.0f}};
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        checkConvergence(cases[i][0], cases[i][1]);
+    checkSaturation();
+
+    if (failures > 0)
+    {
+        printf("BŁĘDY: %d\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
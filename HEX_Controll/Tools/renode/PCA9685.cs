@@ -0,0 +1,253 @@
+//
+// PCA9685.cs - Model PCA9685 dla Renode: rejestry, auto-inkrementacja, ślad zapisów kanałów
+//
+// Ładowany w hexapod.resc (`include @Tools/renode/PCA9685.cs`), podpinany
+// w stm32f446_hexapod.repl jako `I2C.PCA9685 @ i2c1 0x40`.
+//
+// Model odwzorowuje to, czego używa pca9685.c: MODE1 (AI, SLEEP),
+// PRESCALE (zapis tylko w SLEEP), LEDn_ON/OFF, ALL_LED_ON/OFF (stop
+// awaryjny) i odczyt rejestrów. Wyjścia PWM nie są generowane - stan
+// kanałów jest w rejestrach i w śladzie.
+//
+// Ślad (TraceFile, wspólny plik dla wszystkich kontrolerów):
+//   #PCA9685 v1
+//   X <us> <instr> <urządzenie> <rejestr> <bajty>        transakcja zapisu
+//   P <us> <instr> <urządzenie> <kanał> <on> <off>       kanał po transakcji
+//   A <us> <instr> <urządzenie> <on> <off>               ALL_LED (wszystkie kanały)
+//   M <us> <instr> <nazwa>                               znacznik (Mark)
+// <us> - czas wirtualny, <instr> - instrukcje wykonane przez rdzeń.
+// Tools/renode_report.py liczy z tego koszty odcinków między znacznikami.
+//
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using Antmicro.Renode.Core;
+using Antmicro.Renode.Logging;
+using Antmicro.Renode.Peripherals.CPU;
+
+namespace Antmicro.Renode.Peripherals.I2C
+{
+    public class PCA9685 : II2CPeripheral
+    {
+        public PCA9685(IMachine machine)
+        {
+            this.machine = machine;
+            registers = new byte[RegisterCount];
+            Reset();
+        }
+
+        public void Reset()
+        {
+            Array.Clear(registers, 0, registers.Length);
+            registers[Mode1] = 0x11;    // SLEEP + ALLCALL po włączeniu zasilania
+            registers[Mode2] = 0x04;    // OUTDRV
+            registers[Prescale] = 0x1E; // 200 Hz
+            pointer = 0;
+            pointerSet = false;
+            written.Clear();
+        }
+
+        public void Write(byte[] data)
+        {
+            foreach(var b in data)
+            {
+                if(!pointerSet)
+                {
+                    // Pierwszy bajt transakcji - wskaźnik rejestru
+                    pointer = b;
+                    pointerSet = true;
+                    firstRegister = b;
+                    continue;
+                }
+                WriteRegister(pointer, b);
+                written.Add(pointer);
+                pointer = NextPointer(pointer);
+            }
+        }
+
+        public byte[] Read(int count = 1)
+        {
+            var result = new byte[count];
+            for(var i = 0; i < count; i++)
+            {
+                result[i] = registers[pointer];
+                pointer = NextPointer(pointer);
+            }
+            return result;
+        }
+
+        public void FinishTransmission()
+        {
+            if(written.Count > 0)
+            {
+                TraceTransaction();
+            }
+            written.Clear();
+            pointerSet = false;
+        }
+
+        /// <summary>
+        /// Znacznik w śladzie (np. początek/koniec chodu z hexapod.robot)
+        /// </summary>
+        public void Mark(string name)
+        {
+            TraceLine(string.Format("M {0} {1}", Stamp(), name.Replace(' ', '_')));
+        }
+
+        /// <summary>
+        /// Stan kanałów w monitorze: `i2c1.pca1 Channels`
+        /// </summary>
+        public string Channels()
+        {
+            var lines = new List<string>();
+            for(var ch = 0; ch < ChannelCount; ch++)
+            {
+                lines.Add(string.Format("ch{0,2}: on {1,4} off {2,4}{3}", ch, ChannelOn(ch), ChannelOff(ch),
+                    (registers[Led0 + 4 * ch + 3] & FullBit) != 0 ? " (full off)" : ""));
+            }
+            return string.Join("\n", lines);
+        }
+
+        public int ChannelOff(int channel)
+        {
+            var reg = Led0 + 4 * channel;
+            return registers[reg + 2] | ((registers[reg + 3] & 0x0F) << 8);
+        }
+
+        public int ChannelOn(int channel)
+        {
+            var reg = Led0 + 4 * channel;
+            return registers[reg] | ((registers[reg + 1] & 0x0F) << 8);
+        }
+
+        /// <summary>
+        /// Plik śladu; ta sama ścieżka dla wszystkich kontrolerów = jeden plik
+        /// </summary>
+        public string TraceFile
+        {
+            get { return traceFile; }
+            set
+            {
+                traceFile = value;
+                lock(writers)
+                {
+                    if(!writers.ContainsKey(value))
+                    {
+                        var writer = new StreamWriter(value, false) { AutoFlush = true };
+                        writer.WriteLine("#PCA9685 v1");
+                        writers[value] = writer;
+                    }
+                }
+            }
+        }
+
+        private void WriteRegister(byte reg, byte value)
+        {
+            if(reg == Prescale && (registers[Mode1] & SleepBit) == 0)
+            {
+                // Jak w układzie: PRESCALE zapisywalny tylko w SLEEP
+                this.Log(LogLevel.Warning, "PRESCALE write 0x{0:X2} ignored outside SLEEP", value);
+                return;
+            }
+
+            registers[reg] = value;
+            if(reg >= AllLedOnL && reg <= AllLedOffH)
+            {
+                // ALL_LED_* odpisuje ten sam bajt do każdego kanału
+                var offset = reg - AllLedOnL;
+                for(var ch = 0; ch < ChannelCount; ch++)
+                {
+                    registers[Led0 + 4 * ch + offset] = value;
+                }
+            }
+        }
+
+        private byte NextPointer(byte reg)
+        {
+            if((registers[Mode1] & AutoIncrementBit) == 0)
+            {
+                return reg;
+            }
+            // LED0..LED15 zawija do MODE1, reszta idzie po kolei
+            return (byte)(reg == LastLedRegister ? 0 : reg + 1);
+        }
+
+        private void TraceTransaction()
+        {
+            if(writers.Count == 0 || traceFile == null)
+            {
+                return;
+            }
+
+            var stamp = Stamp();
+            var device = Name();
+            TraceLine(string.Format("X {0} {1} 0x{2:X2} {3}", stamp, device, firstRegister, written.Count));
+
+            if(written.Any(r => r >= AllLedOnL && r <= AllLedOffH))
+            {
+                TraceLine(string.Format("A {0} {1} {2} {3}", stamp, device, ChannelOn(0),
+                    (registers[AllLedOffH] & FullBit) != 0 ? FullOff : ChannelOff(0)));
+                return;
+            }
+
+            foreach(var ch in written.Where(r => r >= Led0 && r <= LastLedRegister)
+                                     .Select(r => (r - Led0) / 4).Distinct().OrderBy(c => c))
+            {
+                var off = (registers[Led0 + 4 * ch + 3] & FullBit) != 0 ? FullOff : ChannelOff(ch);
+                TraceLine(string.Format("P {0} {1} {2} {3} {4}", stamp, device, ch, ChannelOn(ch), off));
+            }
+        }
+
+        private string Stamp()
+        {
+            var cpu = machine.SystemBus.GetCPUs().FirstOrDefault();
+            var instructions = (cpu != null) ? cpu.ExecutedInstructions : 0UL;
+            return string.Format("{0} {1}", machine.LocalTimeSource.ElapsedVirtualTime.TotalMicroseconds, instructions);
+        }
+
+        private string Name()
+        {
+            string name;
+            return machine.TryGetAnyName(this, out name) ? name : "pca9685";
+        }
+
+        private void TraceLine(string line)
+        {
+            StreamWriter writer;
+            lock(writers)
+            {
+                if(traceFile == null || !writers.TryGetValue(traceFile, out writer))
+                {
+                    return;
+                }
+                writer.WriteLine(line);
+            }
+        }
+
+        private readonly IMachine machine;
+        private readonly byte[] registers;
+        private readonly List<byte> written = new List<byte>();
+        private byte pointer;
+        private byte firstRegister;
+        private bool pointerSet;
+        private string traceFile;
+
+        private static readonly Dictionary<string, StreamWriter> writers = new Dictionary<string, StreamWriter>();
+
+        private const int RegisterCount = 256;
+        private const int ChannelCount = 16;
+        private const byte Mode1 = 0x00;
+        private const byte Mode2 = 0x01;
+        private const byte Led0 = 0x06;
+        private const byte LastLedRegister = 0x45;
+        private const byte AllLedOnL = 0xFA;
+        private const byte AllLedOffH = 0xFD;
+        private const byte Prescale = 0xFE;
+        private const byte SleepBit = 0x10;
+        private const byte AutoIncrementBit = 0x20;
+        private const byte FullBit = 0x10;
+        private const int FullOff = 4096; // W śladzie: kanał wyłączony bitem FULL
+    }
+}
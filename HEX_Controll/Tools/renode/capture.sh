@@ -0,0 +1,43 @@
+#!/bin/bash
+#
+# capture.sh - Build z wszystkimi chodami, przebieg w Renode i raport kosztu
+#
+#   Tools/renode/capture.sh                    (z dowolnego katalogu)
+#   Tools/renode/capture.sh stary_trace.txt    (raport z porównaniem buildów)
+#
+# 1. cmake --preset renode (Performance + HEX_WALK_ALL_GAITS) i build,
+# 2. renode-test hexapod.robot z tym ELF i WALKS=3 (tripod, bipedal, wave),
+# 3. Tools/renode_report.py na zebranym śladzie.
+#
+# Wyniki w katalogu HEX_Controll: renode_pca_trace.txt, renode_uart.txt,
+# renode_report.txt.
+
+set -e
+
+cd "$(dirname "$0")/../.."
+
+for tool in cmake arm-none-eabi-gcc renode-test python3; do
+    if ! command -v "$tool" &> /dev/null; then
+        echo "❌ BŁĄD: brak $tool w PATH"
+        exit 1
+    fi
+done
+
+echo "=== Build: preset renode (HEX_WALK_ALL_GAITS=ON) ==="
+cmake --preset renode
+cmake --build --preset renode
+
+ELF="$PWD/build/renode/HEX_Controll.elf"
+TRACE="$PWD/renode_pca_trace.txt"
+rm -f "$TRACE"
+
+echo "=== Renode: tripod, bipedal, wave ==="
+renode-test Tools/renode/hexapod.robot \
+    --variable "ELF:@$ELF" \
+    --variable "TRACE:$TRACE" \
+    --variable "UART_LOG:$PWD/renode_uart.txt" \
+    --variable WALKS:3
+
+echo "=== Raport ==="
+python3 Tools/renode_report.py "$@" "$TRACE" | tee renode_report.txt
+echo "✅ Ślad: $TRACE, raport: $PWD/renode_report.txt"
@@ -0,0 +1,8 @@
+# regfile.py - Rejestry odczytujące ostatni zapis (FLASH_ACR: opóźnienie dostępu)
+
+if request.isInit:
+    regs = {}
+elif request.isWrite:
+    regs[request.offset] = request.value
+elif request.isRead:
+    request.value = regs.get(request.offset, 0)
@@ -0,0 +1,18 @@
+# stm32f4_pwr.py - PWR dla Renode: VOSRDY, ODRDY i ODSWRDY zawsze gotowe
+#
+# HAL_PWREx_EnableOverDrive() (180 MHz) czeka na nie z limitem 1000 ms
+# i bez nich kończy w Error_Handler().
+
+CR = 0x00
+CSR = 0x04
+CSR_READY = (1 << 14) | (1 << 16) | (1 << 17)
+
+if request.isInit:
+    regs = {CR: 0x0000C000, CSR: 0}
+elif request.isWrite:
+    regs[request.offset] = request.value
+elif request.isRead:
+    value = regs.get(request.offset, 0)
+    if request.offset == CSR:
+        value |= CSR_READY
+    request.value = value
@@ -0,0 +1,23 @@
+# stm32f4_rcc.py - RCC dla Renode: flagi gotowości i SWS odpowiadają od razu
+#
+# SystemClock_Config() czeka na HSIRDY/PLLRDY i na SWS == SW; reszta
+# rejestrów (PLLCFGR, CFGR, ENR) pamięta zapis - HAL_RCC_GetSysClockFreq()
+# liczy z nich 180 MHz jak na płytce.
+
+CR = 0x00
+CFGR = 0x08
+
+if request.isInit:
+    regs = {CR: 0x00000083, 0x04: 0x24003010, CFGR: 0x00000000}
+elif request.isWrite:
+    regs[request.offset] = request.value
+elif request.isRead:
+    value = regs.get(request.offset, 0)
+    if request.offset == CR:
+        # xxxRDY = xxxON: HSI(0->1), HSE(16->17), PLL(24->25), PLLI2S(26->27), PLLSAI(28->29)
+        for on in (0, 16, 24, 26, 28):
+            if value & (1 << on):
+                value |= 1 << (on + 1)
+    elif request.offset == CFGR:
+        value = (value & ~0xC) | ((value & 0x3) << 2)
+    request.value = value
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+renode_report.py - Koszt chodów ze śladu PCA9685 z Renode (Tools/renode/)
+
+Wejście: ślad zapisany przez model PCA9685.cs
+    #PCA9685 v1
+    X <us> <instr> <urządzenie> <rejestr> <bajty>
+    P <us> <instr> <urządzenie> <kanał> <on> <off>
+    A <us> <instr> <urządzenie> <on> <off>
+    M <us> <instr> <nazwa>
+Odcinki to pary znaczników <chód>_start / <chód>_end (hexapod.robot),
+kolejne przejścia tego samego chodu są sumowane.
+
+Dla każdego odcinka:
+- instrukcje rdzenia i czas wirtualny,
+- transakcje I2C i bajty na kontroler,
+- aktualizacje kanałów i zapisy bez zmiany wartości (zbędne),
+- instrukcje na transakcję (koszt HAL + sterowania na zapis).
+
+Użycie:
+    python3 Tools/renode_report.py renode_pca_trace.txt
+    python3 Tools/renode_report.py stary.txt nowy.txt      # porównanie buildów
+"""
+
+import argparse
+import sys
+from collections import defaultdict
+
+FULL_OFF = 4096
+
+
+class Segment:
+    def __init__(self):
+        self.passes = 0
+        self.instructions = 0
+        self.us = 0
+        self.transactions = defaultdict(int)
+        self.bytes = defaultdict(int)
+        self.updates = 0
+        self.redundant = 0
+        self.all_off = 0
+
+    def metrics(self):
+        transactions = sum(self.transactions.values())
+        return {
+            "przejścia": self.passes,
+            "instrukcje": self.instructions,
+            "czas [ms]": self.us / 1000.0,
+            "transakcje": transactions,
+            "bajty I2C": sum(self.bytes.values()),
+            "kanały": self.updates,
+            "zbędne": self.redundant,
+            "ALL_OFF": self.all_off,
+            "instr/transakcję": self.instructions / transactions if transactions else 0.0,
+        }
+
+
+def parse(path):
+    """Zwraca słownik nazwa -> Segment (oraz "całość")."""
+    segments = defaultdict(Segment)
+    open_marks = {}  # chód -> (us, instr) znacznika _start
+    channels = {}    # (urządzenie, kanał) -> (on, off)
+    first = last = None
+
+    with open(path, encoding="utf-8") as f:
+        for raw in f:
+            parts = raw.split()
+            if not parts or parts[0].startswith("#"):
+                continue
+            kind, us, instr = parts[0], int(parts[1]), int(parts[2])
+            if first is None:
+                first = (us, instr)
+            last = (us, instr)
+            active = [segments[name] for name in open_marks]
+
+            if kind == "M":
+                name = parts[3]
+                if name.endswith("_start"):
+                    open_marks[name[:-6]] = (us, instr)
+                elif name.endswith("_end") and name[:-4] in open_marks:
+                    start_us, start_instr = open_marks.pop(name[:-4])
+                    seg = segments[name[:-4]]
+                    seg.passes += 1
+                    seg.us += us - start_us
+                    seg.instructions += instr - start_instr
+            elif kind == "X":
+                device, count = parts[3], int(parts[5])
+                for seg in active + [segments["całość"]]:
+                    seg.transactions[device] += 1
+                    seg.bytes[device] += count + 2  # + adres i rejestr
+            elif kind == "P":
+                key = (parts[3], int(parts[4]))
+                value = (int(parts[5]), int(parts[6]))
+                redundant = channels.get(key) == value
+                channels[key] = value
+                for seg in active + [segments["całość"]]:
+                    seg.updates += 1
+                    seg.redundant += redundant
+            elif kind == "A":
+                device = parts[3]
+                for key in [k for k in channels if k[0] == device]:
+                    channels[key] = (int(parts[4]), int(parts[5]))
+                for seg in active + [segments["całość"]]:
+                    seg.all_off += int(parts[5]) == FULL_OFF
+
+    if first is not None:
+        total = segments["całość"]
+        total.passes = 1
+        total.us = last[0] - first[0]
+        total.instructions = last[1] - first[1]
+    return segments
+
+
+def print_report(path, segments):
+    print(f"=== {path} ===")
+    header = list(Segment().metrics().keys())
+    print(f"{'odcinek':<12}" + "".join(f"{h:>18}" for h in header))
+    for name, seg in segments.items():
+        values = seg.metrics()
+        print(f"{name:<12}" + "".join(format_value(values[h]) for h in header))
+        for device in sorted(seg.transactions):
+            print(f"  {device:<10} transakcje {seg.transactions[device]:>8}, bajty {seg.bytes[device]:>8}")
+
+
+def format_value(value):
+    return f"{value:>18.1f}" if isinstance(value, float) else f"{value:>18}"
+
+
+def print_compare(old_path, old, new_path, new):
+    print(f"=== {old_path} -> {new_path} ===")
+    for name in [n for n in old if n in new]:
+        a, b = old[name].metrics(), new[name].metrics()
+        print(f"{name}:")
+        for key in a:
+            change = (b[key] - a[key]) / a[key] * 100.0 if a[key] else 0.0
+            print(f"  {key:<18}{format_value(a[key])}{format_value(b[key])}{change:>+10.1f}%")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Koszt chodów ze śladu PCA9685 z Renode")
+    parser.add_argument("trace", help="ślad (TraceFile w hexapod.resc)")
+    parser.add_argument("other", nargs="?", help="drugi ślad - porównanie")
+    args = parser.parse_args()
+
+    first = parse(args.trace)
+    if not first:
+        print(f"{args.trace}: pusty ślad", file=sys.stderr)
+        return 1
+    if args.other is None:
+        print_report(args.trace, first)
+    else:
+        print_compare(args.trace, first, args.other, parse(args.other))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
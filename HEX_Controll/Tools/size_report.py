@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+size_report.py - Rozmiar obrazu firmware per moduł (plik źródłowy)
+
+Uruchamia `nm -S -l` na pliku ELF i sumuje rozmiary symboli według pliku
+źródłowego, z którego pochodzą (wymaga informacji debug, -g). Symbole bez
+informacji o źródle (libc, libm, startup) trafiają do grupy "(bez -g)".
+
+FLASH = kod + stałe + wartości początkowe .data, RAM = .data + .bss.
+
+Użycie (wywoływane automatycznie po buildzie Performance):
+    python3 Tools/size_report.py build/performance/HEX_Controll.elf
+    python3 Tools/size_report.py --nm arm-none-eabi-nm --top 15 HEX_Controll.elf
+"""
+
+import argparse
+import collections
+import os
+import subprocess
+import sys
+
+FLASH_KB = 256  # Sektory 6/7 zajmuje config_store
+RAM_KB = 128
+
+# Typy symboli nm -> obszar
+TEXT_TYPES = set("tTrRwW")
+DATA_TYPES = set("dDgG")
+BSS_TYPES = set("bBsSvV")
+
+
+def module_of(location):
+    """'/sciezka/Core/Src/plik.c:123' -> 'Core/Src/plik.c' (krótka nazwa modułu)."""
+    if not location:
+        return "(bez -g)"
+    path = location.rsplit(":", 1)[0]
+    parts = path.replace("\\", "/").split("/")
+    for anchor in ("Core", "Drivers"):
+        if anchor in parts:
+            idx = len(parts) - 1 - parts[::-1].index(anchor)
+            short = "/".join(parts[idx:])
+            # Sterowniki HAL skracamy do nazwy pliku
+            return os.path.basename(short) if anchor == "Drivers" else short
+    return os.path.basename(path)
+
+
+def collect(nm, elf):
+    out = subprocess.run([nm, "-S", "-l", "--size-sort", elf],
+                         check=True, capture_output=True, text=True).stdout
+    modules = collections.defaultdict(lambda: {"text": 0, "data": 0, "bss": 0})
+    for line in out.splitlines():
+        head, _, location = line.partition("\t")
+        fields = head.split()
+        if len(fields) < 4:
+            continue
+        size = int(fields[1], 16)
+        sym_type = fields[2]
+        m = modules[module_of(location.strip())]
+        if sym_type in TEXT_TYPES:
+            m["text"] += size
+        elif sym_type in DATA_TYPES:
+            m["data"] += size
+        elif sym_type in BSS_TYPES:
+            m["bss"] += size
+    return modules
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Rozmiar firmware per moduł (nm -S -l)")
+    parser.add_argument("elf", help="plik .elf")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="program nm (domyślnie arm-none-eabi-nm)")
+    parser.add_argument("--top", type=int, default=0, help="pokaż tylko N największych modułów")
+    args = parser.parse_args()
+
+    try:
+        modules = collect(args.nm, args.elf)
+    except (OSError, subprocess.CalledProcessError) as e:
+        print("size_report: nie udało się uruchomić %s: %s" % (args.nm, e), file=sys.stderr)
+        return 1
+
+    rows = sorted(modules.items(), key=lambda kv: kv[1]["text"] + kv[1]["data"], reverse=True)
+    if args.top > 0:
+        rows = rows[:args.top]
+
+    print("%-40s %8s %8s %8s %8s" % ("moduł", "text", "data", "bss", "FLASH"))
+    for name, m in rows:
+        print("%-40s %8d %8d %8d %8d" % (name, m["text"], m["data"], m["bss"], m["text"] + m["data"]))
+
+    flash = sum(m["text"] + m["data"] for m in modules.values())
+    ram = sum(m["data"] + m["bss"] for m in modules.values())
+    print("%-40s %8s %8s %8s %8d" % ("RAZEM (symbole)", "", "", "", flash))
+    print("FLASH %d B (%.1f%% z %d KB), RAM statyczny %d B (%.1f%% z %d KB)"
+          % (flash, 100.0 * flash / (FLASH_KB * 1024), FLASH_KB,
+             ram, 100.0 * ram / (RAM_KB * 1024), RAM_KB))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""
+trace2chrome.py - Konwersja zrzutu traceDump() do formatu Chrome trace (JSON)
+
+Wejście: log z UART zawierający blok
+    #TRACE v1 cpu_hz=180000000 events=N dropped=D
+    #NAME <id> <nazwa>
+    E <cycles> <B|E|I> <id> <arg>
+    #END
+(pozostałe linie logu są pomijane, brany jest ostatni kompletny blok).
+
+Wyjście: JSON do otwarcia w chrome://tracing lub https://ui.perfetto.dev
+- wątek "cpu": frame / phase / ik / mapping / delay (zagnieżdżone),
+- wątki "i2c1" i "i2c2": transakcje PCA9685 na każdej magistrali osobno.
+
+Użycie:
+    python3 Tools/trace2chrome.py log.txt -o walk.json
+    python3 Tools/trace2chrome.py < log.txt > walk.json
+"""
+
+import argparse
+import json
+import sys
+
+CYCCNT_WRAP = 1 << 32
+
+# Wątki w widoku - magistrale I2C osobno, żeby było widać ich zajętość
+TID_CPU = 1
+TID_BY_NAME = {"i2c1": 2, "i2c2": 3}
+
+# Nazwa argumentu w podglądzie zdarzenia
+ARG_NAME = {
+    "frame": "point",
+    "phase": "phase",
+    "ik": "leg",
+    "mapping": "leg",
+    "i2c1": "channel",
+    "i2c2": "channel",
+    "delay": "ms",
+}
+
+
+def parse_dump(lines):
+    """Zwraca (cpu_hz, names, events, dropped) z ostatniego bloku #TRACE..#END."""
+    block = None
+    current = None
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("#TRACE"):
+            current = {"header": line, "names": {}, "events": []}
+        elif current is None:
+            continue
+        elif line.startswith("#NAME"):
+            _, ev_id, name = line.split(maxsplit=2)
+            current["names"][int(ev_id)] = name
+        elif line.startswith("E "):
+            parts = line.split()
+            if len(parts) != 5:
+                continue  # linia przerwana przez inny printf
+            _, cycles, phase, ev_id, arg = parts
+            current["events"].append((int(cycles), phase, int(ev_id), int(arg)))
+        elif line.startswith("#END"):
+            block = current
+            current = None
+
+    if block is None:
+        raise ValueError("brak kompletnego bloku #TRACE ... #END w wejściu")
+
+    fields = dict(f.split("=", 1) for f in block["header"].split()[2:])
+    cpu_hz = int(fields.get("cpu_hz", "180000000"))
+    dropped = int(fields.get("dropped", "0"))
+    return cpu_hz, block["names"], block["events"], dropped
+
+
+def to_chrome(cpu_hz, names, events):
+    """Rozwija przepełnienia CYCCNT i buduje listę zdarzeń Chrome trace."""
+    out = [
+        {"ph": "M", "pid": 1, "name": "process_name", "args": {"name": "hexapod"}},
+        {"ph": "M", "pid": 1, "tid": TID_CPU, "name": "thread_name", "args": {"name": "cpu"}},
+    ]
+    for name, tid in TID_BY_NAME.items():
+        out.append({"ph": "M", "pid": 1, "tid": tid, "name": "thread_name", "args": {"name": name}})
+
+    if not events:
+        return out
+
+    # Zakładamy odstęp między kolejnymi zdarzeniami < 2^32 cykli (~23.8 s @ 180 MHz)
+    t0 = events[0][0]
+    prev = t0
+    wraps = 0
+    us_per_cycle = 1e6 / cpu_hz
+
+    for cycles, phase, ev_id, arg in events:
+        if cycles < prev:
+            wraps += 1
+        prev = cycles
+        ts = (cycles + wraps * CYCCNT_WRAP - t0) * us_per_cycle
+
+        name = names.get(ev_id, "ev%d" % ev_id)
+        ph = {"B": "B", "E": "E", "I": "i"}.get(phase)
+        if ph is None:
+            continue
+        ev = {
+            "name": name,
+            "cat": "bus" if name in TID_BY_NAME else "control",
+            "ph": ph,
+            "ts": round(ts, 3),
+            "pid": 1,
+            "tid": TID_BY_NAME.get(name, TID_CPU),
+        }
+        if ph == "B" or ph == "i":
+            ev["args"] = {ARG_NAME.get(name, "arg"): arg}
+        if ph == "i":
+            ev["s"] = "t"
+        out.append(ev)
+
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="traceDump() -> Chrome trace JSON")
+    parser.add_argument("input", nargs="?", help="log z UART (domyślnie stdin)")
+    parser.add_argument("-o", "--output", help="plik JSON (domyślnie stdout)")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, encoding="utf-8", errors="replace") as f:
+            lines = f.readlines()
+    else:
+        lines = sys.stdin.readlines()
+
+    try:
+        cpu_hz, names, events, dropped = parse_dump(lines)
+    except ValueError as e:
+        print("trace2chrome: %s" % e, file=sys.stderr)
+        return 1
+
+    trace = {"traceEvents": to_chrome(cpu_hz, names, events), "displayTimeUnit": "ms"}
+
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+        sys.stdout.write("\n")
+
+    print("trace2chrome: %d zdarzeń, cpu_hz=%d, utraconych=%d" % (len(events), cpu_hz, dropped),
+          file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,290 @@
+/*
+ * workspace_map.c - Mapa przestrzeni roboczej nóg hexapoda (narzędzie hosta)
+ *
+ * Przemiata siatkę punktów wokół pozycji bazowej każdej nogi i dla każdego
+ * punktu zapisuje:
+ * - wykonalność IK (computeLegIK z firmware, bez zmian),
+ * - kąty serw po mapowaniu z offsetem biodra (jak legOutputSetJoints) i PWM
+ *   po mapowaniu na zakres serwa z leg_config (jak legConfigAngleToPwm, bez
+ *   obcięcia),
+ * - zapas do skalibrowanych limitów PWM serwa (pwm_min/pwm_max stawu w
+ *   leg_config) dla biodra, kolana i kostki - w stopniach obrotu serwa
+ *   (nominalnie LEG_CONFIG_PWM_MIN/MAX_DEFAULT = 0°/180°),
+ * - uwarunkowanie jakobianu (legJacobianCondition).
+ *
+ * Wyjście:
+ * - <out>/leg<N>.csv           - pełna siatka 3D
+ * - <out>/leg<N>_z<Z>_margin.pgm - przekrój: minimalny zapas serwa (jasno = duży)
+ * - <out>/leg<N>_z<Z>_cond.pgm   - przekrój: uwarunkowanie (jasno = dobre)
+ *
+ * Użycie:
+ *   make -C Tools workspace_map
+ *   ./Tools/workspace_map [-o katalog] [-s krok_cm] [-r promień_cm] [-z poziom_cm]...
+ *                         [-p noga:staw:pwm_min:pwm_max]...
+ *
+ * -p podaje limity z kalibracji (servo_calib.h, komenda `calib`) zamiast
+ * wartości domyślnych leg_config_default; staw 0 = biodro, 1 = kolano,
+ * 2 = kostka.
+ */
+
+#include "hexapod_kinematics.h"
+#include "leg_config.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define RAD2DEG (180.0f / (float)M_PI)
+
+#define MAX_Z_SLICES 8
+
+// Nominalna skala serwa: pełny zakres domyślny = 180° obrotu
+#define PWM_PER_DEG ((float)(LEG_CONFIG_PWM_MAX_DEFAULT - LEG_CONFIG_PWM_MIN_DEFAULT) / 180.0f)
+
+// Limity PWM używane przez mapę - leg_config_default albo z -p
+static LegConfig_t map_config;
+
+typedef struct
+{
+    bool ik_ok;            // computeLegIK zwróciło true
+    float servo[3];        // Kąty serw [deg] przed ograniczeniem 0-180
+    float pwm[3];          // PWM przed ograniczeniem do limitów serwa
+    float margin[3];       // Zapas do najbliższego limitu PWM [deg], < 0 = obcięte
+    float min_margin;      // Minimum z trzech
+    float cond;            // Uwarunkowanie jakobianu
+} MapSample_t;
+
+static void evaluatePoint(int leg, float x, float y, float z, MapSample_t *out)
+{
+    float q[3];
+    memset(out, 0, sizeof(*out));
+    out->ik_ok = computeLegIK(leg, x, y, z, &q[0], &q[1], &q[2]);
+    out->min_margin = -180.0f;
+    out->cond = INFINITY;
+
+    if (!out->ik_ok)
+    {
+        return;
+    }
+
+    out->servo[0] = 90.0f + q[0] * RAD2DEG + map_config.legs[leg - 1].hip_offset_deg;
+    out->servo[1] = 90.0f + q[1] * RAD2DEG;
+    out->servo[2] = 90.0f + q[2] * RAD2DEG;
+
+    out->min_margin = 180.0f;
+    for (int j = 0; j < 3; j++)
+    {
+        // Jak legConfigAngleToPwm(): 0° = pwm_min, 180° = pwm_max (serwo może być odwrócone)
+        const ServoPwmLimits_t *lim = &map_config.servo[leg - 1][j];
+        float lo = fminf(lim->pwm_min, lim->pwm_max);
+        float hi = fmaxf(lim->pwm_min, lim->pwm_max);
+        out->pwm[j] = lim->pwm_min + out->servo[j] / 180.0f * ((float)lim->pwm_max - (float)lim->pwm_min);
+        out->margin[j] = fminf(out->pwm[j] - lo, hi - out->pwm[j]) / PWM_PER_DEG;
+        out->min_margin = fminf(out->min_margin, out->margin[j]);
+    }
+
+    out->cond = legJacobianCondition(leg, q[0], q[1], q[2]);
+}
+
+static bool writePGM(const char *path, const unsigned char *pix, int w, int h)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "Nie można zapisać %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    fprintf(f, "P5\n%d %d\n255\n", w, h);
+    fwrite(pix, 1, (size_t)w * (size_t)h, f);
+    fclose(f);
+    return true;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Użycie: %s [-o katalog] [-s krok_cm] [-r promień_cm] [-z poziom_cm]...\n"
+            "  -o  katalog wyjściowy (domyślnie workspace_maps)\n"
+            "  -s  krok siatki [cm] (domyślnie 0.5)\n"
+            "  -r  półszerokość siatki X/Y wokół pozycji bazowej [cm] (domyślnie 12)\n"
+            "  -z  poziom Z przekroju PGM [cm], można powtarzać (domyślnie -24 i -20)\n"
+            "  -p  limity PWM stawu noga:staw:pwm_min:pwm_max (staw 0-2), można powtarzać\n"
+            "      (domyślnie %d-%d dla każdego stawu)\n",
+            prog, LEG_CONFIG_PWM_MIN_DEFAULT, LEG_CONFIG_PWM_MAX_DEFAULT);
+}
+
+// -p noga:staw:pwm_min:pwm_max - limity jak po kalibracji (legConfigValidate())
+static bool parseLimits(const char *arg)
+{
+    int leg, joint;
+    unsigned pwm_min, pwm_max;
+    char end;
+    if (sscanf(arg, "%d:%d:%u:%u%c", &leg, &joint, &pwm_min, &pwm_max, &end) != 4 ||
+        leg < 1 || leg > HEX_LEG_COUNT || joint < 0 || joint > 2)
+    {
+        return false;
+    }
+
+    ServoPwmLimits_t *lim = &map_config.servo[leg - 1][joint];
+    ServoPwmLimits_t old = *lim;
+    lim->pwm_min = (uint16_t)pwm_min;
+    lim->pwm_max = (uint16_t)pwm_max;
+    if (pwm_min > 4095 || pwm_max > 4095 || !legConfigValidate(&map_config))
+    {
+        *lim = old;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_dir = "workspace_maps";
+    float step = 0.5f;
+    float radius = 12.0f;
+    float z_min = -32.0f, z_max = -12.0f;
+    float z_slices[MAX_Z_SLICES];
+    int num_slices = 0;
+
+    map_config = *leg_config;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out_dir = argv[++i];
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            step = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+            radius = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "-z") == 0 && i + 1 < argc && num_slices < MAX_Z_SLICES)
+            z_slices[num_slices++] = strtof(argv[++i], NULL);
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc && parseLimits(argv[i + 1]))
+            i++;
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (step <= 0.0f || radius <= 0.0f)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (num_slices == 0)
+    {
+        z_slices[num_slices++] = -24.0f;
+        z_slices[num_slices++] = -20.0f;
+    }
+
+    if (mkdir(out_dir, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(stderr, "Nie można utworzyć %s: %s\n", out_dir, strerror(errno));
+        return 1;
+    }
+
+    int n_xy = (int)lroundf(2.0f * radius / step) + 1;
+    int n_z = (int)lroundf((z_max - z_min) / step) + 1;
+    unsigned char *pix = malloc((size_t)n_xy * (size_t)n_xy);
+    if (pix == NULL)
+    {
+        return 1;
+    }
+
+    printf("Siatka: %d x %d x %d punktów, krok %.2f cm\n", n_xy, n_xy, n_z, step);
+    printf("Noga | wykonalne | w limitach serw | min zapas w bazie [deg] | cond w bazie | limity PWM biodro/kolano/kostka\n");
+
+    char path[512];
+
+    for (int leg = 1; leg <= HEX_LEG_COUNT; leg++)
+    {
+        // Środek siatki: pozycja bazowa tripod/bipedal z robot_description
+        const float base[3] = {robot_description.stance_x[leg - 1], robot_description.stance_y[leg - 1], ROBOT_STANCE_Z};
+
+        snprintf(path, sizeof(path), "%s/leg%d.csv", out_dir, leg);
+        FILE *csv = fopen(path, "w");
+        if (csv == NULL)
+        {
+            fprintf(stderr, "Nie można zapisać %s: %s\n", path, strerror(errno));
+            free(pix);
+            return 1;
+        }
+        fprintf(csv, "x,y,z,ik_ok,servo_hip,servo_knee,servo_ankle,pwm_hip,pwm_knee,pwm_ankle,"
+                     "margin_hip,margin_knee,margin_ankle,min_margin,cond\n");
+
+        long total = 0, feasible = 0, in_limits = 0;
+        MapSample_t s;
+
+        for (int iz = 0; iz < n_z; iz++)
+        {
+            float z = z_min + iz * step;
+            for (int iy = 0; iy < n_xy; iy++)
+            {
+                float y = base[1] - radius + iy * step;
+                for (int ix = 0; ix < n_xy; ix++)
+                {
+                    float x = base[0] - radius + ix * step;
+                    evaluatePoint(leg, x, y, z, &s);
+
+                    total++;
+                    if (s.ik_ok)
+                        feasible++;
+                    if (s.ik_ok && s.min_margin >= 0.0f)
+                        in_limits++;
+
+                    fprintf(csv, "%.2f,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%.1f,%.1f,%.1f,%.2f,%.2f,%.2f,%.2f,%.3f\n",
+                            x, y, z, s.ik_ok ? 1 : 0,
+                            s.servo[0], s.servo[1], s.servo[2],
+                            s.pwm[0], s.pwm[1], s.pwm[2],
+                            s.margin[0], s.margin[1], s.margin[2],
+                            s.min_margin, isfinite(s.cond) ? s.cond : -1.0f);
+                }
+            }
+        }
+        fclose(csv);
+
+        // Przekroje PGM: wiersze = Y (od -radius), kolumny = X (od -radius)
+        for (int k = 0; k < num_slices; k++)
+        {
+            float z = z_slices[k];
+
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (int iy = 0; iy < n_xy; iy++)
+                {
+                    for (int ix = 0; ix < n_xy; ix++)
+                    {
+                        evaluatePoint(leg, base[0] - radius + ix * step,
+                                      base[1] - radius + iy * step, z, &s);
+                        float v = 0.0f;
+                        if (s.ik_ok && s.min_margin >= 0.0f)
+                        {
+                            // Zapas: 0..90° -> 32..255, uwarunkowanie: 1/cond -> 32..255
+                            v = (pass == 0) ? s.min_margin / 90.0f
+                                            : (isfinite(s.cond) ? 1.0f / s.cond : 0.0f);
+                            v = 32.0f + 223.0f * fminf(1.0f, fmaxf(0.0f, v));
+                        }
+                        pix[iy * n_xy + ix] = (unsigned char)v;
+                    }
+                }
+
+                snprintf(path, sizeof(path), "%s/leg%d_z%+.0f_%s.pgm", out_dir, leg, z,
+                         (pass == 0) ? "margin" : "cond");
+                writePGM(path, pix, n_xy, n_xy);
+            }
+        }
+
+        evaluatePoint(leg, base[0], base[1], base[2], &s);
+        const ServoPwmLimits_t *lim = map_config.servo[leg - 1];
+        printf("  %d  |  %5.1f%%   |     %5.1f%%      |         %6.1f          | %6.2f       | %u-%u / %u-%u / %u-%u\n",
+               leg, 100.0 * feasible / total, 100.0 * in_limits / total,
+               s.min_margin, s.cond, lim[0].pwm_min, lim[0].pwm_max,
+               lim[1].pwm_min, lim[1].pwm_max, lim[2].pwm_min, lim[2].pwm_max);
+    }
+
+    free(pix);
+    printf("Mapy zapisane w %s/\n", out_dir);
+    return 0;
+}
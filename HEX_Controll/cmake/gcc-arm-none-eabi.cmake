@@ -33,6 +33,13 @@ set(CMAKE_C_FLAGS_RELEASE "-Os -g0")
 set(CMAKE_CXX_FLAGS_DEBUG "-O0 -g3")
 set(CMAKE_CXX_FLAGS_RELEASE "-Os -g0")
 
+# Performance: LTO over HAL + application, -Os by default (hot modules get -O3
+# in CMakeLists.txt). -g only feeds the per-module size report, not the flash image.
+set(CMAKE_C_FLAGS_PERFORMANCE "-Os -g -flto")
+set(CMAKE_CXX_FLAGS_PERFORMANCE "-Os -g -flto")
+set(CMAKE_ASM_FLAGS_PERFORMANCE "-g")
+set(CMAKE_EXE_LINKER_FLAGS_PERFORMANCE "-flto=auto")
+
 set(CMAKE_CXX_FLAGS "${CMAKE_C_FLAGS} -fno-rtti -fno-exceptions -fno-threadsafe-statics")
 
 set(CMAKE_C_LINK_FLAGS "${TARGET_FLAGS}")